@@ -0,0 +1,95 @@
+// Compares parsing with tree-sitter allocating from malloc against an arena
+// that is reset after every document.
+//
+//   bench-arena <malloc|arena> <iterations> <file>...
+//
+// Both modes install the arena allocator so that allocations are counted;
+// in malloc mode it only adds a header and forwards to malloc. Run one mode
+// per process, as peak RSS never goes down.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include "../tests/helpers.h"
+#include "tree_sitter/markdoc/arena.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4 || (strcmp(argv[1], "malloc") != 0 && strcmp(argv[1], "arena") != 0)) {
+        fprintf(stderr, "usage: %s <malloc|arena> <iterations> <file>...\n", argv[0]);
+        return 2;
+    }
+    bool use_arena = strcmp(argv[1], "arena") == 0;
+    int iterations = atoi(argv[2]);
+    if (iterations <= 0) {
+        iterations = 1;
+    }
+
+    int file_count = argc - 3;
+    char **sources = calloc((size_t)file_count, sizeof(char *));
+    uint32_t *lengths = calloc((size_t)file_count, sizeof(uint32_t));
+    for (int i = 0; i < file_count; i++) {
+        sources[i] = read_file(argv[i + 3], &lengths[i]);
+        if (sources[i] == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i + 3]);
+            return 1;
+        }
+    }
+
+    markdoc_arena_install();
+    MarkdocArena *arena = use_arena ? markdoc_arena_new(0) : NULL;
+
+    uint64_t bytes = 0;
+    uint64_t nodes = 0;
+    double start = now_seconds();
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        for (int i = 0; i < file_count; i++) {
+            markdoc_arena_activate(arena);
+            TSParser *parser = ts_parser_new();
+            ts_parser_set_language(parser, tree_sitter_markdoc());
+            TSTree *tree = ts_parser_parse_string(parser, NULL, sources[i], lengths[i]);
+            nodes += ts_node_descendant_count(ts_tree_root_node(tree));
+            ts_tree_delete(tree);
+            ts_parser_delete(parser);
+            markdoc_arena_activate(NULL);
+            if (arena != NULL) {
+                markdoc_arena_reset(arena);
+            }
+            bytes += lengths[i];
+        }
+    }
+    double elapsed = now_seconds() - start;
+
+    MarkdocArenaStats heap = markdoc_arena_stats(NULL);
+    MarkdocArenaStats served = arena != NULL ? markdoc_arena_stats(arena) : heap;
+    printf("mode=%s files=%d iterations=%d bytes=%llu nodes=%llu seconds=%.3f MB/s=%.1f "
+           "allocations=%llu frees=%llu heap_allocations=%llu peak_rss_kb=%ld\n",
+           argv[1], file_count, iterations, (unsigned long long)bytes,
+           (unsigned long long)nodes, elapsed, (double)bytes / elapsed / 1e6,
+           (unsigned long long)served.allocations, (unsigned long long)served.frees,
+           (unsigned long long)heap.allocations, peak_rss_kb());
+
+    markdoc_arena_delete(arena);
+    for (int i = 0; i < file_count; i++) {
+        free(sources[i]);
+    }
+    free(sources);
+    free(lengths);
+    return 0;
+}
@@ -0,0 +1,117 @@
+// Compares markdoc_outline(), which only enters block containers, against a
+// cursor walk over every node of the tree that finds the same headings and
+// top-level tags.
+//
+//   bench-outline <iterations> <file>...
+//
+// Each file is parsed once; only the walks are timed. The entry counts
+// differ only when headings sit inside ERROR nodes, which the outline skips.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../tests/helpers.h"
+#include "tree_sitter/markdoc/outline.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Visits every node in pre-order and counts the headings and top-level tags
+// it passes, as an outline built without knowing which nodes to skip would.
+static uint32_t walk_everything(TSNode root, uint64_t *visited) {
+    uint32_t entries = 0;
+    uint32_t depth = 0;
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    for (bool more = true; more;) {
+        TSSymbol symbol = ts_node_symbol(ts_tree_cursor_current_node(&cursor));
+        (*visited)++;
+        entries += symbol == MARKDOC_SYM_HEADING ||
+                   (symbol == MARKDOC_SYM_MARKDOC_TAG && depth == 1);
+        if (ts_tree_cursor_goto_first_child(&cursor)) {
+            depth++;
+            continue;
+        }
+        while (depth > 0 && !ts_tree_cursor_goto_next_sibling(&cursor)) {
+            ts_tree_cursor_goto_parent(&cursor);
+            depth--;
+        }
+        more = depth > 0;
+    }
+    ts_tree_cursor_delete(&cursor);
+    return entries;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <iterations> <file>...\n", argv[0]);
+        return 2;
+    }
+    int iterations = atoi(argv[1]);
+    if (iterations <= 0) {
+        iterations = 1;
+    }
+
+    int file_count = argc - 2;
+    char **sources = calloc((size_t)file_count, sizeof(char *));
+    TSTree **trees = calloc((size_t)file_count, sizeof(TSTree *));
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+    for (int i = 0; i < file_count; i++) {
+        uint32_t length = 0;
+        sources[i] = read_file(argv[i + 2], &length);
+        if (sources[i] == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i + 2]);
+            return 1;
+        }
+        trees[i] = ts_parser_parse_string(parser, NULL, sources[i], length);
+    }
+
+    uint64_t visited = 0, full_entries = 0;
+    double start = now_seconds();
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        for (int i = 0; i < file_count; i++) {
+            full_entries += walk_everything(ts_tree_root_node(trees[i]), &visited);
+        }
+    }
+    double full_seconds = now_seconds() - start;
+
+    uint64_t outline_entries = 0;
+    start = now_seconds();
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        for (int i = 0; i < file_count; i++) {
+            MarkdocOutline outline;
+            if (!markdoc_outline(ts_tree_root_node(trees[i]), sources[i], &outline)) {
+                fprintf(stderr, "out of memory\n");
+                return 1;
+            }
+            outline_entries += outline.count;
+            markdoc_outline_delete(&outline);
+        }
+    }
+    double outline_seconds = now_seconds() - start;
+
+    double walks = (double)iterations * file_count;
+    printf("files=%d iterations=%d entries=%llu/%llu nodes_per_file=%.0f "
+           "full_walk_us=%.2f outline_us=%.2f speedup=%.1fx\n",
+           file_count, iterations, (unsigned long long)outline_entries,
+           (unsigned long long)full_entries, (double)visited / walks,
+           full_seconds / walks * 1e6, outline_seconds / walks * 1e6,
+           full_seconds / outline_seconds);
+
+    for (int i = 0; i < file_count; i++) {
+        ts_tree_delete(trees[i]);
+        free(sources[i]);
+    }
+    free(trees);
+    free(sources);
+    ts_parser_delete(parser);
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Compares parsing files read into heap buffers against markdoc_parse_file().
+//
+//   bench-parse-file <read|mmap> <iterations> <file>...
+//
+// Run one mode per process: peak RSS is reported by getrusage() and never
+// goes down, so the two modes cannot share a process.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include "tree_sitter/markdoc/file.h"
+#include "tree_sitter/tree-sitter-tree-sitter-markdoc.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static TSTree *parse_read(TSParser *parser, const char *path, uint64_t *bytes) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *buffer = malloc((size_t)size + 1);
+    TSTree *tree = NULL;
+    if (buffer != NULL && fread(buffer, 1, (size_t)size, file) == (size_t)size) {
+        tree = ts_parser_parse_string(parser, NULL, buffer, (uint32_t)size);
+        *bytes += (uint64_t)size;
+    }
+    free(buffer);
+    fclose(file);
+    return tree;
+}
+
+static TSTree *parse_mmap(TSParser *parser, const char *path, uint64_t *bytes) {
+    MarkdocMappedFile mapping;
+    TSTree *tree = markdoc_parse_file(parser, NULL, path, &mapping);
+    *bytes += mapping.length;
+    markdoc_unmap_file(&mapping);
+    return tree;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4 || (strcmp(argv[1], "read") != 0 && strcmp(argv[1], "mmap") != 0)) {
+        fprintf(stderr, "usage: %s <read|mmap> <iterations> <file>...\n", argv[0]);
+        return 2;
+    }
+    bool use_mmap = strcmp(argv[1], "mmap") == 0;
+    int iterations = atoi(argv[2]);
+    if (iterations <= 0) {
+        iterations = 1;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+
+    long rss_before = peak_rss_kb();
+    uint64_t bytes = 0;
+    double start = now_seconds();
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        for (int i = 3; i < argc; i++) {
+            TSTree *tree = use_mmap ? parse_mmap(parser, argv[i], &bytes)
+                                    : parse_read(parser, argv[i], &bytes);
+            if (tree == NULL) {
+                fprintf(stderr, "%s: parse failed\n", argv[i]);
+                ts_parser_delete(parser);
+                return 1;
+            }
+            ts_tree_delete(tree);
+        }
+    }
+    double elapsed = now_seconds() - start;
+
+    printf("mode=%s files=%d iterations=%d bytes=%llu seconds=%.3f MB/s=%.1f "
+           "peak_rss_kb=%ld rss_growth_kb=%ld\n",
+           argv[1], argc - 3, iterations, (unsigned long long)bytes, elapsed,
+           (double)bytes / elapsed / 1e6, peak_rss_kb(), peak_rss_kb() - rss_before);
+
+    ts_parser_delete(parser);
+    return 0;
+}
@@ -0,0 +1,123 @@
+// Compares counting headings, tags and code blocks with a recursive
+// ts_node_child() walk that compares type names against markdoc::visit().
+//
+//   bench-visit <iterations> <file>...
+//
+// Files are parsed once up front; only the walks are timed.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tree_sitter/markdoc/markdoc.hpp"
+#include "tree_sitter/tree-sitter-tree-sitter-markdoc.h"
+
+namespace {
+
+struct Counts {
+    uint64_t headings = 0;
+    uint64_t tags = 0;
+    uint64_t code_blocks = 0;
+    uint64_t nodes = 0;
+
+    bool operator==(const Counts &other) const {
+        return headings == other.headings && tags == other.tags &&
+               code_blocks == other.code_blocks;
+    }
+};
+
+void naive_walk(TSNode node, Counts &counts) {
+    const char *type = ts_node_type(node);
+    counts.nodes++;
+    if (std::strcmp(type, "heading") == 0) {
+        counts.headings++;
+    } else if (std::strcmp(type, "markdoc_tag") == 0) {
+        counts.tags++;
+    } else if (std::strcmp(type, "fenced_code_block") == 0) {
+        counts.code_blocks++;
+    }
+    uint32_t child_count = ts_node_child_count(node);
+    for (uint32_t i = 0; i < child_count; i++) {
+        naive_walk(ts_node_child(node, i), counts);
+    }
+}
+
+struct CountHandler {
+    Counts &counts;
+    void operator()(markdoc::Heading, TSNode) { counts.headings++; }
+    void operator()(markdoc::MarkdocTag, TSNode) { counts.tags++; }
+    void operator()(markdoc::FencedCodeBlock, TSNode) { counts.code_blocks++; }
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <iterations> <file>...\n", argv[0]);
+        return 2;
+    }
+    int iterations = std::atoi(argv[1]);
+    if (iterations <= 0) {
+        iterations = 1;
+    }
+
+    markdoc::Parser parser(tree_sitter_markdoc());
+    std::vector<std::string> sources;
+    std::vector<markdoc::Tree> trees;
+    for (int i = 2; i < argc; i++) {
+        std::ifstream file(argv[i], std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "%s: cannot read\n", argv[i]);
+            return 1;
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        sources.push_back(contents.str());
+        trees.push_back(parser.parse(sources.back()));
+    }
+
+    Counts naive;
+    auto start = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        for (const markdoc::Tree &tree : trees) {
+            naive_walk(tree.root(), naive);
+        }
+    }
+    double naive_seconds = seconds_since(start);
+
+    Counts visited;
+    markdoc::Cursor cursor(trees.front().root());
+    start = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        for (const markdoc::Tree &tree : trees) {
+            markdoc::visit<markdoc::Heading, markdoc::MarkdocTag, markdoc::FencedCodeBlock>(
+                cursor, tree.root(), CountHandler{visited});
+        }
+    }
+    double visit_seconds = seconds_since(start);
+
+    if (!(naive == visited)) {
+        std::fprintf(stderr, "walks disagree: naive %llu/%llu/%llu, visit %llu/%llu/%llu\n",
+                     (unsigned long long)naive.headings, (unsigned long long)naive.tags,
+                     (unsigned long long)naive.code_blocks, (unsigned long long)visited.headings,
+                     (unsigned long long)visited.tags, (unsigned long long)visited.code_blocks);
+        return 1;
+    }
+
+    double nodes = static_cast<double>(naive.nodes);
+    std::printf("files=%d iterations=%d nodes=%llu naive_ns_per_node=%.2f "
+                "visit_ns_per_node=%.2f speedup=%.2f\n",
+                argc - 2, iterations, (unsigned long long)naive.nodes,
+                naive_seconds / nodes * 1e9, visit_seconds / nodes * 1e9,
+                naive_seconds / visit_seconds);
+    return 0;
+}
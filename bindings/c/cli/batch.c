@@ -0,0 +1,316 @@
+// markdoc-batch: parses every .mdoc/.md file under the given paths on a pool
+// of worker threads and prints one NDJSON record per file:
+//
+//   {"path":"docs/a.mdoc","bytes":1234,"nodes":210,"errors":0,"parse_us":85}
+//
+//   markdoc-batch [-j THREADS] PATH...
+//
+// Each worker owns a TSParser; the TSLanguage is static and shared. Files are
+// split into one contiguous range per worker, and a worker whose range runs
+// dry steals from the front of another worker's range, so a few large files
+// cannot leave the other threads idle.
+
+#define _XOPEN_SOURCE 700
+
+#include <errno.h>
+#include <ftw.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tree_sitter/markdoc/file.h"
+#include "tree_sitter/tree-sitter-tree-sitter-markdoc.h"
+
+// Upper bound for -j.
+#define MAX_THREADS 1024
+
+typedef struct {
+    char **items;
+    size_t size;
+    size_t capacity;
+} PathList;
+
+// Files still to be parsed by one worker: indices [head, tail) into the path
+// list. The owner takes from the tail and thieves take from the head.
+typedef struct {
+    pthread_mutex_t lock;
+    size_t head;
+    size_t tail;
+} TaskRange;
+
+typedef struct {
+    const PathList *paths;
+    TaskRange *ranges;
+    unsigned worker_count;
+    pthread_mutex_t output_lock;
+    uint64_t total_bytes;
+    size_t failures;
+} Pool;
+
+typedef struct {
+    Pool *pool;
+    unsigned id;
+} Worker;
+
+// nftw() has no user pointer, so the walk collects into this list.
+static PathList walk_paths;
+
+static bool path_list_push(PathList *list, const char *path) {
+    if (list->size == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 256;
+        char **items = realloc(list->items, capacity * sizeof(char *));
+        if (items == NULL) {
+            return false;
+        }
+        list->items = items;
+        list->capacity = capacity;
+    }
+    char *copy = strdup(path);
+    if (copy == NULL) {
+        return false;
+    }
+    list->items[list->size++] = copy;
+    return true;
+}
+
+static bool has_markdoc_extension(const char *path) {
+    const char *dot = strrchr(path, '.');
+    return dot != NULL && (strcmp(dot, ".mdoc") == 0 || strcmp(dot, ".md") == 0);
+}
+
+static int collect_path(const char *path, const struct stat *info, int type, struct FTW *ftw) {
+    (void)info;
+    (void)ftw;
+    if (type == FTW_F && has_markdoc_extension(path) && !path_list_push(&walk_paths, path)) {
+        return -1;
+    }
+    return 0;
+}
+
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void count_nodes(TSNode root, uint64_t *nodes, uint64_t *errors) {
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    for (;;) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        (*nodes)++;
+        if (ts_node_is_error(node) || ts_node_is_missing(node)) {
+            (*errors)++;
+        }
+        if (ts_tree_cursor_goto_first_child(&cursor)) {
+            continue;
+        }
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                ts_tree_cursor_delete(&cursor);
+                return;
+            }
+        }
+    }
+}
+
+static void print_json_string(FILE *out, const char *text) {
+    fputc('"', out);
+    for (const unsigned char *c = (const unsigned char *)text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(out, "\\%c", *c);
+        } else if (*c < 0x20) {
+            fprintf(out, "\\u%04x", *c);
+        } else {
+            fputc(*c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static void report_failure(Pool *pool, const char *path, const char *message) {
+    pthread_mutex_lock(&pool->output_lock);
+    fprintf(stderr, "%s: %s\n", path, message);
+    pool->failures++;
+    pthread_mutex_unlock(&pool->output_lock);
+}
+
+static void parse_one(Pool *pool, TSParser *parser, const char *path) {
+    MarkdocMappedFile mapping;
+    if (!markdoc_map_file(path, &mapping)) {
+        report_failure(pool, path, strerror(errno));
+        return;
+    }
+    // parse_us times the parse alone, not the mapping.
+    uint64_t start = now_us();
+    TSTree *tree = ts_parser_parse_string(parser, NULL, mapping.data, mapping.length);
+    uint64_t elapsed = now_us() - start;
+
+    if (tree == NULL) {
+        markdoc_unmap_file(&mapping);
+        report_failure(pool, path, "parse failed");
+        return;
+    }
+
+    uint64_t nodes = 0;
+    uint64_t errors = 0;
+    count_nodes(ts_tree_root_node(tree), &nodes, &errors);
+    uint32_t bytes = mapping.length;
+    ts_tree_delete(tree);
+    markdoc_unmap_file(&mapping);
+
+    pthread_mutex_lock(&pool->output_lock);
+    fputs("{\"path\":", stdout);
+    print_json_string(stdout, path);
+    printf(",\"bytes\":%u,\"nodes\":%llu,\"errors\":%llu,\"parse_us\":%llu}\n", bytes,
+           (unsigned long long)nodes, (unsigned long long)errors,
+           (unsigned long long)elapsed);
+    pool->total_bytes += bytes;
+    pthread_mutex_unlock(&pool->output_lock);
+}
+
+static bool take_own(TaskRange *range, size_t *task) {
+    pthread_mutex_lock(&range->lock);
+    bool ok = range->head < range->tail;
+    if (ok) {
+        *task = --range->tail;
+    }
+    pthread_mutex_unlock(&range->lock);
+    return ok;
+}
+
+static bool steal(TaskRange *range, size_t *task) {
+    pthread_mutex_lock(&range->lock);
+    bool ok = range->head < range->tail;
+    if (ok) {
+        *task = range->head++;
+    }
+    pthread_mutex_unlock(&range->lock);
+    return ok;
+}
+
+static void *run_worker(void *payload) {
+    Worker *worker = payload;
+    Pool *pool = worker->pool;
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+
+    for (;;) {
+        size_t task;
+        bool found = take_own(&pool->ranges[worker->id], &task);
+        // No task is ever added, so once every range is empty the pool is done.
+        for (unsigned i = 1; !found && i < pool->worker_count; i++) {
+            found = steal(&pool->ranges[(worker->id + i) % pool->worker_count], &task);
+        }
+        if (!found) {
+            break;
+        }
+        parse_one(pool, parser, pool->paths->items[task]);
+    }
+
+    ts_parser_delete(parser);
+    return NULL;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr, "usage: %s [-j THREADS] PATH...\n", program);
+}
+
+int main(int argc, char **argv) {
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int opt;
+    while ((opt = getopt(argc, argv, "j:h")) != -1) {
+        if (opt == 'j') {
+            char *end;
+            errno = 0;
+            threads = strtol(optarg, &end, 10);
+            if (errno != 0 || end == optarg || *end != '\0' || threads < 1 ||
+                threads > MAX_THREADS) {
+                fprintf(stderr, "%s: -j takes a thread count from 1 to %d\n", argv[0],
+                        MAX_THREADS);
+                return 2;
+            }
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (threads < 1) {
+        threads = 1;
+    } else if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+
+    for (int i = optind; i < argc; i++) {
+        if (nftw(argv[i], collect_path, 32, FTW_PHYS) != 0) {
+            fprintf(stderr, "%s: %s\n", argv[i], strerror(errno));
+            return 1;
+        }
+    }
+    qsort(walk_paths.items, walk_paths.size, sizeof(char *), compare_paths);
+
+    if ((size_t)threads > walk_paths.size) {
+        threads = walk_paths.size > 0 ? (long)walk_paths.size : 1;
+    }
+    unsigned worker_count = (unsigned)threads;
+
+    Pool pool = {.paths = &walk_paths, .worker_count = worker_count};
+    pool.ranges = calloc(worker_count, sizeof(TaskRange));
+    Worker *workers = calloc(worker_count, sizeof(Worker));
+    pthread_t *handles = calloc(worker_count, sizeof(pthread_t));
+    if (pool.ranges == NULL || workers == NULL || handles == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    pthread_mutex_init(&pool.output_lock, NULL);
+    for (unsigned i = 0; i < worker_count; i++) {
+        pthread_mutex_init(&pool.ranges[i].lock, NULL);
+        pool.ranges[i].head = walk_paths.size * i / worker_count;
+        pool.ranges[i].tail = walk_paths.size * (i + 1) / worker_count;
+        workers[i] = (Worker){.pool = &pool, .id = i};
+    }
+
+    // The main thread is worker 0. A worker that cannot be started leaves
+    // its range to be stolen by the others, so the files still get parsed.
+    uint64_t start = now_us();
+    unsigned started = 0;
+    for (unsigned i = 1; i < worker_count; i++) {
+        int error = pthread_create(&handles[started], NULL, run_worker, &workers[i]);
+        if (error != 0) {
+            fprintf(stderr, "worker %u: %s\n", i, strerror(error));
+            continue;
+        }
+        started++;
+    }
+    run_worker(&workers[0]);
+    for (unsigned i = 0; i < started; i++) {
+        pthread_join(handles[i], NULL);
+    }
+    double seconds = (double)(now_us() - start) / 1e6;
+
+    fprintf(stderr, "%zu files, %llu bytes, %u threads, %.3f s\n", walk_paths.size,
+            (unsigned long long)pool.total_bytes, started + 1, seconds);
+
+    for (unsigned i = 0; i < worker_count; i++) {
+        pthread_mutex_destroy(&pool.ranges[i].lock);
+    }
+    pthread_mutex_destroy(&pool.output_lock);
+    for (size_t i = 0; i < walk_paths.size; i++) {
+        free(walk_paths.items[i]);
+    }
+    free(walk_paths.items);
+    free(pool.ranges);
+    free(workers);
+    free(handles);
+    return pool.failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""
+Generate bindings/c/tree_sitter/markdoc/symbols.h, the public symbol and
+field IDs, from the tables in src/parser.c, with a hash of the parser and
+external scanner sources.
+
+Run it after every `tree-sitter generate` and every change to the scanner;
+the IDs change whenever the grammar does. With --check, exit with status 1 instead of writing when the
+header is out of date.
+"""
+
+import json
+import re
+import sys
+from pathlib import Path
+
+root = Path(__file__).resolve().parents[2]
+parser_path = root / "src" / "parser.c"
+# Everything that decides the trees the parser builds.
+grammar_paths = [parser_path, root / "src" / "scanner.c", root / "src" / "scanner.h"]
+header_path = root / "bindings" / "c" / "tree_sitter" / "markdoc" / "symbols.h"
+
+CPP_KEYWORDS = {
+    "bool", "break", "case", "catch", "char", "class", "const", "default",
+    "delete", "do", "double", "else", "enum", "false", "float", "for", "if",
+    "int", "long", "new", "null", "nullptr", "operator", "private", "public",
+    "return", "short", "signed", "sizeof", "static", "struct", "switch",
+    "template", "this", "throw", "true", "try", "typedef", "union",
+    "unsigned", "using", "virtual", "void", "while",
+}
+
+
+def table(source, declaration):
+    """Returns the body of the array initializer that follows `declaration`."""
+    start = source.index(declaration)
+    start = source.index("{", start) + 1
+    return source[start:source.index("\n};", start)]
+
+
+def parse_enum(source, name):
+    body = table(source, f"enum {name} {{")
+    return {m[1]: int(m[2]) for m in re.finditer(r"(\w+) = (\d+),", body)}
+
+
+def c_string(literal):
+    return bytes(literal, "utf-8").decode("unicode_escape")
+
+
+source = parser_path.read_text(encoding="utf-8")
+ids = parse_enum(source, "ts_symbol_identifiers")
+ids["ts_builtin_sym_end"] = 0
+names = {
+    m[1]: c_string(m[2])
+    for m in re.finditer(r'\[(\w+)\] = "((?:[^"\\]|\\.)*)",',
+                         table(source, "ts_symbol_names[] ="))
+}
+public = dict(re.findall(r"\[(\w+)\] = (\w+),", table(source, "ts_symbol_map[] =")))
+metadata = {
+    m[1]: (m[2] == "true", m[3] == "true")
+    for m in re.finditer(r"\[(\w+)\] = \{\s*\.visible = (\w+),\s*\.named = (\w+),",
+                         table(source, "ts_symbol_metadata[] ="))
+}
+fields = parse_enum(source, "ts_field_identifiers")
+
+
+def define(name):
+    return int(re.search(rf"#define {name} (\d+)", source)[1])
+
+
+def fnv1a(data, value=0xCBF29CE484222325):
+    for byte in data:
+        value = ((value ^ byte) * 0x100000001B3) & 0xFFFFFFFFFFFFFFFF
+    return value
+
+
+def fingerprint(strings):
+    """FNV-1a over each string and its terminating NUL, as the header does."""
+    value = 0xCBF29CE484222325
+    for string in strings:
+        value = fnv1a(string.encode("utf-8") + b"\0", value)
+    return value
+
+
+# The parse and lex tables are code in parser.c, and the scanner is code too,
+# so hash their sources. Line endings are normalized so that a checkout with
+# CRLF endings gets the same value.
+grammar_hash = 0xCBF29CE484222325
+for path in grammar_paths:
+    grammar_hash = fnv1a(path.read_bytes().replace(b"\r\n", b"\n"), grammar_hash)
+
+
+# Every name ts_language_symbol_name() and ts_language_field_name_for_id()
+# return, in ID order, so any renumbering changes the fingerprint.
+symbol_count = define("SYMBOL_COUNT") + define("ALIAS_COUNT")
+names_by_id = {value: names[ident] for ident, value in ids.items() if ident in names}
+if sorted(names_by_id) != list(range(symbol_count)):
+    sys.exit("generate_symbols.py: ts_symbol_names does not cover every symbol")
+field_names = [n.removeprefix("field_") for n in sorted(fields, key=fields.get)]
+language_fingerprint = fingerprint(
+    [names_by_id[i] for i in range(symbol_count)] + field_names)
+
+
+# ts_node_symbol() only ever returns visible symbols, mapped through
+# ts_symbol_map, so list each of those once.
+symbols = []
+seen = set()
+for ident, value in sorted(ids.items(), key=lambda item: item[1]):
+    visible, named = metadata.get(ident, (False, False))
+    if not visible or public.get(ident, ident) != ident:
+        continue
+    if named:
+        suffix = names[ident]
+        cpp = suffix if suffix not in CPP_KEYWORDS else suffix + "_"
+    else:
+        suffix = re.sub(r"^(anon_sym|alias_sym|sym)_", "", ident)
+        cpp = "anon_" + suffix.lower()
+    constant = ("MARKDOC_SYM_" if named else "MARKDOC_ANON_") + suffix.upper()
+    if constant in seen:
+        sys.exit(f"generate_symbols.py: {constant} would be defined twice")
+    seen.add(constant)
+    symbols.append((constant, cpp, value, names[ident]))
+
+lines = [
+    "// Generated by bindings/c/generate_symbols.py from src/parser.c. Do not edit.",
+    "//",
+    "// Symbol and field IDs for switching on ts_node_symbol() and",
+    "// ts_tree_cursor_current_field_id() instead of comparing type names.",
+    "//",
+    "// The IDs are stable for a given src/parser.c. tree-sitter numbers",
+    "// symbols itself, so `tree-sitter generate` may renumber them, and this",
+    "// header is regenerated in the same commit, as it is with any change to",
+    "// the external scanner. The symbols-header-current test fails until it",
+    "// is. Every entry point of the native API checks markdoc_symbols_match()",
+    "// and refuses a language whose names and IDs differ from the ones below.",
+    "",
+    "#ifndef TREE_SITTER_MARKDOC_SYMBOLS_H_",
+    "#define TREE_SITTER_MARKDOC_SYMBOLS_H_",
+    "",
+    "#include <tree_sitter/api.h>",
+    "",
+    f"#define MARKDOC_SYMBOLS_LANGUAGE_VERSION {define('LANGUAGE_VERSION')}",
+    f"#define MARKDOC_SYMBOLS_SYMBOL_COUNT {define('SYMBOL_COUNT') + define('ALIAS_COUNT')}",
+    f"#define MARKDOC_SYMBOLS_FIELD_COUNT {define('FIELD_COUNT')}",
+    f"#define MARKDOC_SYMBOLS_FINGERPRINT 0x{language_fingerprint:016X}ull",
+    "",
+    "// FNV-1a of src/parser.c, src/scanner.c and src/scanner.h. It changes with",
+    "// the parse and lex tables and with the external scanner, so anything",
+    "// keyed by it, like the parse cache, misses once either changes.",
+    f"#define MARKDOC_SYMBOLS_GRAMMAR_HASH 0x{grammar_hash:016X}ull",
+    "",
+    "enum {",
+]
+for constant, _, value, name in symbols:
+    label = name if constant.startswith("MARKDOC_SYM_") else json.dumps(name)
+    lines.append(f"    {constant} = {value},  // {label}")
+lines += [
+    "    MARKDOC_SYM_ERROR = 65535,",
+    "};",
+    "",
+    "enum {",
+]
+lines += [f"    MARKDOC_FIELD_{name.upper()} = {value}," for name, value in
+          sorted(((n.removeprefix("field_"), v) for n, v in fields.items()),
+                 key=lambda item: item[1])]
+lines += [
+    "};",
+    "",
+    "// Whether `language` has exactly the symbol and field names, at exactly",
+    "// the IDs, of the parser.c this header was generated from. It hashes",
+    "// every name, which costs about as much as a few hundred strcmp() calls.",
+    "static inline bool markdoc_symbols_match(const TSLanguage *language) {",
+    "    if (language == NULL ||",
+    "        ts_language_symbol_count(language) != MARKDOC_SYMBOLS_SYMBOL_COUNT ||",
+    "        ts_language_field_count(language) != MARKDOC_SYMBOLS_FIELD_COUNT) {",
+    "        return false;",
+    "    }",
+    "    uint64_t hash = 0xCBF29CE484222325ull;",
+    "    for (uint32_t i = 0; i < MARKDOC_SYMBOLS_SYMBOL_COUNT + MARKDOC_SYMBOLS_FIELD_COUNT; i++) {",
+    "        const char *name = i < MARKDOC_SYMBOLS_SYMBOL_COUNT",
+    "                               ? ts_language_symbol_name(language, (TSSymbol)i)",
+    "                               : ts_language_field_name_for_id(",
+    "                                     language, (TSFieldId)(i - MARKDOC_SYMBOLS_SYMBOL_COUNT + 1));",
+    "        if (name == NULL) {",
+    "            return false;",
+    "        }",
+    "        do {",
+    "            hash = (hash ^ (unsigned char)*name) * 0x100000001B3ull;",
+    "        } while (*name++ != '\\0');",
+    "    }",
+    "    return hash == MARKDOC_SYMBOLS_FINGERPRINT;",
+    "}",
+    "",
+    "#ifdef __cplusplus",
+    "namespace markdoc {",
+    "namespace symbol {",
+]
+lines += [f"constexpr TSSymbol {cpp} = {constant};" for constant, cpp, _, _ in symbols]
+lines += [
+    "constexpr TSSymbol error = MARKDOC_SYM_ERROR;",
+    "}  // namespace symbol",
+    "",
+    "namespace field {",
+]
+lines += [f"constexpr TSFieldId {name} = MARKDOC_FIELD_{name.upper()};"
+          for name in (n.removeprefix("field_") for n in
+                       sorted(fields, key=fields.get))]
+lines += [
+    "}  // namespace field",
+    "}  // namespace markdoc",
+    "#endif",
+    "",
+    "#endif // TREE_SITTER_MARKDOC_SYMBOLS_H_",
+    "",
+]
+output = "\n".join(lines)
+
+if "--check" in sys.argv[1:]:
+    current = header_path.read_text(encoding="utf-8") if header_path.exists() else ""
+    if current != output:
+        print(f"{header_path.relative_to(root)} is out of date; "
+              "run bindings/c/generate_symbols.py", file=sys.stderr)
+        sys.exit(1)
+else:
+    header_path.write_text(output, encoding="utf-8")
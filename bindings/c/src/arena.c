@@ -0,0 +1,232 @@
+#include "tree_sitter/markdoc/arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+#define DEFAULT_BLOCK_SIZE (1024 * 1024)
+
+typedef struct Block {
+    struct Block *next;
+    size_t capacity;
+    size_t used;
+    max_align_t data[];
+} Block;
+
+struct MarkdocArena {
+    Block *first;
+    Block *current;
+    size_t block_size;
+    // The most recent allocation, which realloc can grow and free can undo
+    // in place.
+    void *last;
+    MarkdocArenaStats stats;
+};
+
+// Every allocation is preceded by a header naming the arena it came from, or
+// NULL for the heap, so frees and reallocs route correctly whichever arena
+// is active when they happen.
+typedef union {
+    struct {
+        MarkdocArena *arena;
+        size_t size;
+    } info;
+    max_align_t align;
+} Header;
+
+static THREAD_LOCAL MarkdocArena *active_arena;
+static THREAD_LOCAL MarkdocArenaStats heap_stats;
+
+static inline size_t align_up(size_t size) {
+    return (size + sizeof(max_align_t) - 1) & ~(sizeof(max_align_t) - 1);
+}
+
+static Block *block_new(size_t capacity) {
+    Block *block = malloc(sizeof(Block) + capacity);
+    if (block != NULL) {
+        block->next = NULL;
+        block->capacity = capacity;
+        block->used = 0;
+    }
+    return block;
+}
+
+// Returns `size` bytes after a header, from the current block or the next
+// one that fits, appending a block when none does.
+static Header *arena_take(MarkdocArena *arena, size_t size) {
+    size_t needed = sizeof(Header) + align_up(size);
+    Block *block = arena->current;
+    while (block != NULL && block->capacity - block->used < needed) {
+        if (block->next == NULL) {
+            size_t capacity = needed > arena->block_size ? needed : arena->block_size;
+            block->next = block_new(capacity);
+            if (block->next == NULL) {
+                return NULL;
+            }
+            arena->stats.bytes_reserved += capacity;
+        }
+        block = block->next;
+    }
+    arena->current = block;
+
+    Header *header = (Header *)((char *)block->data + block->used);
+    block->used += needed;
+    arena->stats.bytes_used += needed;
+    header->info.arena = arena;
+    header->info.size = size;
+    arena->last = header + 1;
+    return header;
+}
+
+static void *allocate(size_t size) {
+    MarkdocArena *arena = active_arena;
+    Header *header;
+    if (arena != NULL) {
+        header = arena_take(arena, size);
+        arena->stats.allocations++;
+    } else {
+        header = malloc(sizeof(Header) + size);
+        heap_stats.allocations++;
+        if (header != NULL) {
+            header->info.arena = NULL;
+            header->info.size = size;
+        }
+    }
+    return header != NULL ? header + 1 : NULL;
+}
+
+static void *arena_malloc(size_t size) {
+    return allocate(size);
+}
+
+static void *arena_calloc(size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    void *pointer = allocate(count * size);
+    if (pointer != NULL) {
+        memset(pointer, 0, count * size);
+    }
+    return pointer;
+}
+
+static void arena_free(void *pointer) {
+    if (pointer == NULL) {
+        return;
+    }
+    Header *header = (Header *)pointer - 1;
+    MarkdocArena *arena = header->info.arena;
+    if (arena == NULL) {
+        heap_stats.frees++;
+        free(header);
+        return;
+    }
+    arena->stats.frees++;
+    // Undo the most recent allocation; everything else waits for the reset.
+    if (pointer == arena->last && arena == active_arena) {
+        size_t size = sizeof(Header) + align_up(header->info.size);
+        arena->current->used -= size;
+        arena->stats.bytes_used -= size;
+        arena->last = NULL;
+    }
+}
+
+static void *arena_realloc(void *pointer, size_t size) {
+    if (pointer == NULL) {
+        return allocate(size);
+    }
+    Header *header = (Header *)pointer - 1;
+    MarkdocArena *arena = header->info.arena;
+
+    if (arena == NULL && active_arena == NULL) {
+        Header *resized = realloc(header, sizeof(Header) + size);
+        heap_stats.allocations++;
+        if (resized == NULL) {
+            return NULL;
+        }
+        resized->info.size = size;
+        return resized + 1;
+    }
+
+    // Grow or shrink the most recent allocation where it lies.
+    if (arena != NULL && arena == active_arena && pointer == arena->last) {
+        Block *block = arena->current;
+        size_t old_size = align_up(header->info.size);
+        size_t new_size = align_up(size);
+        if (new_size <= old_size || block->capacity - block->used >= new_size - old_size) {
+            block->used = block->used - old_size + new_size;
+            arena->stats.bytes_used = arena->stats.bytes_used - old_size + new_size;
+            arena->stats.allocations++;
+            header->info.size = size;
+            return pointer;
+        }
+    }
+
+    void *moved = allocate(size);
+    if (moved == NULL) {
+        return NULL;
+    }
+    memcpy(moved, pointer, header->info.size < size ? header->info.size : size);
+    arena_free(pointer);
+    return moved;
+}
+
+void markdoc_arena_install(void) {
+    ts_set_allocator(arena_malloc, arena_calloc, arena_realloc, arena_free);
+}
+
+MarkdocArena *markdoc_arena_new(size_t block_size) {
+    MarkdocArena *arena = calloc(1, sizeof(MarkdocArena));
+    if (arena == NULL) {
+        return NULL;
+    }
+    arena->block_size = block_size ? block_size : DEFAULT_BLOCK_SIZE;
+    arena->first = block_new(arena->block_size);
+    if (arena->first == NULL) {
+        free(arena);
+        return NULL;
+    }
+    arena->current = arena->first;
+    arena->stats.bytes_reserved = arena->block_size;
+    return arena;
+}
+
+void markdoc_arena_delete(MarkdocArena *arena) {
+    if (arena == NULL) {
+        return;
+    }
+    if (active_arena == arena) {
+        active_arena = NULL;
+    }
+    Block *block = arena->first;
+    while (block != NULL) {
+        Block *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+MarkdocArena *markdoc_arena_activate(MarkdocArena *arena) {
+    MarkdocArena *previous = active_arena;
+    active_arena = arena;
+    return previous;
+}
+
+void markdoc_arena_reset(MarkdocArena *arena) {
+    for (Block *block = arena->first; block != NULL; block = block->next) {
+        block->used = 0;
+    }
+    arena->current = arena->first;
+    arena->last = NULL;
+    arena->stats.bytes_used = 0;
+}
+
+MarkdocArenaStats markdoc_arena_stats(const MarkdocArena *arena) {
+    return arena != NULL ? arena->stats : heap_stats;
+}
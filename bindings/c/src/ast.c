@@ -0,0 +1,1056 @@
+#include "tree_sitter/markdoc/ast.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "inlines.h"
+#include "lines.h"
+#include "output.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+typedef struct {
+    MarkdocOutput output;
+    const char *source;
+} Emitter;
+
+// A run of text to be written as one text node: adjacent text tokens, and
+// what lies between them on the same line, merge the way markdown-it's do.
+typedef struct {
+    bool active;
+    uint32_t start_byte;
+    uint32_t end_byte;
+    TSPoint start_point;
+    TSPoint end_point;
+} PendingText;
+
+static void write_raw(Emitter *emitter, const char *string) {
+    markdoc_output_string(&emitter->output, string);
+}
+
+static void write_uint(Emitter *emitter, uint32_t value) {
+    char digits[16];
+    int length = snprintf(digits, sizeof(digits), "%u", value);
+    markdoc_output_write(&emitter->output, digits, (size_t)length);
+}
+
+static void write_json_string(Emitter *emitter, const char *data, uint32_t length) {
+    MarkdocOutput *output = &emitter->output;
+    markdoc_output_char(output, '"');
+    uint32_t run = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)data[i];
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        markdoc_output_write(output, data + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"': write_raw(emitter, "\\\""); break;
+            case '\\': write_raw(emitter, "\\\\"); break;
+            case '\n': write_raw(emitter, "\\n"); break;
+            case '\r': write_raw(emitter, "\\r"); break;
+            case '\t': write_raw(emitter, "\\t"); break;
+            default: {
+                char escape[8];
+                snprintf(escape, sizeof(escape), "\\u%04x", c);
+                markdoc_output_write(output, escape, 6);
+            }
+        }
+    }
+    markdoc_output_write(output, data + run, length - run);
+    markdoc_output_char(output, '"');
+}
+
+static void write_node_string(Emitter *emitter, uint32_t start_byte, uint32_t end_byte) {
+    write_json_string(emitter, emitter->source + start_byte, end_byte - start_byte);
+}
+
+static void separate(Emitter *emitter, bool *first) {
+    if (!*first) {
+        markdoc_output_char(&emitter->output, ',');
+    }
+    *first = false;
+}
+
+static void write_key(Emitter *emitter, bool *first, const char *key) {
+    separate(emitter, first);
+    markdoc_output_char(&emitter->output, '"');
+    write_raw(emitter, key);
+    write_raw(emitter, "\":");
+}
+
+// Writes everything up to the attributes' opening brace. Markdoc's `lines`
+// are the first line and the line after the last.
+static void begin_node(Emitter *emitter, bool *first, TSPoint start, TSPoint end, bool is_inline,
+                       const char *error) {
+    separate(emitter, first);
+    write_raw(emitter, "{\"$$mdtype\":\"Node\",\"errors\":[");
+    if (error != NULL) {
+        write_raw(emitter, "{\"id\":\"syntax-error\",\"level\":\"critical\",\"message\":\"");
+        write_raw(emitter, error);
+        write_raw(emitter, "\"}");
+    }
+    write_raw(emitter, "],\"lines\":[");
+    write_uint(emitter, start.row);
+    markdoc_output_char(&emitter->output, ',');
+    write_uint(emitter, end.column > 0 || end.row == start.row ? end.row + 1 : end.row);
+    write_raw(emitter, is_inline ? "],\"inline\":true,\"attributes\":{" :
+                                   "],\"inline\":false,\"attributes\":{");
+}
+
+static void begin_children(Emitter *emitter) {
+    write_raw(emitter, "},\"children\":[");
+}
+
+static void end_node(Emitter *emitter, const char *type, const char *tag, uint32_t tag_length) {
+    write_raw(emitter, "],\"type\":\"");
+    write_raw(emitter, type);
+    markdoc_output_char(&emitter->output, '"');
+    if (tag != NULL) {
+        write_raw(emitter, ",\"tag\":");
+        write_json_string(emitter, tag, tag_length);
+    }
+    write_raw(emitter, ",\"annotations\":[],\"slots\":{}}");
+}
+
+// A node with no children and a single string attribute.
+static void write_leaf(Emitter *emitter, bool *first, TSPoint start, TSPoint end, bool is_inline,
+                       const char *type, const char *key, uint32_t start_byte,
+                       uint32_t end_byte) {
+    begin_node(emitter, first, start, end, is_inline, NULL);
+    bool first_attribute = true;
+    write_key(emitter, &first_attribute, key);
+    write_node_string(emitter, start_byte, end_byte);
+    begin_children(emitter);
+    end_node(emitter, type, NULL, 0);
+}
+
+static void write_error(Emitter *emitter, bool *first, TSNode node, bool is_inline) {
+    begin_node(emitter, first, ts_node_start_point(node), ts_node_end_point(node), is_inline,
+               "Syntax error");
+    begin_children(emitter);
+    end_node(emitter, "error", NULL, 0);
+}
+
+static void trim(const char *source, uint32_t *start, uint32_t *end) {
+    while (*start < *end && (source[*start] == ' ' || source[*start] == '\t')) {
+        (*start)++;
+    }
+    while (*end > *start && (source[*end - 1] == ' ' || source[*end - 1] == '\t' ||
+                             source[*end - 1] == '\r' || source[*end - 1] == '\n')) {
+        (*end)--;
+    }
+}
+
+// Values
+
+static void write_value(Emitter *emitter, TSTreeCursor *cursor);
+
+static bool is_hex_digit(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+// Writes a string literal's contents as a JSON string, resolving the
+// grammar's backslash escapes. `\u` passes through only before four hex
+// digits, which JSON requires; otherwise its backslash is kept as written.
+static void write_string_literal(Emitter *emitter, TSNode node) {
+    const char *source = emitter->source;
+    uint32_t start = ts_node_start_byte(node) + 1, end = ts_node_end_byte(node);
+    if (end > start) {
+        end--;
+    }
+    MarkdocOutput *output = &emitter->output;
+    markdoc_output_char(output, '"');
+    for (uint32_t i = start; i < end; i++) {
+        char c = source[i];
+        if (c == '\\' && i + 1 < end) {
+            c = source[++i];
+            switch (c) {
+                case 'b': case 'f': case 'n': case 'r': case 't':
+                    markdoc_output_char(output, '\\');
+                    markdoc_output_char(output, c);
+                    continue;
+                case 'u':
+                    if (end - i > 4 && is_hex_digit(source[i + 1]) &&
+                        is_hex_digit(source[i + 2]) && is_hex_digit(source[i + 3]) &&
+                        is_hex_digit(source[i + 4])) {
+                        markdoc_output_char(output, '\\');
+                    } else {
+                        markdoc_output_write(output, "\\\\", 2);
+                    }
+                    markdoc_output_char(output, c);
+                    continue;
+                default: break;
+            }
+        }
+        if (c == '"' || c == '\\') {
+            markdoc_output_char(output, '\\');
+            markdoc_output_char(output, c);
+        } else if ((unsigned char)c < 0x20) {
+            char escape[8];
+            snprintf(escape, sizeof(escape), "\\u%04x", (unsigned char)c);
+            markdoc_output_write(output, escape, 6);
+        } else {
+            markdoc_output_char(output, c);
+        }
+    }
+    markdoc_output_char(output, '"');
+}
+
+// Numbers are valid JSON except for leading zeros, which JSON forbids.
+static void write_number(Emitter *emitter, TSNode node) {
+    const char *source = emitter->source;
+    uint32_t start = ts_node_start_byte(node), end = ts_node_end_byte(node);
+    if (start < end && source[start] == '-') {
+        markdoc_output_char(&emitter->output, '-');
+        start++;
+    }
+    while (end - start > 1 && source[start] == '0' && source[start + 1] != '.') {
+        start++;
+    }
+    markdoc_output_write(&emitter->output, source + start, end - start);
+}
+
+// Writes the path segments of a variable, variable_reference,
+// special_variable_reference or subscript_reference, and reports whether it
+// starts with `@`.
+static void write_path(Emitter *emitter, TSTreeCursor *cursor, bool *first, bool *special) {
+    if (!ts_tree_cursor_goto_first_child(cursor)) {
+        return;
+    }
+    do {
+        TSNode child = ts_tree_cursor_current_node(cursor);
+        switch (ts_node_symbol(child)) {
+            case MARKDOC_SYM_SPECIAL_VARIABLE:
+                *special = true;
+                // fall through
+            case MARKDOC_SYM_VARIABLE:
+            case MARKDOC_SYM_VARIABLE_REFERENCE:
+            case MARKDOC_SYM_SPECIAL_VARIABLE_REFERENCE:
+                write_path(emitter, cursor, first, special);
+                break;
+            case MARKDOC_SYM_IDENTIFIER:
+                separate(emitter, first);
+                write_node_string(emitter, ts_node_start_byte(child), ts_node_end_byte(child));
+                break;
+            case MARKDOC_SYM_ARRAY_SUBSCRIPT: {
+                TSNode index = ts_node_named_child(child, 0);
+                separate(emitter, first);
+                if (ts_node_symbol(index) == MARKDOC_SYM_STRING) {
+                    write_string_literal(emitter, index);
+                } else if (ts_node_symbol(index) == MARKDOC_SYM_NUMBER) {
+                    write_number(emitter, index);
+                } else {
+                    write_raw(emitter, "null");
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    } while (ts_tree_cursor_goto_next_sibling(cursor));
+    ts_tree_cursor_goto_parent(cursor);
+}
+
+static void write_variable(Emitter *emitter, TSTreeCursor *cursor) {
+    bool first = true, special = false;
+    write_raw(emitter, "{\"$$mdtype\":\"Variable\",\"path\":[");
+    write_path(emitter, cursor, &first, &special);
+    write_raw(emitter, special ? "],\"special\":true}" : "]}");
+}
+
+static void write_function(Emitter *emitter, TSTreeCursor *cursor) {
+    write_raw(emitter, "{\"$$mdtype\":\"Function\",\"name\":");
+    TSNode name = ts_node_child_by_field_id(ts_tree_cursor_current_node(cursor),
+                                            MARKDOC_FIELD_FUNCTION);
+    write_node_string(emitter, ts_node_start_byte(name), ts_node_end_byte(name));
+    write_raw(emitter, ",\"parameters\":{");
+    uint32_t index = 0;
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            if (ts_node_symbol(ts_tree_cursor_current_node(cursor)) ==
+                MARKDOC_SYM_VALUE_EXPRESSION) {
+                if (index > 0) {
+                    markdoc_output_char(&emitter->output, ',');
+                }
+                markdoc_output_char(&emitter->output, '"');
+                write_uint(emitter, index++);
+                write_raw(emitter, "\":");
+                write_value(emitter, cursor);
+            }
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    write_raw(emitter, "}}");
+}
+
+// Writes the elements of an array_literal, or the pairs of an
+// object_literal.
+static void write_collection(Emitter *emitter, TSTreeCursor *cursor, bool object) {
+    markdoc_output_char(&emitter->output, object ? '{' : '[');
+    bool first = true;
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            TSNode child = ts_tree_cursor_current_node(cursor);
+            TSSymbol symbol = ts_node_symbol(child);
+            if (!object && symbol == MARKDOC_SYM_JSON_VALUE) {
+                separate(emitter, &first);
+                write_value(emitter, cursor);
+            } else if (object && symbol == MARKDOC_SYM_PAIR) {
+                TSNode key = ts_node_child_by_field_id(child, MARKDOC_FIELD_KEY);
+                separate(emitter, &first);
+                if (ts_node_symbol(key) == MARKDOC_SYM_STRING) {
+                    write_string_literal(emitter, key);
+                } else {
+                    write_node_string(emitter, ts_node_start_byte(key), ts_node_end_byte(key));
+                }
+                markdoc_output_char(&emitter->output, ':');
+                ts_tree_cursor_goto_first_child(cursor);
+                while (ts_tree_cursor_current_field_id(cursor) != MARKDOC_FIELD_VALUE &&
+                       ts_tree_cursor_goto_next_sibling(cursor)) {
+                }
+                if (ts_tree_cursor_current_field_id(cursor) == MARKDOC_FIELD_VALUE) {
+                    write_value(emitter, cursor);
+                } else {
+                    write_raw(emitter, "null");
+                }
+                ts_tree_cursor_goto_parent(cursor);
+            }
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    markdoc_output_char(&emitter->output, object ? '}' : ']');
+}
+
+// Writes the value of the node under the cursor, looking through the
+// attribute_value, value_expression, json_value and variable_value
+// wrappers.
+static void write_value(Emitter *emitter, TSTreeCursor *cursor) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    switch (ts_node_symbol(node)) {
+        case MARKDOC_SYM_ATTRIBUTE_VALUE:
+        case MARKDOC_SYM_VALUE_EXPRESSION:
+        case MARKDOC_SYM_JSON_VALUE:
+        case MARKDOC_SYM_VARIABLE_VALUE: {
+            bool found = false;
+            if (ts_tree_cursor_goto_first_child(cursor)) {
+                do {
+                    if (ts_node_is_named(ts_tree_cursor_current_node(cursor))) {
+                        write_value(emitter, cursor);
+                        found = true;
+                        break;
+                    }
+                } while (ts_tree_cursor_goto_next_sibling(cursor));
+                ts_tree_cursor_goto_parent(cursor);
+            }
+            if (!found) {
+                write_raw(emitter, "null");
+            }
+            break;
+        }
+        case MARKDOC_SYM_STRING:
+            write_string_literal(emitter, node);
+            break;
+        case MARKDOC_SYM_NUMBER:
+            write_number(emitter, node);
+            break;
+        case MARKDOC_SYM_BOOLEAN:
+        case MARKDOC_SYM_NULL:
+            markdoc_output_write(&emitter->output, emitter->source + ts_node_start_byte(node),
+                                 ts_node_end_byte(node) - ts_node_start_byte(node));
+            break;
+        case MARKDOC_SYM_ARRAY_LITERAL:
+            write_collection(emitter, cursor, false);
+            break;
+        case MARKDOC_SYM_OBJECT_LITERAL:
+            write_collection(emitter, cursor, true);
+            break;
+        case MARKDOC_SYM_VARIABLE_REFERENCE:
+        case MARKDOC_SYM_SPECIAL_VARIABLE_REFERENCE:
+        case MARKDOC_SYM_SUBSCRIPT_REFERENCE:
+            write_variable(emitter, cursor);
+            break;
+        case MARKDOC_SYM_CALL_EXPRESSION:
+            write_function(emitter, cursor);
+            break;
+        default:
+            write_raw(emitter, "null");
+            break;
+    }
+}
+
+// Tags
+
+// Writes the attributes of the tag_open or tag_self_close under the cursor
+// and returns its name.
+static TSNode write_tag_attributes(Emitter *emitter, TSTreeCursor *cursor) {
+    TSNode name = {0};
+    bool first = true;
+    if (!ts_tree_cursor_goto_first_child(cursor)) {
+        return name;
+    }
+    do {
+        TSNode child = ts_tree_cursor_current_node(cursor);
+        TSSymbol symbol = ts_node_symbol(child);
+        if (symbol == MARKDOC_SYM_TAG_NAME) {
+            name = child;
+        } else if (symbol == MARKDOC_SYM_ATTRIBUTE) {
+            TSNode key = ts_node_named_child(child, 0);
+            separate(emitter, &first);
+            write_node_string(emitter, ts_node_start_byte(key), ts_node_end_byte(key));
+            markdoc_output_char(&emitter->output, ':');
+            ts_tree_cursor_goto_first_child(cursor);
+            while (ts_node_symbol(ts_tree_cursor_current_node(cursor)) !=
+                       MARKDOC_SYM_ATTRIBUTE_VALUE &&
+                   ts_tree_cursor_goto_next_sibling(cursor)) {
+            }
+            write_value(emitter, cursor);
+            ts_tree_cursor_goto_parent(cursor);
+        }
+    } while (ts_tree_cursor_goto_next_sibling(cursor));
+    ts_tree_cursor_goto_parent(cursor);
+    return name;
+}
+
+static void write_blocks(Emitter *emitter, TSTreeCursor *cursor, bool *first);
+
+// Writes a markdoc_tag, or a tag_self_close inside a paragraph, as a tag
+// node. Block tags take the blocks between their open and close lines as
+// children.
+static void write_tag(Emitter *emitter, TSTreeCursor *cursor, bool *first, bool is_inline) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    begin_node(emitter, first, ts_node_start_point(node), ts_node_end_point(node), is_inline,
+               NULL);
+    TSNode name;
+    if (ts_node_symbol(node) == MARKDOC_SYM_TAG_SELF_CLOSE) {
+        name = write_tag_attributes(emitter, cursor);
+        begin_children(emitter);
+    } else {
+        ts_tree_cursor_goto_first_child(cursor);
+        name = write_tag_attributes(emitter, cursor);
+        ts_tree_cursor_goto_parent(cursor);
+        begin_children(emitter);
+        bool first_child = true;
+        write_blocks(emitter, cursor, &first_child);
+    }
+    uint32_t start = ts_node_start_byte(name);
+    end_node(emitter, "tag", emitter->source + start, ts_node_end_byte(name) - start);
+}
+
+// Inlines
+
+static void flush_text(Emitter *emitter, bool *first, PendingText *text, bool line_end) {
+    if (!text->active) {
+        return;
+    }
+    text->active = false;
+    uint32_t start = text->start_byte, end = text->end_byte;
+    if (line_end) {
+        trim(emitter->source, &start, &end);
+    }
+    if (start < end) {
+        write_leaf(emitter, first, text->start_point, text->end_point, true, "text", "content",
+                   start, end);
+    }
+}
+
+static void extend_text(PendingText *text, uint32_t start_byte, TSPoint start_point,
+                        uint32_t end_byte, TSPoint end_point) {
+    if (!text->active) {
+        *text = (PendingText){true, start_byte, end_byte, start_point, end_point};
+    } else {
+        text->end_byte = end_byte;
+        text->end_point = end_point;
+    }
+}
+
+// Splits the link or image destination [start, end) into its URL and
+// optional quoted title.
+static void write_destination(Emitter *emitter, bool *first, uint32_t start, uint32_t end,
+                              const char *url_key) {
+    const char *source = emitter->source;
+    trim(source, &start, &end);
+    uint32_t url_end = start;
+    while (url_end < end && !markdoc_is_space(source[url_end])) {
+        url_end++;
+    }
+    uint32_t url_start = start;
+    if (url_end - url_start >= 2 && source[url_start] == '<' && source[url_end - 1] == '>') {
+        url_start++;
+        url_end--;
+    }
+    write_key(emitter, first, url_key);
+    write_node_string(emitter, url_start, url_end);
+
+    uint32_t title = url_end;
+    while (title < end && (markdoc_is_space(source[title]) || source[title] == '>')) {
+        title++;
+    }
+    if (end - title >= 2 && (source[title] == '"' || source[title] == '\'') &&
+        source[end - 1] == source[title]) {
+        write_key(emitter, first, "title");
+        write_node_string(emitter, title + 1, end - 1);
+    }
+}
+
+static void write_inline_text(Emitter *emitter, bool *first, TSPoint start_point,
+                              TSPoint end_point, uint32_t start, uint32_t end);
+
+// Writes the link or image `span`.
+static void write_inline_link(Emitter *emitter, bool *first, TSPoint start_point,
+                              TSPoint end_point, const MarkdocSpan *span) {
+    bool image = span->kind == MARKDOC_SPAN_IMAGE;
+    bool first_attribute = true, first_child = true;
+    begin_node(emitter, first, start_point, end_point, true, NULL);
+    write_destination(emitter, &first_attribute, span->destination_start, span->destination_end,
+                      image ? "src" : "href");
+    if (image) {
+        write_key(emitter, &first_attribute, "alt");
+        write_node_string(emitter, span->content_start, span->content_end);
+    }
+    begin_children(emitter);
+    if (!image) {
+        write_inline_text(emitter, &first_child, start_point, end_point, span->content_start,
+                          span->content_end);
+    }
+    end_node(emitter, image ? "image" : "link", NULL, 0);
+}
+
+// Writes the single-line range [start, end), whose markup has no nodes, as
+// text, em, strong, code, link and image nodes found by markdoc_next_span().
+static void write_inline_text(Emitter *emitter, bool *first, TSPoint start_point,
+                              TSPoint end_point, uint32_t start, uint32_t end) {
+    const char *source = emitter->source;
+    uint32_t text = start;
+    MarkdocSpan span;
+    while (markdoc_next_span(source, text, end, &span)) {
+        if (text < span.start) {
+            write_leaf(emitter, first, start_point, end_point, true, "text", "content", text,
+                       span.start);
+        }
+        if (span.kind == MARKDOC_SPAN_EMPHASIS || span.kind == MARKDOC_SPAN_STRONG) {
+            bool strong = span.kind == MARKDOC_SPAN_STRONG;
+            bool first_attribute = true, first_child = true;
+            begin_node(emitter, first, start_point, end_point, true, NULL);
+            write_key(emitter, &first_attribute, "marker");
+            write_node_string(emitter, span.start, span.content_start);
+            begin_children(emitter);
+            write_inline_text(emitter, &first_child, start_point, end_point, span.content_start,
+                              span.content_end);
+            end_node(emitter, strong ? "strong" : "em", NULL, 0);
+        } else if (span.kind == MARKDOC_SPAN_CODE) {
+            write_leaf(emitter, first, start_point, end_point, true, "code", "content",
+                       span.content_start, span.content_end);
+        } else {
+            write_inline_link(emitter, first, start_point, end_point, &span);
+        }
+        text = span.end;
+    }
+    if (text < end) {
+        write_leaf(emitter, first, start_point, end_point, true, "text", "content", text, end);
+    }
+}
+
+static void write_inline(Emitter *emitter, TSTreeCursor *cursor, bool *first) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    TSPoint start_point = ts_node_start_point(node), end_point = ts_node_end_point(node);
+    uint32_t start = ts_node_start_byte(node), end = ts_node_end_byte(node);
+    bool first_attribute = true, first_child = true;
+
+    switch (ts_node_symbol(node)) {
+        case MARKDOC_SYM_EMPHASIS:
+        case MARKDOC_SYM_STRONG: {
+            bool strong = ts_node_symbol(node) == MARKDOC_SYM_STRONG;
+            uint32_t marker = strong ? 2 : 1;
+            begin_node(emitter, first, start_point, end_point, true, NULL);
+            write_key(emitter, &first_attribute, "marker");
+            write_node_string(emitter, start, start + marker);
+            begin_children(emitter);
+            write_inline_text(emitter, &first_child, start_point, end_point, start + marker,
+                              end - marker);
+            end_node(emitter, strong ? "strong" : "em", NULL, 0);
+            break;
+        }
+        case MARKDOC_SYM_INLINE_CODE: {
+            uint32_t code_start = start + 1, code_end = end - 1;
+            markdoc_code_span_end(emitter->source, start, end, &code_start, &code_end);
+            write_leaf(emitter, first, start_point, end_point, true, "code", "content", code_start,
+                       code_end);
+            break;
+        }
+        case MARKDOC_SYM_LINK: {
+            TSNode text = ts_node_named_child(node, 0);
+            TSNode destination = ts_node_named_child(node, 1);
+            begin_node(emitter, first, start_point, end_point, true, NULL);
+            write_destination(emitter, &first_attribute, ts_node_start_byte(destination),
+                              ts_node_end_byte(destination), "href");
+            begin_children(emitter);
+            write_inline_text(emitter, &first_child, start_point, end_point,
+                              ts_node_start_byte(text), ts_node_end_byte(text));
+            end_node(emitter, "link", NULL, 0);
+            break;
+        }
+        case MARKDOC_SYM_IMAGE: {
+            TSNode alt = ts_node_named_child(node, 0);
+            TSNode destination = ts_node_named_child(node, 1);
+            begin_node(emitter, first, start_point, end_point, true, NULL);
+            write_destination(emitter, &first_attribute, ts_node_start_byte(destination),
+                              ts_node_end_byte(destination), "src");
+            write_key(emitter, &first_attribute, "alt");
+            write_node_string(emitter, ts_node_start_byte(alt), ts_node_end_byte(alt));
+            begin_children(emitter);
+            end_node(emitter, "image", NULL, 0);
+            break;
+        }
+        case MARKDOC_SYM_INLINE_EXPRESSION:
+            begin_node(emitter, first, start_point, end_point, true, NULL);
+            write_key(emitter, &first_attribute, "content");
+            ts_tree_cursor_goto_first_child(cursor);
+            while (ts_tree_cursor_current_field_id(cursor) != MARKDOC_FIELD_CONTENT &&
+                   ts_tree_cursor_goto_next_sibling(cursor)) {
+            }
+            write_value(emitter, cursor);
+            ts_tree_cursor_goto_parent(cursor);
+            begin_children(emitter);
+            end_node(emitter, "text", NULL, 0);
+            break;
+        case MARKDOC_SYM_INLINE_TAG:
+            if (ts_tree_cursor_goto_first_child(cursor)) {
+                write_tag(emitter, cursor, first, true);
+                ts_tree_cursor_goto_parent(cursor);
+            }
+            break;
+        case MARKDOC_SYM_TAG_SELF_CLOSE:
+            write_tag(emitter, cursor, first, true);
+            break;
+        case MARKDOC_SYM_HTML_INLINE:
+            write_leaf(emitter, first, start_point, end_point, true, "text", "content", start, end);
+            break;
+        case MARKDOC_SYM_ERROR:
+            write_error(emitter, first, node, true);
+            break;
+        default:
+            break;
+    }
+}
+
+// Writes the `inline` node holding the contents of the paragraph or
+// list_paragraph under the cursor. Line breaks between its children become
+// softbreak nodes, or hardbreak after two trailing spaces.
+static void write_inline_container(Emitter *emitter, TSTreeCursor *cursor, bool *first) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    const char *source = emitter->source;
+    begin_node(emitter, first, ts_node_start_point(node), ts_node_end_point(node), true, NULL);
+    begin_children(emitter);
+
+    bool first_child = true;
+    PendingText text = {0};
+    uint32_t previous_end = ts_node_start_byte(node);
+    TSPoint previous_point = ts_node_start_point(node);
+    bool line_start = true;
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            TSNode child = ts_tree_cursor_current_node(cursor);
+            if (!ts_node_is_named(child) || ts_node_is_missing(child)) {
+                continue;
+            }
+            uint32_t start = ts_node_start_byte(child), end = ts_node_end_byte(child);
+            TSPoint start_point = ts_node_start_point(child);
+            if (memchr(source + previous_end, '\n', start - previous_end) != NULL) {
+                bool hard = text.active && text.end_byte - text.start_byte >= 2 &&
+                            source[text.end_byte - 1] == ' ' && source[text.end_byte - 2] == ' ';
+                flush_text(emitter, &first_child, &text, true);
+                begin_node(emitter, &first_child, previous_point, start_point, true, NULL);
+                begin_children(emitter);
+                end_node(emitter, hard ? "hardbreak" : "softbreak", NULL, 0);
+                line_start = true;
+            } else if (start > previous_end && !line_start) {
+                extend_text(&text, previous_end, previous_point, start, start_point);
+            }
+
+            if (ts_node_symbol(child) == MARKDOC_SYM_TEXT) {
+                uint32_t text_start = start;
+                while (line_start && !text.active && text_start < end &&
+                       markdoc_is_space(source[text_start])) {
+                    text_start++;
+                }
+                if (text_start < end) {
+                    extend_text(&text, text_start, start_point, end, ts_node_end_point(child));
+                }
+            } else {
+                flush_text(emitter, &first_child, &text, false);
+                write_inline(emitter, cursor, &first_child);
+            }
+            line_start = false;
+            previous_end = end;
+            previous_point = ts_node_end_point(child);
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    flush_text(emitter, &first_child, &text, true);
+    end_node(emitter, "inline", NULL, 0);
+}
+
+// Blocks
+
+static uint32_t marker_digits(const char *source, uint32_t start, uint32_t end, uint32_t *value) {
+    while (start < end && markdoc_is_space(source[start])) {
+        start++;
+    }
+    *value = 0;
+    while (start < end && source[start] >= '0' && source[start] <= '9') {
+        *value = *value * 10 + (uint32_t)(source[start] - '0');
+        start++;
+    }
+    return start;
+}
+
+static void write_block(Emitter *emitter, TSTreeCursor *cursor, bool *first);
+
+static void write_item(Emitter *emitter, TSTreeCursor *cursor, bool *first) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    begin_node(emitter, first, ts_node_start_point(node), ts_node_end_point(node), false, NULL);
+    begin_children(emitter);
+    bool first_child = true;
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            switch (ts_node_symbol(ts_tree_cursor_current_node(cursor))) {
+                case MARKDOC_SYM_LIST_PARAGRAPH:
+                    write_inline_container(emitter, cursor, &first_child);
+                    break;
+                case MARKDOC_SYM_LIST_ITEM_CONTINUATION:
+                    write_blocks(emitter, cursor, &first_child);
+                    break;
+                default:
+                    write_block(emitter, cursor, &first_child);
+                    break;
+            }
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    end_node(emitter, "item", NULL, 0);
+}
+
+static void write_list(Emitter *emitter, TSTreeCursor *cursor, bool *first, bool ordered) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    const char *source = emitter->source;
+    begin_node(emitter, first, ts_node_start_point(node), ts_node_end_point(node), false, NULL);
+
+    // Markdoc's `marker` is the bullet, or the delimiter after the number.
+    bool first_attribute = true;
+    write_key(emitter, &first_attribute, "ordered");
+    write_raw(emitter, ordered ? "true" : "false");
+    TSNode marker = ts_node_child_by_field_id(ts_node_named_child(node, 0), MARKDOC_FIELD_MARKER);
+    if (!ts_node_is_null(marker)) {
+        uint32_t start = ts_node_start_byte(marker), end = ts_node_end_byte(marker);
+        uint32_t number;
+        uint32_t delimiter = marker_digits(source, start, end, &number);
+        if (delimiter < end) {
+            write_key(emitter, &first_attribute, "marker");
+            write_node_string(emitter, delimiter, delimiter + 1);
+        }
+        if (ordered && number != 1) {
+            write_key(emitter, &first_attribute, "start");
+            write_uint(emitter, number);
+        }
+    }
+
+    begin_children(emitter);
+    bool first_child = true;
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            TSSymbol symbol = ts_node_symbol(ts_tree_cursor_current_node(cursor));
+            if (symbol == MARKDOC_SYM_UNORDERED_LIST_ITEM ||
+                symbol == MARKDOC_SYM_ORDERED_LIST_ITEM) {
+                write_item(emitter, cursor, &first_child);
+            }
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    end_node(emitter, "list", NULL, 0);
+}
+
+// Writes the `key=value` pairs of a fence's `{...}` info attributes, such as
+// {class="highlight" process=false}. Quoted values are strings and bare
+// ones are kept as JSON when they are numbers, booleans or null.
+static void write_info_attributes(Emitter *emitter, bool *first, TSNode node) {
+    const char *source = emitter->source;
+    uint32_t at = ts_node_start_byte(node) + 1, end = ts_node_end_byte(node) - 1;
+    while (at < end) {
+        while (at < end && (markdoc_is_space(source[at]) || source[at] == ',')) {
+            at++;
+        }
+        uint32_t key = at;
+        while (at < end && (markdoc_is_identifier_char(source[at]) || source[at] == '-')) {
+            at++;
+        }
+        if (at == key || at == end || source[at] != '=') {
+            while (at < end && !markdoc_is_space(source[at])) {
+                at++;
+            }
+            continue;
+        }
+        uint32_t key_end = at++;
+        uint32_t value = at;
+        if (at < end && (source[at] == '"' || source[at] == '\'')) {
+            char quote = source[at++];
+            while (at < end && source[at] != quote) {
+                at += source[at] == '\\' ? 2 : 1;
+            }
+            at = at < end ? at + 1 : end;
+        } else {
+            while (at < end && !markdoc_is_space(source[at]) && source[at] != ',') {
+                at++;
+            }
+        }
+
+        separate(emitter, first);
+        write_node_string(emitter, key, key_end);
+        markdoc_output_char(&emitter->output, ':');
+        uint32_t length = at - value;
+        const char *text = source + value;
+        bool literal = (length == 4 && memcmp(text, "true", 4) == 0) ||
+                       (length == 5 && memcmp(text, "false", 5) == 0) ||
+                       (length == 4 && memcmp(text, "null", 4) == 0);
+        bool number = length > 0;
+        for (uint32_t i = 0; i < length; i++) {
+            char c = text[i];
+            if (!((c >= '0' && c <= '9') || (i == 0 && c == '-' && length > 1))) {
+                number = false;
+            }
+        }
+        if (literal || (number && !(text[text[0] == '-'] == '0' && length > 1u + (text[0] == '-')))) {
+            markdoc_output_write(&emitter->output, text, length);
+        } else if (length >= 2 && (text[0] == '"' || text[0] == '\'')) {
+            write_node_string(emitter, value + 1, at - 1);
+        } else {
+            write_node_string(emitter, value, at);
+        }
+    }
+}
+
+static void write_fence(Emitter *emitter, TSTreeCursor *cursor, bool *first) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    begin_node(emitter, first, ts_node_start_point(node), ts_node_end_point(node), false, NULL);
+
+    TSNode open = ts_node_child_by_field_id(node, MARKDOC_FIELD_OPEN);
+    TSNode code = ts_node_child_by_field_id(node, MARKDOC_FIELD_CODE);
+    TSNode close = ts_node_child_by_field_id(node, MARKDOC_FIELD_CLOSE);
+    bool first_attribute = true;
+    write_key(emitter, &first_attribute, "content");
+    if (ts_node_is_null(code)) {
+        write_raw(emitter, "\"\"");
+    } else {
+        uint32_t end = ts_node_is_null(close) ? ts_node_end_byte(code) : ts_node_start_byte(close);
+        write_node_string(emitter, ts_node_start_byte(code), end);
+    }
+
+    TSNode info = ts_node_named_child(open, 0);
+    if (!ts_node_is_null(info) && ts_node_symbol(info) == MARKDOC_SYM_INFO_STRING) {
+        uint32_t count = ts_node_named_child_count(info);
+        for (uint32_t i = 0; i < count; i++) {
+            TSNode child = ts_node_named_child(info, i);
+            if (ts_node_symbol(child) == MARKDOC_SYM_LANGUAGE) {
+                write_key(emitter, &first_attribute, "language");
+                write_node_string(emitter, ts_node_start_byte(child), ts_node_end_byte(child));
+            } else if (ts_node_symbol(child) == MARKDOC_SYM_ATTRIBUTES) {
+                write_info_attributes(emitter, &first_attribute, child);
+            }
+        }
+    }
+    begin_children(emitter);
+    end_node(emitter, "fence", NULL, 0);
+}
+
+// Writes the block under the cursor; anything that is not a block, such as
+// a tag's open and close lines, writes nothing.
+// The start of the line after the one at `line`, or `end`.
+static uint32_t next_line(const char *source, uint32_t line, uint32_t end) {
+    const char *newline = memchr(source + line, '\n', end - line);
+    return newline != NULL ? (uint32_t)(newline - source) + 1 : end;
+}
+
+// The text of the line at `line`, without its indentation, trailing space,
+// and with `quoted`, its `>` marker.
+static void line_text(const char *source, uint32_t line, uint32_t end, bool quoted,
+                      uint32_t *text_start, uint32_t *text_end) {
+    *text_start = line + (quoted && line < end && source[line] == '>');
+    *text_end = next_line(source, line, end);
+    trim(source, text_start, text_end);
+}
+
+// Writes the lines of [start, end), the first of them on `row`, as
+// paragraphs separated by blank lines, with a softbreak between the lines of
+// one. This is how markdown-it reads the lines of a blockquote, which the
+// grammar lexes as one token, and those of an HTML block, since Markdoc
+// turns markdown-it's HTML parsing off. `quoted` strips the `>` markers.
+static void write_line_paragraphs(Emitter *emitter, bool *first, uint32_t row, uint32_t start,
+                                  uint32_t end, bool quoted) {
+    const char *source = emitter->source;
+    uint32_t text_start, text_end;
+    for (uint32_t line = start; line < end;) {
+        line_text(source, line, end, quoted, &text_start, &text_end);
+        if (text_start == text_end) {
+            line = next_line(source, line, end);
+            row++;
+            continue;
+        }
+        uint32_t rows = 0;
+        for (uint32_t run = line; run < end; rows++) {
+            line_text(source, run, end, quoted, &text_start, &text_end);
+            if (text_start == text_end) {
+                break;
+            }
+            run = next_line(source, run, end);
+        }
+
+        bool first_child = true, first_inline = true;
+        TSPoint start_point = {row, 0}, end_point = {row + rows, 0};
+        begin_node(emitter, first, start_point, end_point, false, NULL);
+        begin_children(emitter);
+        begin_node(emitter, &first_child, start_point, end_point, true, NULL);
+        begin_children(emitter);
+        for (uint32_t i = 0; i < rows; i++, row++) {
+            TSPoint line_start = {row, 0}, line_end = {row, 1};
+            if (i > 0) {
+                begin_node(emitter, &first_inline, (TSPoint){row - 1, 1}, line_end, true, NULL);
+                begin_children(emitter);
+                end_node(emitter, "softbreak", NULL, 0);
+            }
+            line_text(source, line, end, quoted, &text_start, &text_end);
+            write_inline_text(emitter, &first_inline, line_start, line_end, text_start, text_end);
+            line = next_line(source, line, end);
+        }
+        end_node(emitter, "inline", NULL, 0);
+        end_node(emitter, "paragraph", NULL, 0);
+    }
+}
+
+static void write_block(Emitter *emitter, TSTreeCursor *cursor, bool *first) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    TSPoint start_point = ts_node_start_point(node), end_point = ts_node_end_point(node);
+    uint32_t start = ts_node_start_byte(node), end = ts_node_end_byte(node);
+    bool first_attribute = true, first_child = true;
+
+    switch (ts_node_symbol(node)) {
+        case MARKDOC_SYM_HEADING: {
+            TSNode marker = ts_node_child_by_field_id(node, MARKDOC_FIELD_HEADING_MARKER);
+            TSNode text = ts_node_child_by_field_id(node, MARKDOC_FIELD_HEADING_TEXT);
+            uint32_t level = 0;
+            for (uint32_t i = ts_node_start_byte(marker); i < ts_node_end_byte(marker); i++) {
+                level += emitter->source[i] == '#';
+            }
+            begin_node(emitter, first, start_point, end_point, false, NULL);
+            write_key(emitter, &first_attribute, "level");
+            write_uint(emitter, level);
+            begin_children(emitter);
+            begin_node(emitter, &first_child, start_point, end_point, true, NULL);
+            begin_children(emitter);
+            if (!ts_node_is_null(text)) {
+                uint32_t text_start = ts_node_start_byte(text), text_end = ts_node_end_byte(text);
+                trim(emitter->source, &text_start, &text_end);
+                bool first_inline = true;
+                write_inline_text(emitter, &first_inline, ts_node_start_point(text),
+                                  ts_node_end_point(text), text_start, text_end);
+            }
+            end_node(emitter, "inline", NULL, 0);
+            end_node(emitter, "heading", NULL, 0);
+            break;
+        }
+        case MARKDOC_SYM_PARAGRAPH:
+            begin_node(emitter, first, start_point, end_point, false, NULL);
+            begin_children(emitter);
+            write_inline_container(emitter, cursor, &first_child);
+            end_node(emitter, "paragraph", NULL, 0);
+            break;
+        case MARKDOC_SYM_HTML_BLOCK:
+        case MARKDOC_SYM_HTML_COMMENT:
+            write_line_paragraphs(emitter, first, start_point.row, start, end, false);
+            break;
+        case MARKDOC_SYM_THEMATIC_BREAK:
+            begin_node(emitter, first, start_point, end_point, false, NULL);
+            begin_children(emitter);
+            end_node(emitter, "hr", NULL, 0);
+            break;
+        case MARKDOC_SYM_BLOCKQUOTE:
+            begin_node(emitter, first, start_point, end_point, false, NULL);
+            begin_children(emitter);
+            write_line_paragraphs(emitter, &first_child, start_point.row, start, end, true);
+            end_node(emitter, "blockquote", NULL, 0);
+            break;
+        case MARKDOC_SYM_FENCED_CODE_BLOCK:
+            write_fence(emitter, cursor, first);
+            break;
+        case MARKDOC_SYM_MARKDOC_TAG:
+            if (ts_node_named_child_count(node) == 1) {
+                // A self-closing tag line, aliased to tag_self_close.
+                ts_tree_cursor_goto_first_child(cursor);
+                write_tag(emitter, cursor, first, false);
+                ts_tree_cursor_goto_parent(cursor);
+            } else {
+                write_tag(emitter, cursor, first, false);
+            }
+            break;
+        case MARKDOC_SYM_UNORDERED_LIST:
+        case MARKDOC_SYM_ORDERED_LIST:
+            write_list(emitter, cursor, first, ts_node_symbol(node) == MARKDOC_SYM_ORDERED_LIST);
+            break;
+        case MARKDOC_SYM_ERROR:
+            write_error(emitter, first, node, false);
+            break;
+        default:
+            break;
+    }
+}
+
+static void write_blocks(Emitter *emitter, TSTreeCursor *cursor, bool *first) {
+    if (!ts_tree_cursor_goto_first_child(cursor)) {
+        return;
+    }
+    do {
+        write_block(emitter, cursor, first);
+    } while (ts_tree_cursor_goto_next_sibling(cursor));
+    ts_tree_cursor_goto_parent(cursor);
+}
+
+bool markdoc_ast_write_json(TSNode node, const char *source, MarkdocWriter writer) {
+    if (ts_node_is_null(node) || !markdoc_symbols_match(ts_node_language(node))) {
+        return false;
+    }
+    Emitter *emitter = malloc(sizeof(Emitter));
+    if (emitter == NULL) {
+        return false;
+    }
+    markdoc_output_init(&emitter->output, writer);
+    emitter->source = source;
+
+    bool first = true, first_attribute = true, first_child = true;
+    begin_node(emitter, &first, ts_node_start_point(node), ts_node_end_point(node), false, NULL);
+    TSNode frontmatter = ts_node_named_child(node, 0);
+    if (ts_node_symbol(frontmatter) == MARKDOC_SYM_FRONTMATTER) {
+        TSNode yaml = ts_node_named_child(frontmatter, 0);
+        write_key(emitter, &first_attribute, "frontmatter");
+        if (ts_node_is_null(yaml)) {
+            write_raw(emitter, "\"\"");
+        } else {
+            uint32_t start = ts_node_start_byte(yaml), end = ts_node_end_byte(yaml);
+            if (end > start && source[end - 1] == '\n') {
+                end--;
+            }
+            if (end > start && source[end - 1] == '\r') {
+                end--;
+            }
+            write_node_string(emitter, start, end);
+        }
+    }
+    begin_children(emitter);
+    TSTreeCursor cursor = ts_tree_cursor_new(node);
+    write_blocks(emitter, &cursor, &first_child);
+    ts_tree_cursor_delete(&cursor);
+    end_node(emitter, "document", NULL, 0);
+
+    markdoc_output_flush(&emitter->output);
+    bool ok = !emitter->output.failed;
+    free(emitter);
+    return ok;
+}
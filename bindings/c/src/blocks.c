@@ -0,0 +1,224 @@
+#include "tree_sitter/markdoc/blocks.h"
+
+#include <stdlib.h>
+
+#include "incremental.h"
+#include "murmur.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+typedef struct {
+    // The hashes being updated, or NULL for a build, which walks everything.
+    const MarkdocBlockHashes *old;
+    const TSRange *changed;
+    uint32_t changed_count;
+    const char *source;
+    MarkdocBlock *blocks;
+    uint32_t count;
+    uint32_t capacity;
+} Walk;
+
+static bool push_block(Walk *walk, MarkdocBlock block) {
+    if (walk->count == walk->capacity) {
+        uint32_t capacity = walk->capacity ? walk->capacity * 2 : 16;
+        MarkdocBlock *grown = realloc(walk->blocks, capacity * sizeof(MarkdocBlock));
+        if (grown == NULL) {
+            return false;
+        }
+        walk->blocks = grown;
+        walk->capacity = capacity;
+    }
+    walk->blocks[walk->count++] = block;
+    return true;
+}
+
+// Whether [start, end) may differ from what the old hashes saw.
+static bool is_dirty(const Walk *walk, uint32_t start, uint32_t end) {
+    return walk->old == NULL ||
+           markdoc_is_dirty(walk->changed, walk->changed_count, walk->old->edited,
+                            walk->old->edited_count, start, end);
+}
+
+// The first old block starting at or after `start`.
+static uint32_t first_old_block(const Walk *walk, uint32_t start) {
+    return MARKDOC_FIRST_STARTING_AT(MarkdocBlock, walk->old->blocks, walk->old->count, start);
+}
+
+// Copies the old blocks that start in [start, end), unchanged. Those nested
+// in a copied block point at its new index; the others at `parent`.
+static bool keep_blocks(Walk *walk, uint32_t start, uint32_t end, uint32_t parent) {
+    const MarkdocBlock *blocks = walk->old->blocks;
+    uint32_t first = first_old_block(walk, start), offset = walk->count;
+    for (uint32_t i = first; i < walk->old->count && blocks[i].start_byte < end; i++) {
+        MarkdocBlock block = blocks[i];
+        block.parent = block.parent != MARKDOC_BLOCK_NONE && block.parent >= first
+                           ? block.parent - first + offset
+                           : parent;
+        block.changed = false;
+        if (!push_block(walk, block)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Folds `data` into a running 128-bit hash.
+static void hash_update(uint64_t hash[2], const void *data, size_t length) {
+    murmur3_128(data, length, hash[0] ^ rotl64(hash[1], 17), hash);
+}
+
+// Hashes the block at `index`, whose nested blocks are all after it: its
+// symbol, then its bytes, with each block nested directly in it standing in
+// by its hash for its bytes.
+static void hash_block(Walk *walk, uint32_t index) {
+    MarkdocBlock *block = &walk->blocks[index];
+    uint64_t hash[2] = {block->symbol, 0};
+    uint32_t at = block->start_byte;
+    for (uint32_t i = index + 1; i < walk->count; i++) {
+        const MarkdocBlock *nested = &walk->blocks[i];
+        if (nested->parent == index) {
+            hash_update(hash, walk->source + at, nested->start_byte - at);
+            hash_update(hash, nested->hash, sizeof(nested->hash));
+            at = nested->end_byte;
+        }
+    }
+    hash_update(hash, walk->source + at, block->end_byte - at);
+    block->hash[0] = hash[0];
+    block->hash[1] = hash[1];
+}
+
+// Nodes whose children can be markdoc_tags.
+static bool is_container(TSSymbol symbol) {
+    switch (symbol) {
+        case MARKDOC_SYM_MARKDOC_TAG:
+        case MARKDOC_SYM_BLOCKQUOTE:
+        case MARKDOC_SYM_UNORDERED_LIST:
+        case MARKDOC_SYM_ORDERED_LIST:
+        case MARKDOC_SYM_UNORDERED_LIST_ITEM:
+        case MARKDOC_SYM_ORDERED_LIST_ITEM:
+        case MARKDOC_SYM_LIST_ITEM_CONTINUATION:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// `parent` is the index of the block the node under the cursor is in, and
+// `top_level` says the node is a child of the root.
+static bool visit(Walk *walk, TSTreeCursor *cursor, uint32_t parent, bool top_level) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    TSSymbol symbol = ts_node_symbol(node);
+    bool is_block = (top_level && ts_node_is_named(node)) || symbol == MARKDOC_SYM_MARKDOC_TAG;
+    if (!is_block && !is_container(symbol)) {
+        return true;
+    }
+    uint32_t start = ts_node_start_byte(node), end = ts_node_end_byte(node);
+    if (!is_dirty(walk, start, end)) {
+        // A block is only kept if the old hashes have it, as they should.
+        uint32_t first = first_old_block(walk, start);
+        const MarkdocBlock *old = first < walk->old->count ? &walk->old->blocks[first] : NULL;
+        if (!is_block || (old != NULL && old->start_byte == start && old->end_byte == end &&
+                          old->symbol == symbol)) {
+            return keep_blocks(walk, start, end, parent);
+        }
+    }
+
+    uint32_t index = parent;
+    if (is_block) {
+        index = walk->count;
+        MarkdocBlock block = {
+            .start_byte = start,
+            .end_byte = end,
+            .symbol = symbol,
+            .parent = parent,
+            .changed = true,
+        };
+        if (!push_block(walk, block)) {
+            return false;
+        }
+    }
+
+    bool ok = true;
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            ok = visit(walk, cursor, index, false);
+        } while (ok && ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    if (ok && is_block) {
+        hash_block(walk, index);
+    }
+    return ok;
+}
+
+static bool run(Walk *walk, TSNode node) {
+    if (ts_node_is_null(node)) {
+        return true;
+    }
+    TSTreeCursor cursor = ts_tree_cursor_new(node);
+    bool ok = true;
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+        do {
+            ok = visit(walk, &cursor, MARKDOC_BLOCK_NONE, true);
+        } while (ok && ts_tree_cursor_goto_next_sibling(&cursor));
+    }
+    ts_tree_cursor_delete(&cursor);
+    return ok;
+}
+
+bool markdoc_block_hashes_build(TSNode node, const char *source, MarkdocBlockHashes *hashes) {
+    *hashes = (MarkdocBlockHashes){0};
+    if (!ts_node_is_null(node) && !markdoc_symbols_match(ts_node_language(node))) {
+        return false;
+    }
+    Walk walk = {.source = source};
+    // markdoc_block_hashes_edit() relies on room for one edited range.
+    uint32_t *edited = markdoc_edited_new();
+    if (edited == NULL || !run(&walk, node)) {
+        free(edited);
+        free(walk.blocks);
+        return false;
+    }
+    hashes->edited = edited;
+    hashes->edited_capacity = MARKDOC_EDITED_INITIAL_CAPACITY;
+    hashes->blocks = walk.blocks;
+    hashes->count = walk.count;
+    hashes->capacity = walk.capacity;
+    return true;
+}
+
+void markdoc_block_hashes_edit(MarkdocBlockHashes *hashes, const TSInputEdit *edit) {
+    for (uint32_t i = 0; i < hashes->count; i++) {
+        hashes->blocks[i].start_byte = markdoc_shift(hashes->blocks[i].start_byte, edit);
+        hashes->blocks[i].end_byte = markdoc_shift(hashes->blocks[i].end_byte, edit);
+    }
+    markdoc_edited_add(&hashes->edited, &hashes->edited_count, &hashes->edited_capacity, edit);
+}
+
+bool markdoc_block_hashes_update(MarkdocBlockHashes *hashes, TSNode node, const char *source,
+                                 const TSRange *changed, uint32_t changed_count) {
+    if (!ts_node_is_null(node) && !markdoc_symbols_match(ts_node_language(node))) {
+        return false;
+    }
+    Walk walk = {
+        .old = hashes,
+        .changed = changed,
+        .changed_count = changed_count,
+        .source = source,
+    };
+    if (!run(&walk, node)) {
+        free(walk.blocks);
+        return false;
+    }
+    free(hashes->blocks);
+    hashes->blocks = walk.blocks;
+    hashes->count = walk.count;
+    hashes->capacity = walk.capacity;
+    hashes->edited_count = 0;
+    return true;
+}
+
+void markdoc_block_hashes_delete(MarkdocBlockHashes *hashes) {
+    free(hashes->blocks);
+    free(hashes->edited);
+    *hashes = (MarkdocBlockHashes){0};
+}
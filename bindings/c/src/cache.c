@@ -0,0 +1,373 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/markdoc/cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#include <windows.h>
+#define make_directory(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#define make_directory(path) mkdir(path, 0777)
+#endif
+
+#include "murmur.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+static const uint8_t MAGIC[8] = {'M', 'D', 'O', 'C', 'F', 'L', 'A', 'T'};
+
+// Folds `data` into a running 128-bit hash.
+static void hash_update(uint64_t hash[2], const void *data, size_t length) {
+    murmur3_128(data, length, hash[0] ^ rotl64(hash[1], 17), hash);
+}
+
+MarkdocCacheKey markdoc_cache_key(const TSLanguage *language, const char *source,
+                                  uint32_t length) {
+    // The names below tell apart languages other than the one this library
+    // was built with; the grammar hash tells apart builds of this one.
+    uint64_t fingerprint[2] = {MARKDOC_CACHE_VERSION, MARKDOC_SYMBOLS_GRAMMAR_HASH};
+    uint32_t header[4] = {
+        ts_language_abi_version(language),
+        ts_language_state_count(language),
+        ts_language_symbol_count(language),
+        ts_language_field_count(language),
+    };
+    hash_update(fingerprint, header, sizeof(header));
+    for (uint32_t i = 0; i < header[2]; i++) {
+        const char *name = ts_language_symbol_name(language, (TSSymbol)i);
+        uint8_t type = (uint8_t)ts_language_symbol_type(language, (TSSymbol)i);
+        hash_update(fingerprint, name, name ? strlen(name) + 1 : 0);
+        hash_update(fingerprint, &type, 1);
+    }
+    for (uint32_t i = 1; i <= header[3]; i++) {
+        const char *name = ts_language_field_name_for_id(language, (TSFieldId)i);
+        hash_update(fingerprint, name, name ? strlen(name) + 1 : 0);
+    }
+
+    uint64_t hash[2];
+    murmur3_128(source, length, 0, hash);
+    hash[0] = fmix64(hash[0] ^ fingerprint[0]);
+    hash[1] = fmix64(hash[1] ^ fingerprint[1] ^ hash[0]);
+
+    MarkdocCacheKey key;
+    memcpy(key.bytes, hash, sizeof(key.bytes));
+    return key;
+}
+
+static inline uint8_t *put_varint(uint8_t *out, uint64_t value) {
+    while (value >= 0x80) {
+        *out++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (uint8_t)value;
+    return out;
+}
+
+static inline bool get_varint(const uint8_t **in, const uint8_t *end, uint64_t *value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64 && *in < end; shift += 7) {
+        uint8_t byte = *(*in)++;
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline uint64_t zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t unzigzag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+// The longest encoding of one node: three 32-bit and two 16-bit varints.
+#define MAX_NODE_BYTES (3 * 5 + 2 * 3)
+
+uint8_t *markdoc_flat_tree_encode(const MarkdocFlatTree *flat, const MarkdocCacheKey *key,
+                                  size_t *size) {
+    size_t capacity = sizeof(MAGIC) + 1 + sizeof(key->bytes) + 5 +
+                      (size_t)flat->node_count * MAX_NODE_BYTES;
+    uint8_t *data = malloc(capacity);
+    if (data == NULL) {
+        return NULL;
+    }
+
+    uint8_t *out = data;
+    memcpy(out, MAGIC, sizeof(MAGIC));
+    out += sizeof(MAGIC);
+    *out++ = MARKDOC_CACHE_VERSION;
+    memcpy(out, key->bytes, sizeof(key->bytes));
+    out += sizeof(key->bytes);
+    out = put_varint(out, flat->node_count);
+
+    uint32_t previous_start = 0;
+    for (uint32_t i = 0; i < flat->node_count; i++) {
+        uint32_t child_count = 0;
+        for (uint32_t child = flat->first_children[i]; child != MARKDOC_FLAT_NONE;
+             child = flat->next_siblings[child]) {
+            child_count++;
+        }
+        uint32_t start = flat->start_bytes[i];
+        out = put_varint(out, flat->symbols[i]);
+        out = put_varint(out, flat->field_ids[i]);
+        out = put_varint(out, child_count);
+        out = put_varint(out, zigzag((int64_t)start - (int64_t)previous_start));
+        out = put_varint(out, flat->end_bytes[i] - start);
+        previous_start = start;
+    }
+
+    *size = (size_t)(out - data);
+    uint8_t *shrunk = realloc(data, *size);
+    return shrunk != NULL ? shrunk : data;
+}
+
+// An ancestor whose children are still being decoded.
+typedef struct {
+    uint32_t index;
+    uint32_t remaining;
+    uint32_t last_child;
+} OpenNode;
+
+static bool decode_nodes(const uint8_t *in, const uint8_t *end, MarkdocFlatTree *flat,
+                         OpenNode *stack) {
+    uint32_t depth = 0;
+    int64_t previous_start = 0;
+    for (uint32_t i = 0; i < flat->node_count; i++) {
+        uint64_t symbol, field, child_count, start_delta, length;
+        if (!get_varint(&in, end, &symbol) || !get_varint(&in, end, &field) ||
+            !get_varint(&in, end, &child_count) || !get_varint(&in, end, &start_delta) ||
+            !get_varint(&in, end, &length)) {
+            return false;
+        }
+        int64_t start = previous_start + unzigzag(start_delta);
+        if (symbol > UINT16_MAX || field > UINT16_MAX || child_count >= flat->node_count ||
+            start < 0 || (uint64_t)start + length > UINT32_MAX || (i > 0) != (depth > 0)) {
+            return false;
+        }
+        previous_start = start;
+
+        flat->symbols[i] = (TSSymbol)symbol;
+        flat->field_ids[i] = (TSFieldId)field;
+        flat->start_bytes[i] = (uint32_t)start;
+        flat->end_bytes[i] = (uint32_t)(start + (int64_t)length);
+        flat->first_children[i] = MARKDOC_FLAT_NONE;
+        flat->next_siblings[i] = MARKDOC_FLAT_NONE;
+        flat->parents[i] = MARKDOC_FLAT_NONE;
+
+        if (depth > 0) {
+            OpenNode *parent = &stack[depth - 1];
+            flat->parents[i] = parent->index;
+            if (parent->last_child == MARKDOC_FLAT_NONE) {
+                flat->first_children[parent->index] = i;
+            } else {
+                flat->next_siblings[parent->last_child] = i;
+            }
+            parent->last_child = i;
+            if (--parent->remaining == 0) {
+                depth--;
+            }
+        }
+        if (child_count > 0) {
+            stack[depth++] = (OpenNode){i, (uint32_t)child_count, MARKDOC_FLAT_NONE};
+        }
+    }
+    return depth == 0 && in == end;
+}
+
+bool markdoc_flat_tree_decode(const uint8_t *data, size_t size, const MarkdocCacheKey *key,
+                              MarkdocFlatTree *flat) {
+    *flat = (MarkdocFlatTree){0};
+    const uint8_t *in = data;
+    const uint8_t *end = data + size;
+    size_t header_size = sizeof(MAGIC) + 1 + sizeof(key->bytes);
+    if (size < header_size || memcmp(in, MAGIC, sizeof(MAGIC)) != 0 ||
+        in[sizeof(MAGIC)] != MARKDOC_CACHE_VERSION ||
+        memcmp(in + sizeof(MAGIC) + 1, key->bytes, sizeof(key->bytes)) != 0) {
+        return false;
+    }
+    in += header_size;
+
+    uint64_t node_count;
+    // Every node takes at least five bytes, which bounds the allocation by
+    // the input size.
+    if (!get_varint(&in, end, &node_count) || node_count > (size_t)(end - in) / 5) {
+        return false;
+    }
+    if (node_count == 0) {
+        return in == end;
+    }
+
+    size_t count = (size_t)node_count;
+    size_t wide = count * sizeof(uint32_t);
+    char *block = malloc(5 * wide + count * (sizeof(TSSymbol) + sizeof(TSFieldId)));
+    OpenNode *stack = malloc(count * sizeof(OpenNode));
+    if (block == NULL || stack == NULL) {
+        free(block);
+        free(stack);
+        return false;
+    }
+    // Same layout as markdoc_flat_tree_export(), so markdoc_flat_tree_delete()
+    // frees it.
+    flat->node_count = (uint32_t)count;
+    flat->start_bytes = (uint32_t *)block;
+    flat->end_bytes = (uint32_t *)(block + wide);
+    flat->parents = (uint32_t *)(block + 2 * wide);
+    flat->first_children = (uint32_t *)(block + 3 * wide);
+    flat->next_siblings = (uint32_t *)(block + 4 * wide);
+    flat->symbols = (TSSymbol *)(block + 5 * wide);
+    flat->field_ids = (TSFieldId *)(block + 5 * wide + count * sizeof(TSSymbol));
+
+    bool ok = decode_nodes(in, end, flat, stack);
+    free(stack);
+    if (!ok) {
+        markdoc_flat_tree_delete(flat);
+    }
+    return ok;
+}
+
+// Entries live at <directory>/<first two hex digits>/<remaining 30>, like
+// git objects, to keep directories small.
+static char *entry_path(const char *directory, const MarkdocCacheKey *key) {
+    static const char HEX[] = "0123456789abcdef";
+    size_t length = strlen(directory);
+    char *path = malloc(length + 1 + 2 + 1 + 30 + 1);
+    if (path == NULL) {
+        return NULL;
+    }
+    char *out = path + length;
+    memcpy(path, directory, length);
+    *out++ = '/';
+    for (size_t i = 0; i < sizeof(key->bytes); i++) {
+        *out++ = HEX[key->bytes[i] >> 4];
+        *out++ = HEX[key->bytes[i] & 15];
+        if (i == 0) {
+            *out++ = '/';
+        }
+    }
+    *out = '\0';
+    return path;
+}
+
+bool markdoc_cache_load(const char *directory, const MarkdocCacheKey *key,
+                        MarkdocFlatTree *flat) {
+    *flat = (MarkdocFlatTree){0};
+    char *path = entry_path(directory, key);
+    FILE *file = path ? fopen(path, "rb") : NULL;
+    free(path);
+    if (file == NULL) {
+        return false;
+    }
+
+    bool ok = false;
+    uint8_t *data = NULL;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        long size = ftell(file);
+        if (size > 0 && fseek(file, 0, SEEK_SET) == 0 && (data = malloc((size_t)size)) != NULL &&
+            fread(data, 1, (size_t)size, file) == (size_t)size) {
+            ok = markdoc_flat_tree_decode(data, (size_t)size, key, flat);
+        }
+    }
+    free(data);
+    fclose(file);
+    return ok;
+}
+
+// Creates and opens a temporary file next to `path` that no other thread or
+// process has open, and writes its name to `temporary`.
+static FILE *open_temporary(char *temporary, size_t size, const char *path) {
+#ifdef _WIN32
+    // A process and thread ID pair is unique among running threads, and
+    // "x" refuses a file left behind by one that has exited.
+    snprintf(temporary, size, "%s.%lu.%lu.tmp", path, (unsigned long)_getpid(),
+             (unsigned long)GetCurrentThreadId());
+    return fopen(temporary, "wbx");
+#else
+    snprintf(temporary, size, "%s.XXXXXX", path);
+    int fd = mkstemp(temporary);
+    if (fd < 0) {
+        return NULL;
+    }
+    // mkstemp() creates the file readable by its owner only; entries are
+    // read by every build sharing the directory.
+    FILE *file = fchmod(fd, 0644) == 0 ? fdopen(fd, "wb") : NULL;
+    if (file == NULL) {
+        close(fd);
+        remove(temporary);
+    }
+    return file;
+#endif
+}
+
+bool markdoc_cache_store(const char *directory, const MarkdocCacheKey *key,
+                         const MarkdocFlatTree *flat) {
+    char *path = entry_path(directory, key);
+    if (path == NULL) {
+        return false;
+    }
+    size_t length = strlen(path);
+    char *temporary = malloc(length + 32);
+    size_t size = 0;
+    uint8_t *data = temporary ? markdoc_flat_tree_encode(flat, key, &size) : NULL;
+    bool ok = false;
+    if (data != NULL) {
+        // Create the cache directory and the fan-out directory; both may
+        // already exist.
+        make_directory(directory);
+        path[length - 31] = '\0';
+        make_directory(path);
+        path[length - 31] = '/';
+
+        FILE *file = open_temporary(temporary, length + 32, path);
+        if (file != NULL) {
+            ok = fwrite(data, 1, size, file) == size;
+            ok = fclose(file) == 0 && ok;
+#ifdef _WIN32
+            ok = ok && MoveFileExA(temporary, path, MOVEFILE_REPLACE_EXISTING);
+#else
+            ok = ok && rename(temporary, path) == 0;
+#endif
+            if (!ok) {
+                remove(temporary);
+            }
+        }
+    }
+    free(data);
+    free(temporary);
+    free(path);
+    return ok;
+}
+
+bool markdoc_cache_parse(const char *directory, TSParser *parser, const char *source,
+                         uint32_t length, MarkdocFlatTree *flat, bool *hit) {
+    MarkdocCacheKey key = markdoc_cache_key(ts_parser_language(parser), source, length);
+    if (markdoc_cache_load(directory, &key, flat)) {
+        if (hit != NULL) {
+            *hit = true;
+        }
+        return true;
+    }
+    if (hit != NULL) {
+        *hit = false;
+    }
+
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+    if (tree == NULL) {
+        return false;
+    }
+    bool ok = markdoc_flat_tree_export(ts_tree_root_node(tree), flat);
+    ts_tree_delete(tree);
+    if (ok) {
+        markdoc_cache_store(directory, &key, flat);
+    }
+    return ok;
+}
@@ -0,0 +1,372 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/markdoc/chunked.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "lines.h"
+#include "scanner.h"
+#include "tree_sitter/markdoc/prescan.h"
+
+#define DEFAULT_CHUNK_SIZE (4u * 1024 * 1024)
+
+struct MarkdocChunkedTree {
+    TSRange *ranges;
+    TSTree **trees;
+    uint32_t chunk_count;
+    // first_block[i] is the document-wide index of chunk i's first block;
+    // first_block[chunk_count] is the total.
+    uint32_t *first_block;
+};
+
+typedef struct {
+    TSRange *items;
+    uint32_t size;
+    uint32_t capacity;
+} RangeList;
+
+static bool range_list_push(RangeList *list, TSRange range) {
+    if (list->size == list->capacity) {
+        uint32_t capacity = list->capacity ? list->capacity * 2 : 16;
+        TSRange *items = realloc(list->items, capacity * sizeof(TSRange));
+        if (items == NULL) {
+            return false;
+        }
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->size++] = range;
+    return true;
+}
+
+// Block nesting at the start of a line. A blank line is a safe split point
+// only when nothing is open.
+typedef struct {
+    bool in_frontmatter;
+    bool in_html_comment;
+    // The end of the comment_block token the last `{% comment %}` line
+    // started, or NULL.
+    const char *comment_end;
+    uint32_t tag_depth;
+    uint8_t fence_depth;
+    char fence_chars[MAX_FENCE_DEPTH];
+    uint32_t fence_lengths[MAX_FENCE_DEPTH];
+} SplitState;
+
+static bool contains(const char *start, const char *end, const char *needle, size_t length) {
+    for (const char *c = start; c + length <= end; c++) {
+        if (memcmp(c, needle, length) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool is_space_or_newline(char c) {
+    return markdoc_is_space(c) || c == '\n' || c == '\r';
+}
+
+// The end of the last `{% /comment %}` in [start, end), or NULL. The
+// grammar's comment_block is one greedy token, so it runs from a
+// `{% comment %}` line to the last of these in the document, across any
+// comment blocks in between.
+static const char *last_comment_close(const char *start, const char *end) {
+    for (const char *c = end - 1; c > start; c--) {
+        if (c[0] != '}' || c[-1] != '%') {
+            continue;
+        }
+        const char *p = c - 2;
+        while (p >= start && is_space_or_newline(*p)) {
+            p--;
+        }
+        if (p - start < 8 || memcmp(p - 7, "/comment", 8) != 0) {
+            continue;
+        }
+        p -= 8;
+        while (p >= start && is_space_or_newline(*p)) {
+            p--;
+        }
+        if (p - start >= 1 && p[-1] == '{' && p[0] == '%') {
+            return c + 1;
+        }
+    }
+    return NULL;
+}
+
+// Updates `state` for one non-blank line with the given prescan flags,
+// following the scanner: fences nest when a longer fence opens inside one,
+// tag lines count only outside fences.
+static void split_state_advance(SplitState *state, const char *line, const char *eol,
+                                const char *end, uint8_t flags) {
+    if (state->comment_end != NULL && line < state->comment_end) {
+        return;
+    }
+    if (state->in_frontmatter) {
+        state->in_frontmatter = !(flags & MARKDOC_LINE_DELIMITER);
+        return;
+    }
+
+    char fence_char;
+    uint32_t fence_length;
+    if (state->fence_depth > 0) {
+        if (!(flags & MARKDOC_LINE_FENCE)) {
+            return;
+        }
+        uint8_t top = state->fence_depth - 1;
+        if (markdoc_line_closes_fence(line, eol, state->fence_chars[top],
+                                      state->fence_lengths[top])) {
+            state->fence_depth--;
+        } else if (markdoc_line_fence(line, eol, &fence_char, &fence_length) &&
+                   fence_length > state->fence_lengths[top] &&
+                   state->fence_depth < MAX_FENCE_DEPTH) {
+            state->fence_chars[state->fence_depth] = fence_char;
+            state->fence_lengths[state->fence_depth] = fence_length;
+            state->fence_depth++;
+        }
+        return;
+    }
+
+    if (state->in_html_comment) {
+        state->in_html_comment = !contains(line, eol, "-->", 3);
+        return;
+    }
+
+    if ((flags & MARKDOC_LINE_FENCE) &&
+        markdoc_line_fence(line, eol, &fence_char, &fence_length)) {
+        state->fence_chars[0] = fence_char;
+        state->fence_lengths[0] = fence_length;
+        state->fence_depth = 1;
+    } else if (flags & MARKDOC_LINE_COMMENT_OPEN) {
+        // Without a close anywhere after it, the line opens a plain tag.
+        state->comment_end = last_comment_close(eol, end);
+        state->tag_depth += state->comment_end == NULL;
+    } else if (flags & MARKDOC_LINE_TAG_OPEN) {
+        state->tag_depth++;
+    } else if (flags & MARKDOC_LINE_TAG_CLOSE) {
+        if (state->tag_depth > 0) {
+            state->tag_depth--;
+        }
+    } else if (flags & MARKDOC_LINE_HTML_COMMENT) {
+        const char *comment = line;
+        while (markdoc_is_space(*comment)) {
+            comment++;
+        }
+        state->in_html_comment = !contains(comment + 4, eol, "-->", 3);
+    }
+}
+
+TSRange *markdoc_split_chunks(const char *source, uint32_t length, uint32_t target_size,
+                              uint32_t *count) {
+    MarkdocLineIndex index;
+    if (!markdoc_prescan(source, length, &index)) {
+        return NULL;
+    }
+
+    const char *end = source + length;
+    RangeList ranges = {0};
+    SplitState state = {0};
+    TSRange current = {.start_byte = 0};
+    bool after_blank = false;
+
+    for (uint32_t row = 0; row < index.line_count; row++) {
+        uint32_t offset = index.line_starts[row];
+        uint8_t flags = index.line_flags[row];
+        const char *line = source + offset;
+        const char *next = row + 1 < index.line_count ? source + index.line_starts[row + 1] : end;
+        bool blank = flags & MARKDOC_LINE_BLANK;
+
+        // An indented line after a blank line may continue a list item, so
+        // only a line that starts at column 0 can start a chunk.
+        bool at_top_level = !state.in_frontmatter && !state.in_html_comment &&
+                            (state.comment_end == NULL || line >= state.comment_end) &&
+                            state.fence_depth == 0 && state.tag_depth == 0 &&
+                            !markdoc_is_space(*line);
+        if (after_blank && !blank && at_top_level &&
+            offset - current.start_byte >= target_size && !(flags & MARKDOC_LINE_DELIMITER)) {
+            current.end_byte = offset;
+            current.end_point = (TSPoint){row, 0};
+            if (!range_list_push(&ranges, current)) {
+                free(ranges.items);
+                markdoc_line_index_delete(&index);
+                return NULL;
+            }
+            current = (TSRange){.start_byte = offset, .start_point = {row, 0}};
+        }
+
+        if (row == 0 && (flags & MARKDOC_LINE_DELIMITER)) {
+            state.in_frontmatter = true;
+        } else if (!blank) {
+            split_state_advance(&state, line, markdoc_line_end(line, next), end, flags);
+        }
+        after_blank = blank && !state.in_frontmatter;
+    }
+
+    // The last range ends at the end of the input, which may be mid-line or,
+    // after a trailing line break, at the start of a row with no line.
+    uint32_t last_row = index.line_count > 0 ? index.line_count - 1 : 0;
+    uint32_t last_start = index.line_count > 0 ? index.line_starts[last_row] : 0;
+    current.end_byte = length;
+    current.end_point = (TSPoint){last_row, length - last_start};
+    if (length > 0 && end[-1] == '\n') {
+        current.end_point = (TSPoint){index.line_count, 0};
+    }
+    markdoc_line_index_delete(&index);
+    if (!range_list_push(&ranges, current)) {
+        free(ranges.items);
+        return NULL;
+    }
+
+    *count = ranges.size;
+    return ranges.items;
+}
+
+typedef struct {
+    const TSLanguage *language;
+    const char *source;
+    uint32_t length;
+    MarkdocChunkedTree *tree;
+    pthread_mutex_t lock;
+    uint32_t next_chunk;
+} ParseJob;
+
+static void *parse_chunks(void *payload) {
+    ParseJob *job = payload;
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, job->language);
+
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        uint32_t chunk = job->next_chunk++;
+        pthread_mutex_unlock(&job->lock);
+        if (chunk >= job->tree->chunk_count) {
+            break;
+        }
+        // A chunk left without a tree fails the whole parse.
+        if (ts_parser_set_included_ranges(parser, &job->tree->ranges[chunk], 1)) {
+            job->tree->trees[chunk] =
+                ts_parser_parse_string(parser, NULL, job->source, job->length);
+        }
+    }
+
+    ts_parser_delete(parser);
+    return NULL;
+}
+
+MarkdocChunkedTree *markdoc_parse_chunked(const TSLanguage *language, const char *source,
+                                          uint32_t length, const MarkdocChunkOptions *options) {
+    uint32_t target_size = options && options->target_chunk_size ? options->target_chunk_size
+                                                                  : DEFAULT_CHUNK_SIZE;
+    long thread_count = options && options->thread_count ? (long)options->thread_count
+                                                         : sysconf(_SC_NPROCESSORS_ONLN);
+
+    MarkdocChunkedTree *tree = calloc(1, sizeof(MarkdocChunkedTree));
+    if (tree == NULL) {
+        return NULL;
+    }
+    tree->ranges = markdoc_split_chunks(source, length, target_size, &tree->chunk_count);
+    if (tree->ranges != NULL) {
+        tree->trees = calloc(tree->chunk_count, sizeof(TSTree *));
+        tree->first_block = calloc(tree->chunk_count + 1, sizeof(uint32_t));
+    }
+    if (tree->ranges == NULL || tree->trees == NULL || tree->first_block == NULL) {
+        markdoc_chunked_tree_delete(tree);
+        return NULL;
+    }
+
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+    if ((uint32_t)thread_count > tree->chunk_count) {
+        thread_count = (long)tree->chunk_count;
+    }
+
+    ParseJob job = {
+        .language = language,
+        .source = source,
+        .length = length,
+        .tree = tree,
+    };
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_t *threads = calloc((size_t)thread_count, sizeof(pthread_t));
+    long started = 0;
+    if (threads != NULL) {
+        // The calling thread is one of the workers.
+        while (started < thread_count - 1 &&
+               pthread_create(&threads[started], NULL, parse_chunks, &job) == 0) {
+            started++;
+        }
+    }
+    parse_chunks(&job);
+    for (long i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    pthread_mutex_destroy(&job.lock);
+
+    for (uint32_t i = 0; i < tree->chunk_count; i++) {
+        if (tree->trees[i] == NULL) {
+            markdoc_chunked_tree_delete(tree);
+            return NULL;
+        }
+        TSNode root = ts_tree_root_node(tree->trees[i]);
+        tree->first_block[i + 1] = tree->first_block[i] + ts_node_named_child_count(root);
+    }
+    return tree;
+}
+
+void markdoc_chunked_tree_delete(MarkdocChunkedTree *tree) {
+    if (tree == NULL) {
+        return;
+    }
+    if (tree->trees != NULL) {
+        for (uint32_t i = 0; i < tree->chunk_count; i++) {
+            ts_tree_delete(tree->trees[i]);
+        }
+    }
+    free(tree->trees);
+    free(tree->ranges);
+    free(tree->first_block);
+    free(tree);
+}
+
+uint32_t markdoc_chunked_tree_chunk_count(const MarkdocChunkedTree *tree) {
+    return tree->chunk_count;
+}
+
+const TSTree *markdoc_chunked_tree_chunk(const MarkdocChunkedTree *tree, uint32_t index) {
+    return index < tree->chunk_count ? tree->trees[index] : NULL;
+}
+
+uint32_t markdoc_chunked_tree_block_count(const MarkdocChunkedTree *tree) {
+    return tree->first_block[tree->chunk_count];
+}
+
+TSNode markdoc_chunked_tree_block(const MarkdocChunkedTree *tree, uint32_t index) {
+    if (index >= markdoc_chunked_tree_block_count(tree)) {
+        return (TSNode){0};
+    }
+    // Find the last chunk whose first block is at or before `index`.
+    uint32_t low = 0;
+    uint32_t high = tree->chunk_count;
+    while (high - low > 1) {
+        uint32_t middle = low + (high - low) / 2;
+        if (tree->first_block[middle] <= index) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    TSNode root = ts_tree_root_node(tree->trees[low]);
+    return ts_node_named_child(root, index - tree->first_block[low]);
+}
+
+bool markdoc_chunked_tree_has_error(const MarkdocChunkedTree *tree) {
+    for (uint32_t i = 0; i < tree->chunk_count; i++) {
+        if (ts_node_has_error(ts_tree_root_node(tree->trees[i]))) {
+            return true;
+        }
+    }
+    return false;
+}
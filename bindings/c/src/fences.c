@@ -0,0 +1,201 @@
+#include "tree_sitter/markdoc/fences.h"
+
+#include <stdlib.h>
+
+#include "incremental.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+typedef struct {
+    // The index being updated, or NULL for a build, which walks everything.
+    const MarkdocFenceIndex *old;
+    const TSRange *changed;
+    uint32_t changed_count;
+    MarkdocFence *fences;
+    uint32_t count;
+    uint32_t capacity;
+} Walk;
+
+static bool push_fence(Walk *walk, MarkdocFence fence) {
+    if (walk->count == walk->capacity) {
+        uint32_t capacity = walk->capacity ? walk->capacity * 2 : 16;
+        MarkdocFence *grown = realloc(walk->fences, capacity * sizeof(MarkdocFence));
+        if (grown == NULL) {
+            return false;
+        }
+        walk->fences = grown;
+        walk->capacity = capacity;
+    }
+    walk->fences[walk->count++] = fence;
+    return true;
+}
+
+// Whether [start, end) may differ from what the old index saw.
+static bool is_dirty(const Walk *walk, uint32_t start, uint32_t end) {
+    return walk->old == NULL ||
+           markdoc_is_dirty(walk->changed, walk->changed_count, walk->old->edited,
+                            walk->old->edited_count, start, end);
+}
+
+// Copies the old fences that start in [start, end), unchanged.
+static bool keep_fences(Walk *walk, uint32_t start, uint32_t end) {
+    const MarkdocFence *fences = walk->old->fences;
+    uint32_t low = MARKDOC_FIRST_STARTING_AT(MarkdocFence, fences, walk->old->count, start);
+    for (uint32_t i = low; i < walk->old->count && fences[i].start_byte < end; i++) {
+        MarkdocFence fence = fences[i];
+        fence.changed = false;
+        if (!push_fence(walk, fence)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static MarkdocFence read_fence(TSNode node, uint32_t depth) {
+    TSNode open = ts_node_child_by_field_id(node, MARKDOC_FIELD_OPEN);
+    TSNode code = ts_node_child_by_field_id(node, MARKDOC_FIELD_CODE);
+    uint32_t open_end = ts_node_end_byte(open);
+    MarkdocFence fence = {
+        .start_byte = ts_node_start_byte(node),
+        .end_byte = ts_node_end_byte(node),
+        .language_start = open_end,
+        .language_end = open_end,
+        .attributes_start = open_end,
+        .attributes_end = open_end,
+        .code_start = ts_node_is_null(code) ? open_end : ts_node_start_byte(code),
+        .code_end = ts_node_is_null(code) ? open_end : ts_node_end_byte(code),
+        .depth = depth,
+        .changed = true,
+    };
+    TSNode info = ts_node_named_child(open, 0);
+    if (!ts_node_is_null(info) && ts_node_symbol(info) == MARKDOC_SYM_INFO_STRING) {
+        uint32_t count = ts_node_named_child_count(info);
+        for (uint32_t i = 0; i < count; i++) {
+            TSNode child = ts_node_named_child(info, i);
+            if (ts_node_symbol(child) == MARKDOC_SYM_LANGUAGE) {
+                fence.language_start = ts_node_start_byte(child);
+                fence.language_end = ts_node_end_byte(child);
+            } else if (ts_node_symbol(child) == MARKDOC_SYM_ATTRIBUTES) {
+                fence.attributes_start = ts_node_start_byte(child);
+                fence.attributes_end = ts_node_end_byte(child);
+            }
+        }
+    }
+    return fence;
+}
+
+// Nodes whose children can be fences.
+static bool is_container(TSSymbol symbol) {
+    switch (symbol) {
+        case MARKDOC_SYM_SOURCE_FILE:
+        case MARKDOC_SYM_MARKDOC_TAG:
+        case MARKDOC_SYM_BLOCKQUOTE:
+        case MARKDOC_SYM_UNORDERED_LIST:
+        case MARKDOC_SYM_ORDERED_LIST:
+        case MARKDOC_SYM_UNORDERED_LIST_ITEM:
+        case MARKDOC_SYM_ORDERED_LIST_ITEM:
+        case MARKDOC_SYM_LIST_ITEM_CONTINUATION:
+        case MARKDOC_SYM_CODE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool visit(Walk *walk, TSTreeCursor *cursor, uint32_t depth) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    TSSymbol symbol = ts_node_symbol(node);
+    bool is_fence = symbol == MARKDOC_SYM_FENCED_CODE_BLOCK;
+    if (!is_fence && !is_container(symbol)) {
+        return true;
+    }
+    uint32_t start = ts_node_start_byte(node), end = ts_node_end_byte(node);
+    if (!is_dirty(walk, start, end)) {
+        return keep_fences(walk, start, end);
+    }
+    if (is_fence && !push_fence(walk, read_fence(node, depth))) {
+        return false;
+    }
+
+    bool ok = true;
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            ok = visit(walk, cursor, depth + is_fence);
+        } while (ok && ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    return ok;
+}
+
+static bool run(Walk *walk, TSNode node) {
+    if (ts_node_is_null(node)) {
+        return true;
+    }
+    TSTreeCursor cursor = ts_tree_cursor_new(node);
+    bool ok = visit(walk, &cursor, 0);
+    ts_tree_cursor_delete(&cursor);
+    return ok;
+}
+
+bool markdoc_fence_index_build(TSNode node, MarkdocFenceIndex *index) {
+    *index = (MarkdocFenceIndex){0};
+    if (!ts_node_is_null(node) && !markdoc_symbols_match(ts_node_language(node))) {
+        return false;
+    }
+    Walk walk = {0};
+    // markdoc_fence_index_edit() relies on room for one edited range.
+    uint32_t *edited = markdoc_edited_new();
+    if (edited == NULL || !run(&walk, node)) {
+        free(edited);
+        free(walk.fences);
+        return false;
+    }
+    index->edited = edited;
+    index->edited_capacity = MARKDOC_EDITED_INITIAL_CAPACITY;
+    index->fences = walk.fences;
+    index->count = walk.count;
+    index->capacity = walk.capacity;
+    return true;
+}
+
+void markdoc_fence_index_edit(MarkdocFenceIndex *index, const TSInputEdit *edit) {
+    for (uint32_t i = 0; i < index->count; i++) {
+        MarkdocFence *fence = &index->fences[i];
+        fence->start_byte = markdoc_shift(fence->start_byte, edit);
+        fence->end_byte = markdoc_shift(fence->end_byte, edit);
+        fence->language_start = markdoc_shift(fence->language_start, edit);
+        fence->language_end = markdoc_shift(fence->language_end, edit);
+        fence->attributes_start = markdoc_shift(fence->attributes_start, edit);
+        fence->attributes_end = markdoc_shift(fence->attributes_end, edit);
+        fence->code_start = markdoc_shift(fence->code_start, edit);
+        fence->code_end = markdoc_shift(fence->code_end, edit);
+    }
+    markdoc_edited_add(&index->edited, &index->edited_count, &index->edited_capacity, edit);
+}
+
+bool markdoc_fence_index_update(MarkdocFenceIndex *index, TSNode node, const TSRange *changed,
+                                uint32_t changed_count) {
+    if (!ts_node_is_null(node) && !markdoc_symbols_match(ts_node_language(node))) {
+        return false;
+    }
+    Walk walk = {
+        .old = index,
+        .changed = changed,
+        .changed_count = changed_count,
+    };
+    if (!run(&walk, node)) {
+        free(walk.fences);
+        return false;
+    }
+    free(index->fences);
+    index->fences = walk.fences;
+    index->count = walk.count;
+    index->capacity = walk.capacity;
+    index->edited_count = 0;
+    return true;
+}
+
+void markdoc_fence_index_delete(MarkdocFenceIndex *index) {
+    free(index->fences);
+    free(index->edited);
+    *index = (MarkdocFenceIndex){0};
+}
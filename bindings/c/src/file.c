@@ -0,0 +1,158 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/markdoc/file.h"
+
+#include <errno.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool markdoc_map_file(const char *path, MarkdocMappedFile *file) {
+    *file = (MarkdocMappedFile){.data = ""};
+
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (handle == INVALID_HANDLE_VALUE) {
+        errno = ENOENT;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size)) {
+        CloseHandle(handle);
+        errno = EIO;
+        return false;
+    }
+    if (size.QuadPart > UINT32_MAX) {
+        CloseHandle(handle);
+        errno = EFBIG;
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(handle);
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(handle);
+    if (mapping == NULL) {
+        errno = EIO;
+        return false;
+    }
+
+    const char *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == NULL) {
+        CloseHandle(mapping);
+        errno = ENOMEM;
+        return false;
+    }
+
+    file->data = data;
+    file->length = (uint32_t)size.QuadPart;
+    file->handle = mapping;
+    return true;
+}
+
+void markdoc_unmap_file(MarkdocMappedFile *file) {
+    if (file->handle != NULL) {
+        UnmapViewOfFile(file->data);
+        CloseHandle(file->handle);
+    }
+    *file = (MarkdocMappedFile){.data = ""};
+}
+
+#else
+
+bool markdoc_map_file(const char *path, MarkdocMappedFile *file) {
+    *file = (MarkdocMappedFile){.data = ""};
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        int error = errno;
+        close(fd);
+        errno = error;
+        return false;
+    }
+    if ((uint64_t)info.st_size > UINT32_MAX) {
+        close(fd);
+        errno = EFBIG;
+        return false;
+    }
+    if (info.st_size == 0) {
+        close(fd);
+        return true;
+    }
+
+    void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    int error = errno;
+    close(fd);
+    if (data == MAP_FAILED) {
+        errno = error;
+        return false;
+    }
+    // The parser reads front to back; let the kernel read ahead.
+    posix_madvise(data, (size_t)info.st_size, POSIX_MADV_SEQUENTIAL);
+
+    file->data = data;
+    file->length = (uint32_t)info.st_size;
+    file->handle = data;
+    return true;
+}
+
+void markdoc_unmap_file(MarkdocMappedFile *file) {
+    if (file->handle != NULL) {
+        munmap(file->handle, file->length);
+    }
+    *file = (MarkdocMappedFile){.data = ""};
+}
+
+#endif
+
+// Hands the parser everything from `byte_index` to the end of the mapping in
+// one chunk, so the whole file is read without an intermediate buffer.
+static const char *read_mapping(void *payload, uint32_t byte_index, TSPoint position,
+                                uint32_t *bytes_read) {
+    (void)position;
+    const MarkdocMappedFile *file = payload;
+    if (byte_index >= file->length) {
+        *bytes_read = 0;
+        return "";
+    }
+    *bytes_read = file->length - byte_index;
+    return file->data + byte_index;
+}
+
+TSTree *markdoc_parse_file(TSParser *parser, const TSTree *old_tree,
+                           const char *path, MarkdocMappedFile *mapping) {
+    MarkdocMappedFile file;
+    TSTree *tree = NULL;
+    if (markdoc_map_file(path, &file)) {
+        TSInput input = {
+            .payload = &file,
+            .read = read_mapping,
+            .encoding = TSInputEncodingUTF8,
+        };
+        tree = ts_parser_parse(parser, old_tree, input);
+    }
+
+    if (tree == NULL || mapping == NULL) {
+        markdoc_unmap_file(&file);
+    }
+    if (mapping != NULL) {
+        *mapping = file;
+    }
+    return tree;
+}
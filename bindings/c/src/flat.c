@@ -0,0 +1,67 @@
+#include "tree_sitter/markdoc/flat.h"
+
+#include <stdlib.h>
+
+// Appends the cursor's node as a child of `parent` and returns its index.
+static uint32_t push_node(MarkdocFlatTree *flat, const TSTreeCursor *cursor, uint32_t parent) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    uint32_t index = flat->node_count++;
+    flat->start_bytes[index] = ts_node_start_byte(node);
+    flat->end_bytes[index] = ts_node_end_byte(node);
+    flat->parents[index] = parent;
+    flat->first_children[index] = MARKDOC_FLAT_NONE;
+    flat->next_siblings[index] = MARKDOC_FLAT_NONE;
+    flat->symbols[index] = ts_node_symbol(node);
+    flat->field_ids[index] = ts_tree_cursor_current_field_id(cursor);
+    return index;
+}
+
+bool markdoc_flat_tree_export(TSNode node, MarkdocFlatTree *flat) {
+    *flat = (MarkdocFlatTree){0};
+    if (ts_node_is_null(node)) {
+        return true;
+    }
+
+    // The 32-bit arrays come first so the 16-bit ones stay aligned.
+    size_t count = ts_node_descendant_count(node);
+    size_t wide = count * sizeof(uint32_t);
+    char *block = malloc(5 * wide + count * (sizeof(TSSymbol) + sizeof(TSFieldId)));
+    if (block == NULL) {
+        return false;
+    }
+    flat->start_bytes = (uint32_t *)block;
+    flat->end_bytes = (uint32_t *)(block + wide);
+    flat->parents = (uint32_t *)(block + 2 * wide);
+    flat->first_children = (uint32_t *)(block + 3 * wide);
+    flat->next_siblings = (uint32_t *)(block + 4 * wide);
+    flat->symbols = (TSSymbol *)(block + 5 * wide);
+    flat->field_ids = (TSFieldId *)(block + 5 * wide + count * sizeof(TSSymbol));
+
+    // `current` is the index of the cursor's node; parents come from the
+    // arrays already filled, so the walk needs no stack.
+    TSTreeCursor cursor = ts_tree_cursor_new(node);
+    uint32_t current = push_node(flat, &cursor, MARKDOC_FLAT_NONE);
+    for (;;) {
+        if (ts_tree_cursor_goto_first_child(&cursor)) {
+            uint32_t child = push_node(flat, &cursor, current);
+            flat->first_children[current] = child;
+            current = child;
+            continue;
+        }
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                ts_tree_cursor_delete(&cursor);
+                return true;
+            }
+            current = flat->parents[current];
+        }
+        uint32_t sibling = push_node(flat, &cursor, flat->parents[current]);
+        flat->next_siblings[current] = sibling;
+        current = sibling;
+    }
+}
+
+void markdoc_flat_tree_delete(MarkdocFlatTree *flat) {
+    free(flat->start_bytes);
+    *flat = (MarkdocFlatTree){0};
+}
@@ -0,0 +1,161 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/markdoc/frontmatter.h"
+
+#include <errno.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#define open _open
+#define read _read
+#define close _close
+#define OPEN_FLAGS (_O_RDONLY | _O_BINARY)
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#define OPEN_FLAGS O_RDONLY
+#endif
+
+#include "lines.h"
+
+// The first read; each later one asks for as much again as is buffered.
+#define FIRST_READ_SIZE 4096
+
+typedef enum {
+    SCAN_FOUND,
+    SCAN_NONE,
+    // The input seen so far ends inside the frontmatter.
+    SCAN_MORE,
+} ScanResult;
+
+// Scans for frontmatter in the first `length` bytes of the input, resuming
+// at `*line`: 0 at first, then the start of the first line that has not yet
+// been ruled out as the closing delimiter. `at_eof` says the input ends at
+// `length`.
+static ScanResult scan(const char *source, uint32_t length, bool at_eof, uint32_t *line,
+                       MarkdocFrontmatter *frontmatter) {
+    const char *end = source + length;
+    if (*line == 0) {
+        const char *newline = memchr(source, '\n', length);
+        if (newline == NULL) {
+            // The opening `---` must be followed by a line break. Stop as
+            // soon as the first line cannot be one.
+            const char *eol = end > source && end[-1] == '\r' ? end - 1 : end;
+            size_t seen = eol - source < 3 ? (size_t)(eol - source) : 3;
+            if (at_eof || memcmp(source, "---", seen) != 0 ||
+                (seen == 3 && !markdoc_line_is_blank(source + 3, eol))) {
+                return SCAN_NONE;
+            }
+            return SCAN_MORE;
+        }
+        if (!markdoc_line_is_frontmatter_delimiter(source, markdoc_line_end(source, end))) {
+            return SCAN_NONE;
+        }
+        *line = (uint32_t)(newline + 1 - source);
+    }
+
+    uint32_t body = (uint32_t)((const char *)memchr(source, '\n', length) + 1 - source);
+    while (*line < length || at_eof) {
+        const char *start = source + *line;
+        const char *newline = memchr(start, '\n', (size_t)(end - start));
+        if (newline == NULL && !at_eof) {
+            return SCAN_MORE;
+        }
+        const char *eol = markdoc_line_end(start, end);
+        if (markdoc_line_is_frontmatter_delimiter(start, eol)) {
+            // The scanner still takes this line as the closing delimiter,
+            // and the frontmatter then fails to parse for lack of a body.
+            if (*line == body) {
+                return SCAN_NONE;
+            }
+            *frontmatter = (MarkdocFrontmatter){
+                .start_byte = 0,
+                .end_byte = (uint32_t)(eol - source),
+                .yaml_start_byte = body,
+                .yaml_end_byte = *line,
+            };
+            return SCAN_FOUND;
+        }
+        if (newline == NULL) {
+            return SCAN_NONE;
+        }
+        *line = (uint32_t)(newline + 1 - source);
+    }
+    return SCAN_MORE;
+}
+
+bool markdoc_frontmatter_find(const char *source, uint32_t length,
+                              MarkdocFrontmatter *frontmatter) {
+    uint32_t line = 0;
+    return scan(source, length, true, &line, frontmatter) == SCAN_FOUND;
+}
+
+bool markdoc_frontmatter_read_fd(int fd, MarkdocFrontmatterFile *file) {
+    *file = (MarkdocFrontmatterFile){0};
+    uint32_t capacity = FIRST_READ_SIZE;
+    char *data = malloc((size_t)capacity + 1);
+    if (data == NULL) {
+        errno = ENOMEM;
+        return false;
+    }
+
+    uint32_t length = 0, line = 0;
+    bool at_eof = false;
+    ScanResult result = SCAN_MORE;
+    while (result == SCAN_MORE) {
+        if (length == capacity) {
+            if (capacity == UINT32_MAX) {
+                free(data);
+                errno = EFBIG;
+                return false;
+            }
+            capacity = capacity > UINT32_MAX / 2 ? UINT32_MAX : capacity * 2;
+            char *grown = realloc(data, (size_t)capacity + 1);
+            if (grown == NULL) {
+                free(data);
+                errno = ENOMEM;
+                return false;
+            }
+            data = grown;
+        }
+        long count = (long)read(fd, data + length, capacity - length);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            int error = errno;
+            free(data);
+            errno = error;
+            return false;
+        }
+        at_eof = count == 0;
+        length += (uint32_t)count;
+        result = scan(data, length, at_eof, &line, &file->frontmatter);
+    }
+
+    data[length] = '\0';
+    file->data = data;
+    file->length = length;
+    file->found = result == SCAN_FOUND;
+    return true;
+}
+
+bool markdoc_frontmatter_read_file(const char *path, MarkdocFrontmatterFile *file) {
+    *file = (MarkdocFrontmatterFile){0};
+    int fd = open(path, OPEN_FLAGS);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = markdoc_frontmatter_read_fd(fd, file);
+    int error = errno;
+    close(fd);
+    errno = error;
+    return ok;
+}
+
+void markdoc_frontmatter_file_delete(MarkdocFrontmatterFile *file) {
+    free(file->data);
+    *file = (MarkdocFrontmatterFile){0};
+}
@@ -0,0 +1,546 @@
+#include "tree_sitter/markdoc/highlight.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NO_PATTERN UINT32_MAX
+#define MAX_TOKEN_LENGTH 64
+
+typedef struct {
+    // The first simple pattern naming the symbol, or NO_PATTERN.
+    uint32_t pattern;
+    uint32_t capture;
+} SymbolCapture;
+
+// A capture from a structural pattern, keyed by the captured node.
+typedef struct {
+    uintptr_t id;
+    uint32_t pattern;
+    uint32_t capture;
+} NodeCapture;
+
+struct MarkdocHighlighter {
+    TSQuery *query;
+    TSQueryCursor *cursor;
+    SymbolCapture *symbols;
+    uint32_t symbol_count;
+    uint32_t native_pattern_count;
+    uint32_t structural_pattern_count;
+    // Scratch space for the structural captures of one markdoc_highlight().
+    NodeCapture *captures;
+    uint32_t capture_capacity;
+};
+
+typedef struct {
+    const char *at;
+    const char *end;
+} Reader;
+
+static void skip_space(Reader *reader) {
+    while (reader->at < reader->end) {
+        char c = *reader->at;
+        if (c == ';') {
+            while (reader->at < reader->end && *reader->at != '\n') {
+                reader->at++;
+            }
+        } else if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            reader->at++;
+        } else {
+            break;
+        }
+    }
+}
+
+static bool accept(Reader *reader, char c) {
+    skip_space(reader);
+    if (reader->at < reader->end && *reader->at == c) {
+        reader->at++;
+        return true;
+    }
+    return false;
+}
+
+static bool is_name_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == '-' || c == '.';
+}
+
+// Reads a node type or, after the `@`, a capture name.
+static uint32_t read_name(Reader *reader, const char **name) {
+    skip_space(reader);
+    *name = reader->at;
+    while (reader->at < reader->end && is_name_char(*reader->at)) {
+        reader->at++;
+    }
+    return (uint32_t)(reader->at - *name);
+}
+
+// Reads a quoted token into `buffer`, resolving escapes as the query parser
+// does. Returns its length, or 0 when there is none or it is too long.
+static uint32_t read_string(Reader *reader, char buffer[MAX_TOKEN_LENGTH]) {
+    if (!accept(reader, '"')) {
+        return 0;
+    }
+    uint32_t length = 0;
+    while (reader->at < reader->end && *reader->at != '"') {
+        char c = *reader->at++;
+        if (c == '\\' && reader->at < reader->end) {
+            c = *reader->at++;
+            switch (c) {
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case '0': c = '\0'; break;
+                default: break;
+            }
+        }
+        if (length == MAX_TOKEN_LENGTH) {
+            return 0;
+        }
+        buffer[length++] = c;
+    }
+    return accept(reader, '"') ? length : 0;
+}
+
+static bool read_capture(Reader *reader, const char **name, uint32_t *length) {
+    if (!accept(reader, '@')) {
+        return false;
+    }
+    *length = read_name(reader, name);
+    return *length > 0;
+}
+
+// Recognizes `(node_type) @capture`, `("token" @capture)` and
+// `"token" @capture`, the patterns that match a node by its type alone, and
+// stores the node's symbol and the capture's name. Anything else, including
+// wildcards, supertypes, quantifiers, fields and predicates, is left to the
+// query engine.
+static bool parse_simple_pattern(const TSLanguage *language, const char *text, uint32_t length,
+                                 TSSymbol *symbol, const char **capture,
+                                 uint32_t *capture_length) {
+    Reader reader = {text, text + length};
+    char token[MAX_TOKEN_LENGTH];
+    uint32_t token_length;
+    bool named = false;
+
+    if (accept(&reader, '(')) {
+        skip_space(&reader);
+        if (reader.at < reader.end && *reader.at == '"') {
+            token_length = read_string(&reader, token);
+            if (token_length == 0 || !read_capture(&reader, capture, capture_length) ||
+                !accept(&reader, ')')) {
+                return false;
+            }
+        } else {
+            const char *name;
+            token_length = read_name(&reader, &name);
+            if (token_length == 0 || token_length > MAX_TOKEN_LENGTH || !accept(&reader, ')') ||
+                !read_capture(&reader, capture, capture_length)) {
+                return false;
+            }
+            memcpy(token, name, token_length);
+            named = true;
+        }
+    } else {
+        token_length = read_string(&reader, token);
+        if (token_length == 0 || !read_capture(&reader, capture, capture_length)) {
+            return false;
+        }
+    }
+    skip_space(&reader);
+    if (reader.at != reader.end) {
+        return false;
+    }
+
+    if (named && ((token_length == 1 && token[0] == '_') ||
+                  (token_length == 5 && memcmp(token, "ERROR", 5) == 0))) {
+        return false;
+    }
+    *symbol = ts_language_symbol_for_name(language, token, token_length, named);
+    TSSymbolType type = ts_language_symbol_type(language, *symbol);
+    return *symbol != 0 &&
+           type == (named ? TSSymbolTypeRegular : TSSymbolTypeAnonymous);
+}
+
+static bool find_capture(const TSQuery *query, const char *name, uint32_t length,
+                         uint32_t *capture) {
+    uint32_t count = ts_query_capture_count(query);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t candidate_length;
+        const char *candidate = ts_query_capture_name_for_id(query, i, &candidate_length);
+        if (candidate_length == length && memcmp(candidate, name, length) == 0) {
+            *capture = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+typedef enum {
+    PREDICATE_UNSUPPORTED,
+    PREDICATE_EQ,
+    PREDICATE_ANY_OF,
+} PredicateKind;
+
+// Reads the predicate name at `step`: `#eq?` and `#any-of?`, or their
+// `#not-` forms.
+static PredicateKind predicate_kind(const TSQuery *query, const TSQueryPredicateStep *step,
+                                    bool *negated) {
+    *negated = false;
+    if (step->type != TSQueryPredicateStepTypeString) {
+        return PREDICATE_UNSUPPORTED;
+    }
+    uint32_t length;
+    const char *name = ts_query_string_value_for_id(query, step->value_id, &length);
+    if (length > 4 && memcmp(name, "not-", 4) == 0) {
+        *negated = true;
+        name += 4;
+        length -= 4;
+    }
+    if (length == 3 && memcmp(name, "eq?", 3) == 0) {
+        return PREDICATE_EQ;
+    }
+    if (length == 7 && memcmp(name, "any-of?", 7) == 0) {
+        return PREDICATE_ANY_OF;
+    }
+    return PREDICATE_UNSUPPORTED;
+}
+
+// The index of the Done step ending the predicate that starts at `start`.
+static uint32_t predicate_end(const TSQueryPredicateStep *steps, uint32_t step_count,
+                              uint32_t start) {
+    uint32_t end = start;
+    while (end < step_count && steps[end].type != TSQueryPredicateStepTypeDone) {
+        end++;
+    }
+    return end;
+}
+
+// Whether markdoc_highlight() can evaluate every predicate of `pattern`:
+// `#eq?` comparing a capture with a string or another capture, and
+// `#any-of?` comparing a capture with strings. `#match?` would need a
+// regular expression engine, which this library does not carry, so it is
+// refused along with every other predicate.
+static bool supports_predicates(const TSQuery *query, uint32_t pattern) {
+    uint32_t step_count;
+    const TSQueryPredicateStep *steps = ts_query_predicates_for_pattern(query, pattern,
+                                                                        &step_count);
+    for (uint32_t i = 0; i < step_count;) {
+        uint32_t end = predicate_end(steps, step_count, i);
+        bool negated;
+        PredicateKind kind = predicate_kind(query, &steps[i], &negated);
+        if (kind == PREDICATE_UNSUPPORTED || end - i < 3 ||
+            steps[i + 1].type != TSQueryPredicateStepTypeCapture ||
+            (kind == PREDICATE_EQ && end - i != 3)) {
+            return false;
+        }
+        for (uint32_t j = i + 2; kind == PREDICATE_ANY_OF && j < end; j++) {
+            if (steps[j].type != TSQueryPredicateStepTypeString) {
+                return false;
+            }
+        }
+        i = end + 1;
+    }
+    return true;
+}
+
+MarkdocHighlighter *markdoc_highlighter_new(const TSLanguage *language, const char *source,
+                                            uint32_t length, uint32_t *error_offset,
+                                            TSQueryError *error_type) {
+    *error_offset = 0;
+    *error_type = TSQueryErrorNone;
+    TSQuery *query = ts_query_new(language, source, length, error_offset, error_type);
+    if (query == NULL) {
+        return NULL;
+    }
+
+    MarkdocHighlighter *highlighter = calloc(1, sizeof(MarkdocHighlighter));
+    uint32_t symbol_count = ts_language_symbol_count(language);
+    SymbolCapture *symbols = malloc(symbol_count * sizeof(SymbolCapture));
+    TSQueryCursor *cursor = ts_query_cursor_new();
+    if (highlighter == NULL || symbols == NULL || cursor == NULL) {
+        free(highlighter);
+        free(symbols);
+        if (cursor != NULL) {
+            ts_query_cursor_delete(cursor);
+        }
+        ts_query_delete(query);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < symbol_count; i++) {
+        symbols[i] = (SymbolCapture){.pattern = NO_PATTERN};
+    }
+    highlighter->query = query;
+    highlighter->cursor = cursor;
+    highlighter->symbols = symbols;
+    highlighter->symbol_count = symbol_count;
+
+    // Move every simple pattern into the table and disable it in the query.
+    // A later simple pattern for the same symbol can never win, so it only
+    // needs disabling.
+    uint32_t pattern_count = ts_query_pattern_count(query);
+    for (uint32_t pattern = 0; pattern < pattern_count; pattern++) {
+        uint32_t start = ts_query_start_byte_for_pattern(query, pattern);
+        uint32_t end = ts_query_end_byte_for_pattern(query, pattern);
+        if (!supports_predicates(query, pattern)) {
+            *error_offset = start;
+            *error_type = TSQueryErrorSyntax;
+            markdoc_highlighter_delete(highlighter);
+            return NULL;
+        }
+        TSSymbol symbol;
+        const char *name;
+        uint32_t name_length, capture;
+        if (!parse_simple_pattern(language, source + start, end - start, &symbol, &name,
+                                  &name_length) ||
+            symbol >= symbol_count || !find_capture(query, name, name_length, &capture)) {
+            highlighter->structural_pattern_count++;
+            continue;
+        }
+        if (symbols[symbol].pattern == NO_PATTERN) {
+            symbols[symbol] = (SymbolCapture){.pattern = pattern, .capture = capture};
+        }
+        ts_query_disable_pattern(query, pattern);
+        highlighter->native_pattern_count++;
+    }
+    return highlighter;
+}
+
+void markdoc_highlighter_delete(MarkdocHighlighter *highlighter) {
+    if (highlighter == NULL) {
+        return;
+    }
+    ts_query_cursor_delete(highlighter->cursor);
+    ts_query_delete(highlighter->query);
+    free(highlighter->symbols);
+    free(highlighter->captures);
+    free(highlighter);
+}
+
+uint32_t markdoc_highlighter_capture_count(const MarkdocHighlighter *highlighter) {
+    return ts_query_capture_count(highlighter->query);
+}
+
+const char *markdoc_highlighter_capture_name(const MarkdocHighlighter *highlighter,
+                                             uint32_t capture, uint32_t *length) {
+    return ts_query_capture_name_for_id(highlighter->query, capture, length);
+}
+
+uint32_t markdoc_highlighter_native_pattern_count(const MarkdocHighlighter *highlighter) {
+    return highlighter->native_pattern_count;
+}
+
+static int compare_node_captures(const void *a, const void *b) {
+    const NodeCapture *left = a, *right = b;
+    if (left->id != right->id) {
+        return left->id < right->id ? -1 : 1;
+    }
+    return left->pattern < right->pattern ? -1 : left->pattern > right->pattern;
+}
+
+static const TSQueryCapture *find_match_capture(const TSQueryMatch *match, uint32_t capture) {
+    for (uint16_t i = 0; i < match->capture_count; i++) {
+        if (match->captures[i].index == capture) {
+            return &match->captures[i];
+        }
+    }
+    return NULL;
+}
+
+// Whether the text of `node` equals one of `values`, the strings and
+// captures after a predicate's first argument, or with `negated` none of
+// them. A capture that matched no node compares equal to anything.
+static bool node_satisfies(const TSQuery *query, const TSQueryMatch *match, const char *source,
+                           TSNode node, const TSQueryPredicateStep *values, uint32_t count,
+                           bool negated) {
+    uint32_t start = ts_node_start_byte(node);
+    uint32_t length = ts_node_end_byte(node) - start;
+    bool equal = false;
+    for (uint32_t i = 0; i < count && !equal; i++) {
+        const char *value;
+        uint32_t value_length;
+        if (values[i].type == TSQueryPredicateStepTypeCapture) {
+            const TSQueryCapture *other = find_match_capture(match, values[i].value_id);
+            if (other == NULL) {
+                return true;
+            }
+            value = source + ts_node_start_byte(other->node);
+            value_length = ts_node_end_byte(other->node) - ts_node_start_byte(other->node);
+        } else {
+            value = ts_query_string_value_for_id(query, values[i].value_id, &value_length);
+        }
+        equal = value_length == length && memcmp(source + start, value, length) == 0;
+    }
+    return equal != negated;
+}
+
+// Evaluates the predicates of the match's pattern against `source`. As in
+// `tree-sitter highlight`, every node of a predicate's first capture has to
+// satisfy it, so a predicate on a capture that matched nothing holds.
+static bool satisfies_predicates(const TSQuery *query, const TSQueryMatch *match,
+                                 const char *source) {
+    uint32_t step_count;
+    const TSQueryPredicateStep *steps =
+        ts_query_predicates_for_pattern(query, match->pattern_index, &step_count);
+    for (uint32_t i = 0; i < step_count;) {
+        uint32_t end = predicate_end(steps, step_count, i);
+        bool negated;
+        predicate_kind(query, &steps[i], &negated);
+        for (uint16_t j = 0; j < match->capture_count; j++) {
+            const TSQueryCapture *capture = &match->captures[j];
+            if (capture->index == steps[i + 1].value_id &&
+                !node_satisfies(query, match, source, capture->node, &steps[i + 2],
+                                end - i - 2, negated)) {
+                return false;
+            }
+        }
+        i = end + 1;
+    }
+    return true;
+}
+
+// Runs the structural patterns and returns the captures of the matches
+// whose predicates hold, sorted by node and by pattern within a node, or -1
+// when out of memory.
+static int64_t collect_structural(MarkdocHighlighter *highlighter, TSNode node,
+                                  const char *source, uint32_t start_byte, uint32_t end_byte) {
+    if (highlighter->structural_pattern_count == 0) {
+        return 0;
+    }
+    ts_query_cursor_set_byte_range(highlighter->cursor, start_byte, end_byte);
+    ts_query_cursor_exec(highlighter->cursor, highlighter->query, node);
+
+    uint32_t count = 0;
+    TSQueryMatch match;
+    uint32_t index;
+    while (ts_query_cursor_next_capture(highlighter->cursor, &match, &index)) {
+        if (!satisfies_predicates(highlighter->query, &match, source)) {
+            ts_query_cursor_remove_match(highlighter->cursor, match.id);
+            continue;
+        }
+        if (count == highlighter->capture_capacity) {
+            uint32_t capacity = count ? count * 2 : 64;
+            NodeCapture *grown = realloc(highlighter->captures, capacity * sizeof(NodeCapture));
+            if (grown == NULL) {
+                return -1;
+            }
+            highlighter->captures = grown;
+            highlighter->capture_capacity = capacity;
+        }
+        const TSQueryCapture *capture = &match.captures[index];
+        highlighter->captures[count++] = (NodeCapture){
+            .id = (uintptr_t)capture->node.id,
+            .pattern = match.pattern_index,
+            .capture = capture->index,
+        };
+    }
+    qsort(highlighter->captures, count, sizeof(NodeCapture), compare_node_captures);
+    return count;
+}
+
+// Returns the first structural capture of the node `id`, or NULL.
+static const NodeCapture *find_structural(const NodeCapture *captures, uint32_t count,
+                                          uintptr_t id) {
+    uint32_t low = 0, high = count;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (captures[middle].id < id) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low < count && captures[low].id == id ? &captures[low] : NULL;
+}
+
+static bool push_span(MarkdocHighlights *highlights, uint32_t *capacity, MarkdocHighlight span) {
+    if (highlights->count == *capacity) {
+        uint32_t grown_capacity = *capacity ? *capacity * 2 : 256;
+        MarkdocHighlight *grown =
+            realloc(highlights->spans, grown_capacity * sizeof(MarkdocHighlight));
+        if (grown == NULL) {
+            return false;
+        }
+        highlights->spans = grown;
+        *capacity = grown_capacity;
+    }
+    highlights->spans[highlights->count++] = span;
+    return true;
+}
+
+// Moves to the next node in pre-order that is not inside the current one.
+static bool goto_next(TSTreeCursor *cursor) {
+    while (!ts_tree_cursor_goto_next_sibling(cursor)) {
+        if (!ts_tree_cursor_goto_parent(cursor)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool markdoc_highlight(MarkdocHighlighter *highlighter, TSNode node, const char *source,
+                       uint32_t start_byte, uint32_t end_byte, MarkdocHighlights *highlights) {
+    *highlights = (MarkdocHighlights){0};
+    if (ts_node_is_null(node)) {
+        return true;
+    }
+    int64_t structural_count = collect_structural(highlighter, node, source, start_byte,
+                                                  end_byte);
+    if (structural_count < 0) {
+        return false;
+    }
+    const NodeCapture *structural = highlighter->captures;
+
+    // A pre-order walk that skips the subtrees outside the range and stops
+    // at the first node past it. The root itself is always visited.
+    uint32_t capacity = 0;
+    bool ok = true;
+    TSTreeCursor cursor = ts_tree_cursor_new(node);
+    for (bool more = true; more;) {
+        TSNode current = ts_tree_cursor_current_node(&cursor);
+        uint32_t node_start = ts_node_start_byte(current);
+        if (node_start >= end_byte && !ts_node_eq(current, node)) {
+            break;
+        }
+
+        if (ts_node_end_byte(current) > start_byte) {
+            TSSymbol symbol = ts_node_symbol(current);
+            SymbolCapture best = symbol < highlighter->symbol_count
+                                     ? highlighter->symbols[symbol]
+                                     : (SymbolCapture){.pattern = NO_PATTERN};
+            if (structural_count > 0) {
+                const NodeCapture *found = find_structural(structural, (uint32_t)structural_count,
+                                                           (uintptr_t)current.id);
+                if (found != NULL && found->pattern < best.pattern) {
+                    best = (SymbolCapture){.pattern = found->pattern, .capture = found->capture};
+                }
+            }
+            if (best.pattern != NO_PATTERN) {
+                MarkdocHighlight span = {
+                    .start_byte = node_start,
+                    .end_byte = ts_node_end_byte(current),
+                    .capture = best.capture,
+                };
+                if (!push_span(highlights, &capacity, span)) {
+                    ok = false;
+                    break;
+                }
+            }
+            if (ts_tree_cursor_goto_first_child_for_byte(&cursor, start_byte) >= 0) {
+                continue;
+            }
+        }
+
+        more = goto_next(&cursor);
+    }
+    ts_tree_cursor_delete(&cursor);
+    if (!ok) {
+        markdoc_highlights_delete(highlights);
+    }
+    return ok;
+}
+
+void markdoc_highlights_delete(MarkdocHighlights *highlights) {
+    free(highlights->spans);
+    *highlights = (MarkdocHighlights){0};
+}
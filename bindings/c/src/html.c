@@ -0,0 +1,690 @@
+#include "tree_sitter/markdoc/html.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "inlines.h"
+#include "lines.h"
+#include "output.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+struct MarkdocHtmlRenderer {
+    MarkdocOutput output;
+    const char *source;
+    const MarkdocHtmlOptions *options;
+};
+
+static void write_raw(MarkdocHtmlRenderer *html, const char *string) {
+    markdoc_output_string(&html->output, string);
+}
+
+void markdoc_html_write(MarkdocHtmlRenderer *html, const char *data, size_t length) {
+    markdoc_output_write(&html->output, data, length);
+}
+
+void markdoc_html_write_escaped(MarkdocHtmlRenderer *html, const char *data, size_t length) {
+    MarkdocOutput *output = &html->output;
+    size_t run = 0;
+    for (size_t i = 0; i < length; i++) {
+        const char *entity;
+        switch (data[i]) {
+            case '&': entity = "&amp;"; break;
+            case '<': entity = "&lt;"; break;
+            case '>': entity = "&gt;"; break;
+            case '"': entity = "&quot;"; break;
+            default: continue;
+        }
+        markdoc_output_write(output, data + run, i - run);
+        markdoc_output_string(output, entity);
+        run = i + 1;
+    }
+    markdoc_output_write(output, data + run, length - run);
+}
+
+static void write_range(MarkdocHtmlRenderer *html, uint32_t start, uint32_t end) {
+    markdoc_html_write_escaped(html, html->source + start, end - start);
+}
+
+static void write_node(MarkdocHtmlRenderer *html, TSNode node) {
+    write_range(html, ts_node_start_byte(node), ts_node_end_byte(node));
+}
+
+static void trim_end(const char *source, uint32_t start, uint32_t *end) {
+    while (*end > start && (source[*end - 1] == ' ' || source[*end - 1] == '\t' ||
+                            source[*end - 1] == '\r' || source[*end - 1] == '\n')) {
+        (*end)--;
+    }
+}
+
+// Tags
+
+static TSNode tag_opener(TSNode node) {
+    return ts_node_symbol(node) == MARKDOC_SYM_MARKDOC_TAG ? ts_node_named_child(node, 0) : node;
+}
+
+bool markdoc_html_tag_attribute(const MarkdocHtmlTag *tag, const char *name, const char **value,
+                                uint32_t *length) {
+    TSNode opener = tag_opener(tag->node);
+    size_t name_length = strlen(name);
+    uint32_t count = ts_node_named_child_count(opener);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode attribute = ts_node_named_child(opener, i);
+        if (ts_node_symbol(attribute) != MARKDOC_SYM_ATTRIBUTE) {
+            continue;
+        }
+        TSNode key = ts_node_named_child(attribute, 0);
+        uint32_t key_start = ts_node_start_byte(key);
+        if (ts_node_end_byte(key) - key_start != name_length ||
+            memcmp(tag->source + key_start, name, name_length) != 0) {
+            continue;
+        }
+        TSNode attribute_value = ts_node_named_child(attribute, 1);
+        uint32_t start = ts_node_start_byte(attribute_value);
+        uint32_t end = ts_node_end_byte(attribute_value);
+        if (end - start >= 2 && (tag->source[start] == '"' || tag->source[start] == '\'')) {
+            start++;
+            end--;
+        }
+        *value = tag->source + start;
+        *length = end - start;
+        return true;
+    }
+    return false;
+}
+
+static const MarkdocHtmlTagHandler *find_handler(MarkdocHtmlRenderer *html,
+                                                 const MarkdocHtmlTag *tag) {
+    if (html->options == NULL) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < html->options->tag_count; i++) {
+        const MarkdocHtmlTagHandler *handler = &html->options->tags[i];
+        if (strlen(handler->name) == tag->name_length &&
+            memcmp(handler->name, tag->name, tag->name_length) == 0) {
+            return handler;
+        }
+    }
+    return NULL;
+}
+
+static void render_blocks(MarkdocHtmlRenderer *html, TSTreeCursor *cursor);
+
+// Renders the markdoc_tag or inline tag_self_close under the cursor through
+// its handler; a block tag's children are the blocks between its open and
+// close lines.
+static void render_tag(MarkdocHtmlRenderer *html, TSTreeCursor *cursor, bool is_inline) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    TSNode opener = tag_opener(node);
+    TSNode name = {0};
+    uint32_t count = ts_node_named_child_count(opener);
+    for (uint32_t i = 0; i < count && ts_node_is_null(name); i++) {
+        TSNode child = ts_node_named_child(opener, i);
+        if (ts_node_symbol(child) == MARKDOC_SYM_TAG_NAME) {
+            name = child;
+        }
+    }
+    if (ts_node_is_null(name)) {
+        return;
+    }
+    MarkdocHtmlTag tag = {
+        .node = node,
+        .source = html->source,
+        .name = html->source + ts_node_start_byte(name),
+        .name_length = ts_node_end_byte(name) - ts_node_start_byte(name),
+        .is_inline = is_inline,
+    };
+    const MarkdocHtmlTagHandler *handler = find_handler(html, &tag);
+    if (handler != NULL && !handler->render(handler->payload, html, &tag, true)) {
+        return;
+    }
+    if (ts_node_symbol(node) == MARKDOC_SYM_MARKDOC_TAG) {
+        render_blocks(html, cursor);
+    }
+    if (handler != NULL) {
+        handler->render(handler->payload, html, &tag, false);
+    }
+}
+
+// Inlines
+
+// Writes a link or image destination's URL, escaped for an attribute, and
+// returns the range of its quoted title, if any.
+static void write_destination(MarkdocHtmlRenderer *html, uint32_t start, uint32_t end,
+                              uint32_t *title_start, uint32_t *title_end) {
+    const char *source = html->source;
+    while (start < end && markdoc_is_space(source[start])) {
+        start++;
+    }
+    trim_end(source, start, &end);
+    uint32_t url_end = start;
+    while (url_end < end && !markdoc_is_space(source[url_end])) {
+        url_end++;
+    }
+    uint32_t url_start = start, title = url_end;
+    if (url_end - url_start >= 2 && source[url_start] == '<' && source[url_end - 1] == '>') {
+        url_start++;
+        url_end--;
+    }
+    write_range(html, url_start, url_end);
+
+    while (title < end && markdoc_is_space(source[title])) {
+        title++;
+    }
+    *title_start = *title_end = 0;
+    if (end - title >= 2 && (source[title] == '"' || source[title] == '\'') &&
+        source[end - 1] == source[title]) {
+        *title_start = title + 1;
+        *title_end = end - 1;
+    }
+}
+
+static void render_inline_text(MarkdocHtmlRenderer *html, uint32_t start, uint32_t end);
+
+static void render_link(MarkdocHtmlRenderer *html, uint32_t text_start, uint32_t text_end,
+                        uint32_t destination_start, uint32_t destination_end) {
+    uint32_t title_start, title_end;
+    write_raw(html, "<a href=\"");
+    write_destination(html, destination_start, destination_end, &title_start, &title_end);
+    if (title_end > title_start) {
+        write_raw(html, "\" title=\"");
+        write_range(html, title_start, title_end);
+    }
+    write_raw(html, "\">");
+    render_inline_text(html, text_start, text_end);
+    write_raw(html, "</a>");
+}
+
+static void render_image(MarkdocHtmlRenderer *html, uint32_t alt_start, uint32_t alt_end,
+                         uint32_t destination_start, uint32_t destination_end) {
+    uint32_t title_start, title_end;
+    write_raw(html, "<img src=\"");
+    write_destination(html, destination_start, destination_end, &title_start, &title_end);
+    write_raw(html, "\" alt=\"");
+    write_range(html, alt_start, alt_end);
+    if (title_end > title_start) {
+        write_raw(html, "\" title=\"");
+        write_range(html, title_start, title_end);
+    }
+    write_raw(html, "\">");
+}
+
+static void render_code(MarkdocHtmlRenderer *html, uint32_t start, uint32_t end) {
+    write_raw(html, "<code>");
+    write_range(html, start, end);
+    write_raw(html, "</code>");
+}
+
+// Renders the single-line range [start, end) of a heading_text, link_text,
+// emphasis or strong token, whose markup has no nodes, with the spans
+// markdoc_next_span() finds in it.
+static void render_inline_text(MarkdocHtmlRenderer *html, uint32_t start, uint32_t end) {
+    uint32_t text = start;
+    MarkdocSpan span;
+    while (markdoc_next_span(html->source, text, end, &span)) {
+        write_range(html, text, span.start);
+        switch (span.kind) {
+            case MARKDOC_SPAN_EMPHASIS:
+            case MARKDOC_SPAN_STRONG: {
+                bool strong = span.kind == MARKDOC_SPAN_STRONG;
+                write_raw(html, strong ? "<strong>" : "<em>");
+                render_inline_text(html, span.content_start, span.content_end);
+                write_raw(html, strong ? "</strong>" : "</em>");
+                break;
+            }
+            case MARKDOC_SPAN_CODE:
+                render_code(html, span.content_start, span.content_end);
+                break;
+            case MARKDOC_SPAN_LINK:
+                render_link(html, span.content_start, span.content_end, span.destination_start,
+                            span.destination_end);
+                break;
+            case MARKDOC_SPAN_IMAGE:
+                render_image(html, span.content_start, span.content_end, span.destination_start,
+                             span.destination_end);
+                break;
+        }
+        text = span.end;
+    }
+    write_range(html, text, end);
+}
+
+static void render_inline(MarkdocHtmlRenderer *html, TSTreeCursor *cursor) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    uint32_t start = ts_node_start_byte(node), end = ts_node_end_byte(node);
+    TSNode label = ts_node_named_child(node, 0);
+    TSNode destination = ts_node_named_child(node, 1);
+
+    switch (ts_node_symbol(node)) {
+        case MARKDOC_SYM_EMPHASIS:
+            write_raw(html, "<em>");
+            render_inline_text(html, start + 1, end - 1);
+            write_raw(html, "</em>");
+            break;
+        case MARKDOC_SYM_STRONG:
+            write_raw(html, "<strong>");
+            render_inline_text(html, start + 2, end - 2);
+            write_raw(html, "</strong>");
+            break;
+        case MARKDOC_SYM_INLINE_CODE: {
+            uint32_t code_start = start + 1, code_end = end - 1;
+            markdoc_code_span_end(html->source, start, end, &code_start, &code_end);
+            render_code(html, code_start, code_end);
+            break;
+        }
+        case MARKDOC_SYM_LINK:
+            render_link(html, ts_node_start_byte(label), ts_node_end_byte(label),
+                        ts_node_start_byte(destination), ts_node_end_byte(destination));
+            break;
+        case MARKDOC_SYM_IMAGE:
+            render_image(html, ts_node_start_byte(label), ts_node_end_byte(label),
+                         ts_node_start_byte(destination), ts_node_end_byte(destination));
+            break;
+        case MARKDOC_SYM_HTML_INLINE:
+            markdoc_html_write(html, html->source + start, end - start);
+            break;
+        case MARKDOC_SYM_INLINE_EXPRESSION:
+            if (html->options != NULL && html->options->expression != NULL) {
+                html->options->expression(html->options->expression_payload, html, node);
+            }
+            break;
+        case MARKDOC_SYM_INLINE_TAG:
+            if (ts_tree_cursor_goto_first_child(cursor)) {
+                if (ts_node_symbol(ts_tree_cursor_current_node(cursor)) ==
+                    MARKDOC_SYM_TAG_SELF_CLOSE) {
+                    render_tag(html, cursor, true);
+                }
+                ts_tree_cursor_goto_parent(cursor);
+            }
+            break;
+        case MARKDOC_SYM_TAG_SELF_CLOSE:
+            render_tag(html, cursor, true);
+            break;
+        default:
+            write_range(html, start, end);
+            break;
+    }
+}
+
+// Renders the children of a paragraph or list_paragraph. Trailing spaces
+// are held back until the next element: at a line break, two or more of
+// them make a `<br>`, and otherwise they are dropped, as are spaces that
+// start a line.
+static void render_inlines(MarkdocHtmlRenderer *html, TSTreeCursor *cursor) {
+    const char *source = html->source;
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    uint32_t previous_end = ts_node_start_byte(node);
+    uint32_t held_start = 0, held_end = 0;
+    bool line_start = true;
+    if (!ts_tree_cursor_goto_first_child(cursor)) {
+        return;
+    }
+    do {
+        TSNode child = ts_tree_cursor_current_node(cursor);
+        if (!ts_node_is_named(child) || ts_node_is_missing(child)) {
+            continue;
+        }
+        uint32_t start = ts_node_start_byte(child), end = ts_node_end_byte(child);
+        if (memchr(source + previous_end, '\n', start - previous_end) != NULL) {
+            write_raw(html, held_end - held_start >= 2 ? "<br>\n" : "\n");
+            held_start = held_end = 0;
+            line_start = true;
+        } else {
+            write_range(html, held_start, held_end);
+            held_start = held_end = 0;
+            if (!line_start) {
+                write_range(html, previous_end, start);
+            }
+        }
+
+        if (ts_node_symbol(child) == MARKDOC_SYM_TEXT) {
+            uint32_t text_start = start, text_end = end;
+            while (line_start && text_start < text_end && markdoc_is_space(source[text_start])) {
+                text_start++;
+            }
+            while (text_end > text_start && markdoc_is_space(source[text_end - 1])) {
+                text_end--;
+            }
+            write_range(html, text_start, text_end);
+            held_start = text_end;
+            held_end = end;
+            line_start = line_start && text_start == text_end;
+        } else {
+            render_inline(html, cursor);
+            line_start = false;
+        }
+        previous_end = end;
+    } while (ts_tree_cursor_goto_next_sibling(cursor));
+    ts_tree_cursor_goto_parent(cursor);
+}
+
+// Blocks
+
+static void render_block(MarkdocHtmlRenderer *html, TSTreeCursor *cursor);
+
+// The bullet of an unordered list, or the `.` or `)` after an ordered list's
+// number. markdown-it starts a new list when it changes.
+static char list_delimiter(const char *source, TSNode list) {
+    TSNode marker = ts_node_child_by_field_id(ts_node_named_child(list, 0), MARKDOC_FIELD_MARKER);
+    for (uint32_t i = ts_node_start_byte(marker); i < ts_node_end_byte(marker); i++) {
+        if (!markdoc_is_space(source[i]) && (source[i] < '0' || source[i] > '9')) {
+            return source[i];
+        }
+    }
+    return '\0';
+}
+
+// Whether a blank line separates the text of `a` from the text of `b`.
+static bool blank_line_between(const char *source, TSNode a, TSNode b) {
+    uint32_t start = ts_node_end_byte(a), end = ts_node_start_byte(b);
+    trim_end(source, ts_node_start_byte(a), &start);
+    while (end < ts_node_end_byte(b) && (markdoc_is_space(source[end]) || source[end] == '\r' ||
+                                         source[end] == '\n')) {
+        end++;
+    }
+    uint32_t newlines = 0;
+    for (uint32_t i = start; i < end; i++) {
+        newlines += source[i] == '\n';
+    }
+    return newlines >= 2;
+}
+
+// markdown-it reads lists of one kind and delimiter with only blank lines
+// between them as one loose list, where this grammar ends a list at a blank
+// line. Returns the last list of the run that starts at `list`.
+static TSNode list_run_end(const char *source, TSNode list) {
+    TSSymbol symbol = ts_node_symbol(list);
+    char delimiter = list_delimiter(source, list);
+    for (TSNode next = ts_node_next_sibling(list);
+         !ts_node_is_null(next) && ts_node_symbol(next) == symbol &&
+         list_delimiter(source, next) == delimiter;
+         next = ts_node_next_sibling(next)) {
+        list = next;
+    }
+    return list;
+}
+
+// A list is loose when a blank line separates two of its items, or two of
+// the blocks in one item.
+static bool list_is_loose(const char *source, TSNode list, TSNode last) {
+    TSNode previous = {0};
+    for (;; list = ts_node_next_sibling(list)) {
+        uint32_t count = ts_node_named_child_count(list);
+        for (uint32_t i = 0; i < count; i++) {
+            TSNode item = ts_node_named_child(list, i);
+            if (!ts_node_is_null(previous) && blank_line_between(source, previous, item)) {
+                return true;
+            }
+            previous = item;
+            uint32_t children = ts_node_named_child_count(item);
+            for (uint32_t j = 1; j < children; j++) {
+                if (blank_line_between(source, ts_node_named_child(item, j - 1),
+                                       ts_node_named_child(item, j))) {
+                    return true;
+                }
+            }
+        }
+        if (ts_node_eq(list, last)) {
+            return false;
+        }
+    }
+}
+
+// Closes the paragraph render_item_blocks() left open, if any.
+static void close_item_text(MarkdocHtmlRenderer *html, bool loose, TSNode *text) {
+    if (!ts_node_is_null(*text)) {
+        write_raw(html, loose ? "</p>\n" : "\n");
+        *text = (TSNode){0};
+    }
+}
+
+// Renders the blocks of a list item, or of a continuation in one. The
+// grammar reads lines that continue an item's text as a continuation
+// paragraph, so a paragraph that follows `text`, the last one written,
+// without a blank line carries on with it. In a tight list, markdown-it
+// hides paragraphs: their text is not wrapped in <p>, and a block after it
+// starts on a line of its own.
+static void render_item_blocks(MarkdocHtmlRenderer *html, TSTreeCursor *cursor, bool loose,
+                               TSNode *text) {
+    if (!ts_tree_cursor_goto_first_child(cursor)) {
+        return;
+    }
+    do {
+        TSNode node = ts_tree_cursor_current_node(cursor);
+        TSSymbol symbol = ts_node_symbol(node);
+        if (!ts_node_is_named(node) || symbol == MARKDOC_SYM_UNORDERED_LIST_MARKER ||
+            symbol == MARKDOC_SYM_ORDERED_LIST_MARKER) {
+            continue;
+        }
+        if (symbol == MARKDOC_SYM_LIST_ITEM_CONTINUATION) {
+            render_item_blocks(html, cursor, loose, text);
+        } else if (symbol == MARKDOC_SYM_LIST_PARAGRAPH || symbol == MARKDOC_SYM_PARAGRAPH) {
+            if (!ts_node_is_null(*text) && !blank_line_between(html->source, *text, node)) {
+                write_raw(html, "\n");
+            } else {
+                close_item_text(html, loose, text);
+                if (loose) {
+                    write_raw(html, "<p>");
+                }
+            }
+            render_inlines(html, cursor);
+            *text = node;
+        } else {
+            close_item_text(html, loose, text);
+            render_block(html, cursor);
+        }
+    } while (ts_tree_cursor_goto_next_sibling(cursor));
+    ts_tree_cursor_goto_parent(cursor);
+}
+
+// Renders the list under the cursor, with the lists list_run_end() joins to
+// it, and leaves the cursor on the last of them.
+static void render_list(MarkdocHtmlRenderer *html, TSTreeCursor *cursor) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    bool ordered = ts_node_symbol(node) == MARKDOC_SYM_ORDERED_LIST;
+    TSNode last = list_run_end(html->source, node);
+    bool loose = list_is_loose(html->source, node, last);
+    if (ordered) {
+        TSNode marker =
+            ts_node_child_by_field_id(ts_node_named_child(node, 0), MARKDOC_FIELD_MARKER);
+        uint32_t number = 0;
+        for (uint32_t i = ts_node_start_byte(marker); i < ts_node_end_byte(marker); i++) {
+            char c = html->source[i];
+            if (c >= '0' && c <= '9') {
+                number = number * 10 + (uint32_t)(c - '0');
+            } else if (!markdoc_is_space(c)) {
+                break;
+            }
+        }
+        if (number != 1) {
+            char start[32];
+            snprintf(start, sizeof(start), "<ol start=\"%u\">\n", number);
+            write_raw(html, start);
+        } else {
+            write_raw(html, "<ol>\n");
+        }
+    } else {
+        write_raw(html, "<ul>\n");
+    }
+
+    for (;;) {
+        if (ts_tree_cursor_goto_first_child(cursor)) {
+            do {
+                TSSymbol symbol = ts_node_symbol(ts_tree_cursor_current_node(cursor));
+                if (symbol != MARKDOC_SYM_UNORDERED_LIST_ITEM &&
+                    symbol != MARKDOC_SYM_ORDERED_LIST_ITEM) {
+                    continue;
+                }
+                TSNode text = {0};
+                write_raw(html, loose ? "<li>\n" : "<li>");
+                render_item_blocks(html, cursor, loose, &text);
+                if (loose) {
+                    close_item_text(html, loose, &text);
+                }
+                write_raw(html, "</li>\n");
+            } while (ts_tree_cursor_goto_next_sibling(cursor));
+            ts_tree_cursor_goto_parent(cursor);
+        }
+        if (ts_node_eq(ts_tree_cursor_current_node(cursor), last) ||
+            !ts_tree_cursor_goto_next_sibling(cursor)) {
+            break;
+        }
+    }
+    write_raw(html, ordered ? "</ol>\n" : "</ul>\n");
+}
+
+// The grammar reads a blockquote as one token of `>` lines, so its contents
+// are not parsed as markdown. Each line loses its `>` and the spaces after
+// it, and the lines become paragraphs of escaped text that a line holding
+// only `>` separates.
+static void render_blockquote(MarkdocHtmlRenderer *html, TSNode node) {
+    const char *source = html->source;
+    uint32_t end = ts_node_end_byte(node);
+    bool paragraph = false;
+    write_raw(html, "<blockquote>\n");
+    for (uint32_t line = ts_node_start_byte(node); line < end;) {
+        uint32_t line_end = line;
+        while (line_end < end && source[line_end] != '\n') {
+            line_end++;
+        }
+        uint32_t text = line + (source[line] == '>');
+        while (text < line_end && markdoc_is_space(source[text])) {
+            text++;
+        }
+        uint32_t text_end = line_end;
+        trim_end(source, text, &text_end);
+        if (text == text_end) {
+            if (paragraph) {
+                write_raw(html, "</p>\n");
+            }
+            paragraph = false;
+        } else {
+            write_raw(html, paragraph ? "\n" : "<p>");
+            write_range(html, text, text_end);
+            paragraph = true;
+        }
+        line = line_end + 1;
+    }
+    if (paragraph) {
+        write_raw(html, "</p>\n");
+    }
+    write_raw(html, "</blockquote>\n");
+}
+
+static void render_fence(MarkdocHtmlRenderer *html, TSNode node) {
+    TSNode open = ts_node_child_by_field_id(node, MARKDOC_FIELD_OPEN);
+    TSNode code = ts_node_child_by_field_id(node, MARKDOC_FIELD_CODE);
+    TSNode close = ts_node_child_by_field_id(node, MARKDOC_FIELD_CLOSE);
+    TSNode info = ts_node_named_child(open, 0);
+    TSNode language = {0};
+    if (!ts_node_is_null(info) && ts_node_symbol(info) == MARKDOC_SYM_INFO_STRING) {
+        language = ts_node_named_child(info, 0);
+    }
+
+    if (!ts_node_is_null(language) && ts_node_symbol(language) == MARKDOC_SYM_LANGUAGE) {
+        write_raw(html, "<pre><code class=\"language-");
+        write_node(html, language);
+        write_raw(html, "\">");
+    } else {
+        write_raw(html, "<pre><code>");
+    }
+    if (!ts_node_is_null(code)) {
+        uint32_t end = ts_node_is_null(close) ? ts_node_end_byte(code) : ts_node_start_byte(close);
+        write_range(html, ts_node_start_byte(code), end);
+    }
+    write_raw(html, "</code></pre>\n");
+}
+
+static void render_block(MarkdocHtmlRenderer *html, TSTreeCursor *cursor) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    uint32_t start = ts_node_start_byte(node), end = ts_node_end_byte(node);
+
+    switch (ts_node_symbol(node)) {
+        case MARKDOC_SYM_HEADING: {
+            TSNode marker = ts_node_child_by_field_id(node, MARKDOC_FIELD_HEADING_MARKER);
+            TSNode text = ts_node_child_by_field_id(node, MARKDOC_FIELD_HEADING_TEXT);
+            char open[8], close[8];
+            uint32_t level = 0;
+            for (uint32_t i = ts_node_start_byte(marker); i < ts_node_end_byte(marker); i++) {
+                level += html->source[i] == '#';
+            }
+            snprintf(open, sizeof(open), "<h%u>", level);
+            snprintf(close, sizeof(close), "</h%u>\n", level);
+            write_raw(html, open);
+            if (!ts_node_is_null(text)) {
+                uint32_t text_end = ts_node_end_byte(text);
+                trim_end(html->source, ts_node_start_byte(text), &text_end);
+                render_inline_text(html, ts_node_start_byte(text), text_end);
+            }
+            write_raw(html, close);
+            break;
+        }
+        case MARKDOC_SYM_PARAGRAPH:
+            write_raw(html, "<p>");
+            render_inlines(html, cursor);
+            write_raw(html, "</p>\n");
+            break;
+        case MARKDOC_SYM_HTML_BLOCK:
+        case MARKDOC_SYM_HTML_COMMENT:
+            trim_end(html->source, start, &end);
+            markdoc_html_write(html, html->source + start, end - start);
+            write_raw(html, "\n");
+            break;
+        case MARKDOC_SYM_THEMATIC_BREAK:
+            write_raw(html, "<hr>\n");
+            break;
+        case MARKDOC_SYM_BLOCKQUOTE:
+            render_blockquote(html, node);
+            break;
+        case MARKDOC_SYM_FENCED_CODE_BLOCK:
+            render_fence(html, node);
+            break;
+        case MARKDOC_SYM_MARKDOC_TAG:
+            render_tag(html, cursor, false);
+            break;
+        case MARKDOC_SYM_UNORDERED_LIST:
+        case MARKDOC_SYM_ORDERED_LIST:
+            render_list(html, cursor);
+            break;
+        case MARKDOC_SYM_ERROR:
+            write_raw(html, "<p>");
+            trim_end(html->source, start, &end);
+            write_range(html, start, end);
+            write_raw(html, "</p>\n");
+            break;
+        default:
+            break;
+    }
+}
+
+static void render_blocks(MarkdocHtmlRenderer *html, TSTreeCursor *cursor) {
+    if (!ts_tree_cursor_goto_first_child(cursor)) {
+        return;
+    }
+    do {
+        render_block(html, cursor);
+    } while (ts_tree_cursor_goto_next_sibling(cursor));
+    ts_tree_cursor_goto_parent(cursor);
+}
+
+bool markdoc_render_html(TSNode node, const char *source, const MarkdocHtmlOptions *options,
+                         MarkdocWriter writer) {
+    if (ts_node_is_null(node) || !markdoc_symbols_match(ts_node_language(node))) {
+        return false;
+    }
+    MarkdocHtmlRenderer *html = malloc(sizeof(MarkdocHtmlRenderer));
+    if (html == NULL) {
+        return false;
+    }
+    markdoc_output_init(&html->output, writer);
+    html->source = source;
+    html->options = options;
+
+    TSTreeCursor cursor = ts_tree_cursor_new(node);
+    render_blocks(html, &cursor);
+    ts_tree_cursor_delete(&cursor);
+
+    markdoc_output_flush(&html->output);
+    bool ok = !html->output.failed;
+    free(html);
+    return ok;
+}
@@ -0,0 +1,107 @@
+// Bookkeeping shared by the indexes that follow a tree through edits
+// (fences.c, links.c, blocks.c). Each keeps the [start, end) byte ranges
+// edited since its last build or update as pairs in an `edited` array, and
+// an update walks only what those ranges and ts_tree_get_changed_ranges()
+// cover, copying the entries of the old index everywhere else.
+
+#ifndef TREE_SITTER_MARKDOC_INCREMENTAL_H_
+#define TREE_SITTER_MARKDOC_INCREMENTAL_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+
+// Room for this many edited ranges is allocated up front, so that
+// markdoc_edited_add() can always record at least one.
+#define MARKDOC_EDITED_INITIAL_CAPACITY 4
+
+// Moves a byte offset of the old text to the edited text, as ts_tree_edit()
+// does for the tree's nodes.
+static inline uint32_t markdoc_shift(uint32_t position, const TSInputEdit *edit) {
+    if (position >= edit->old_end_byte) {
+        return position - edit->old_end_byte + edit->new_end_byte;
+    }
+    if (position > edit->start_byte && position > edit->new_end_byte) {
+        return edit->new_end_byte;
+    }
+    return position;
+}
+
+static inline uint32_t *markdoc_edited_new(void) {
+    return malloc(MARKDOC_EDITED_INITIAL_CAPACITY * 2 * sizeof(uint32_t));
+}
+
+// Shifts the recorded ranges for `edit` and records the range it inserted.
+static inline void markdoc_edited_add(uint32_t **edited, uint32_t *count, uint32_t *capacity,
+                                      const TSInputEdit *edit) {
+    for (uint32_t i = 0; i < 2 * *count; i++) {
+        (*edited)[i] = markdoc_shift((*edited)[i], edit);
+    }
+
+    if (*count == *capacity) {
+        uint32_t grown_capacity = *capacity ? *capacity * 2 : MARKDOC_EDITED_INITIAL_CAPACITY;
+        uint32_t *grown = realloc(*edited, 2 * grown_capacity * sizeof(uint32_t));
+        if (grown == NULL) {
+            // Without room to remember the edit, assume the whole document
+            // changed.
+            *count = 1;
+            (*edited)[0] = 0;
+            (*edited)[1] = UINT32_MAX;
+            return;
+        }
+        *edited = grown;
+        *capacity = grown_capacity;
+    }
+    (*edited)[2 * *count] = edit->start_byte;
+    (*edited)[2 * *count + 1] = edit->new_end_byte;
+    (*count)++;
+}
+
+// Whether [start, end) may differ from what the old index saw. An edit that
+// only deleted text leaves an empty range, which counts when it falls
+// strictly inside.
+static inline bool markdoc_is_dirty(const TSRange *changed, uint32_t changed_count,
+                                    const uint32_t *edited, uint32_t edited_count,
+                                    uint32_t start, uint32_t end) {
+    for (uint32_t i = 0; i < changed_count; i++) {
+        if (changed[i].start_byte < end && changed[i].end_byte > start) {
+            return true;
+        }
+    }
+    for (uint32_t i = 0; i < edited_count; i++) {
+        uint32_t edit_start = edited[2 * i], edit_end = edited[2 * i + 1];
+        if (edit_start == edit_end ? edit_start > start && edit_start < end
+                                   : edit_start < end && edit_end > start) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The first of `count` entries, sorted by their uint32_t `start_byte` at
+// `offset`, that starts at or after `start`.
+static inline uint32_t markdoc_first_starting_at(const void *entries, size_t size, size_t offset,
+                                                 uint32_t count, uint32_t start) {
+    uint32_t low = 0, high = count;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        uint32_t middle_start;
+        memcpy(&middle_start, (const char *)entries + middle * size + offset, sizeof(uint32_t));
+        if (middle_start < start) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+#define MARKDOC_FIRST_STARTING_AT(type, entries, count, start)                                \
+    markdoc_first_starting_at((entries), sizeof(type), offsetof(type, start_byte), (count), \
+                              (start))
+
+#endif // TREE_SITTER_MARKDOC_INCREMENTAL_H_
@@ -0,0 +1,171 @@
+// Inline span scanning shared by the native API. heading_text, link_text
+// and the emphasis and strong tokens are single tokens in the grammar, so
+// the markup inside them has no nodes. markdoc_next_span() finds it with the
+// grammar's own inline token rules, which never cross a line, plus
+// CommonMark code spans of any backtick count, which the grammar's
+// single-backtick inline_code cannot express.
+
+#ifndef TREE_SITTER_MARKDOC_INLINES_H_
+#define TREE_SITTER_MARKDOC_INLINES_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lines.h"
+
+typedef enum {
+    MARKDOC_SPAN_EMPHASIS,
+    MARKDOC_SPAN_STRONG,
+    MARKDOC_SPAN_CODE,
+    MARKDOC_SPAN_LINK,
+    MARKDOC_SPAN_IMAGE,
+} MarkdocSpanKind;
+
+typedef struct {
+    MarkdocSpanKind kind;
+    uint32_t start;
+    uint32_t end;
+    // The text between the markers, a code span's code, or a link's text or
+    // an image's alt between the brackets.
+    uint32_t content_start;
+    uint32_t content_end;
+    // A link's or image's destination between the parentheses.
+    uint32_t destination_start;
+    uint32_t destination_end;
+} MarkdocSpan;
+
+// The end of the span of `marker` (1 for emphasis, 2 for strong) `*` or `_`
+// characters at `at`, as in /\*[^\s*][^*\n]*[^\s*]\*/ and the rules beside
+// it, or 0. An `_` span must not start or end inside a word.
+static inline uint32_t markdoc_delimited_end(const char *source, uint32_t at, uint32_t end,
+                                             uint32_t marker) {
+    char c = source[at];
+    uint32_t content = at + marker;
+    if (content + 1 + marker > end || (marker == 2 && source[at + 1] != c) ||
+        markdoc_is_space(source[content]) || source[content] == c ||
+        (c == '_' && at > 0 && markdoc_is_identifier_char(source[at - 1]))) {
+        return 0;
+    }
+    uint32_t close = content + 1;
+    while (close < end && source[close] != c) {
+        close++;
+    }
+    if (close + marker > end || markdoc_is_space(source[close - 1]) ||
+        (marker == 2 && source[close + 1] != c) ||
+        (c == '_' && close + marker < end && markdoc_is_identifier_char(source[close + marker]))) {
+        return 0;
+    }
+    return close + marker;
+}
+
+// The end of the `opener`...`closer` span at `at` with non-empty contents
+// free of `closer`, or 0.
+static inline uint32_t markdoc_bracketed_end(const char *source, uint32_t at, uint32_t end,
+                                             char closer) {
+    uint32_t close = at + 1;
+    while (close < end && source[close] != closer) {
+        close++;
+    }
+    return close < end && close > at + 1 ? close + 1 : 0;
+}
+
+// The number of `c` characters from `at`.
+static inline uint32_t markdoc_run_length(const char *source, uint32_t at, uint32_t end,
+                                          char c) {
+    uint32_t run = at;
+    while (run < end && source[run] == c) {
+        run++;
+    }
+    return run - at;
+}
+
+// The end of the code span opened by the backtick run at `at`, which a run
+// of the same length closes, or 0. The code is the text between the runs,
+// less one space on each side when it has one on both and is not all spaces.
+static inline uint32_t markdoc_code_span_end(const char *source, uint32_t at, uint32_t end,
+                                             uint32_t *code_start, uint32_t *code_end) {
+    uint32_t length = markdoc_run_length(source, at, end, '`');
+    for (uint32_t close = at + length; close < end;) {
+        if (source[close] != '`') {
+            close++;
+            continue;
+        }
+        uint32_t run = markdoc_run_length(source, close, end, '`');
+        if (run == length) {
+            *code_start = at + length;
+            *code_end = close;
+            if (*code_end - *code_start >= 2 && source[*code_start] == ' ' &&
+                source[*code_end - 1] == ' ' &&
+                markdoc_run_length(source, *code_start, *code_end, ' ') <
+                    *code_end - *code_start) {
+                (*code_start)++;
+                (*code_end)--;
+            }
+            return close + run;
+        }
+        close += run;
+    }
+    return 0;
+}
+
+// Finds the first span that starts in the single-line range [at, end).
+static inline bool markdoc_next_span(const char *source, uint32_t at, uint32_t end,
+                                     MarkdocSpan *span) {
+    while (at < end) {
+        char c = source[at];
+        if (c == '*' || c == '_') {
+            for (uint32_t marker = 2; marker >= 1; marker--) {
+                uint32_t span_end = markdoc_delimited_end(source, at, end, marker);
+                if (span_end != 0) {
+                    *span = (MarkdocSpan){
+                        .kind = marker == 2 ? MARKDOC_SPAN_STRONG : MARKDOC_SPAN_EMPHASIS,
+                        .start = at,
+                        .end = span_end,
+                        .content_start = at + marker,
+                        .content_end = span_end - marker,
+                    };
+                    return true;
+                }
+            }
+        } else if (c == '`') {
+            uint32_t code_start, code_end;
+            uint32_t span_end = markdoc_code_span_end(source, at, end, &code_start, &code_end);
+            if (span_end != 0) {
+                *span = (MarkdocSpan){
+                    .kind = MARKDOC_SPAN_CODE,
+                    .start = at,
+                    .end = span_end,
+                    .content_start = code_start,
+                    .content_end = code_end,
+                };
+                return true;
+            }
+            // An unmatched run is literal text, backticks after it included.
+            at += markdoc_run_length(source, at, end, '`');
+            continue;
+        } else if (c == '[' || (c == '!' && at + 1 < end && source[at + 1] == '[')) {
+            uint32_t label = at + (c == '!');
+            uint32_t label_end = markdoc_bracketed_end(source, label, end, ']');
+            uint32_t span_end = 0;
+            if (label_end != 0 && label_end < end && source[label_end] == '(') {
+                span_end = markdoc_bracketed_end(source, label_end, end, ')');
+            }
+            if (span_end != 0) {
+                *span = (MarkdocSpan){
+                    .kind = c == '!' ? MARKDOC_SPAN_IMAGE : MARKDOC_SPAN_LINK,
+                    .start = at,
+                    .end = span_end,
+                    .content_start = label + 1,
+                    .content_end = label_end - 1,
+                    .destination_start = label_end + 1,
+                    .destination_end = span_end - 1,
+                };
+                return true;
+            }
+        }
+        at++;
+    }
+    return false;
+}
+
+#endif // TREE_SITTER_MARKDOC_INLINES_H_
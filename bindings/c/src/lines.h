@@ -0,0 +1,110 @@
+// Line classifiers shared by the native API, for code that needs to know
+// where blocks start without running the parser. Tag lines go through the
+// scanner's own classifier in src/scanner.h; the rest mirror src/scanner.c
+// on plain buffers.
+
+#ifndef TREE_SITTER_MARKDOC_LINES_H_
+#define TREE_SITTER_MARKDOC_LINES_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "scanner.h"
+
+static inline bool markdoc_is_space(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static inline bool markdoc_is_identifier_start(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static inline bool markdoc_is_identifier_char(char c) {
+    return markdoc_is_identifier_start(c) || (c >= '0' && c <= '9');
+}
+
+// Returns the end of the line starting at `line`, excluding its line break.
+static inline const char *markdoc_line_end(const char *line, const char *end) {
+    const char *newline = memchr(line, '\n', (size_t)(end - line));
+    const char *eol = newline != NULL ? newline : end;
+    if (eol > line && eol[-1] == '\r') {
+        eol--;
+    }
+    return eol;
+}
+
+static inline bool markdoc_line_is_blank(const char *line, const char *eol) {
+    while (line < eol && markdoc_is_space(*line)) {
+        line++;
+    }
+    return line == eol;
+}
+
+// A `---` line, which opens or closes frontmatter.
+static inline bool markdoc_line_is_frontmatter_delimiter(const char *line, const char *eol) {
+    if (eol - line < 3 || memcmp(line, "---", 3) != 0) {
+        return false;
+    }
+    return markdoc_line_is_blank(line + 3, eol);
+}
+
+// A code fence: three or more backticks or tildes at the start of the line,
+// as in scan_fence_marker(). Like the scanner, it counts at most
+// MAX_FENCE_LENGTH markers and leaves the rest on the line, so a longer run
+// opens a fence of that length and cannot close one.
+static inline bool markdoc_line_fence(const char *line, const char *eol, char *fence_char,
+                                      uint32_t *fence_length) {
+    if (line == eol || (*line != '`' && *line != '~')) {
+        return false;
+    }
+    const char *cursor = line;
+    while (cursor < eol && *cursor == *line && cursor - line < MAX_FENCE_LENGTH) {
+        cursor++;
+    }
+    if (cursor - line < 3) {
+        return false;
+    }
+    *fence_char = *line;
+    *fence_length = (uint32_t)(cursor - line);
+    return true;
+}
+
+// Whether the line closes a fence opened with `fence_char` x `fence_length`.
+static inline bool markdoc_line_closes_fence(const char *line, const char *eol, char fence_char,
+                                             uint32_t fence_length) {
+    char marker;
+    uint32_t length;
+    if (!markdoc_line_fence(line, eol, &marker, &length)) {
+        return false;
+    }
+    return marker == fence_char && length == fence_length &&
+           markdoc_line_is_blank(line + length, eol);
+}
+
+typedef struct {
+    const char *cursor;
+    const char *end;
+} MarkdocLineReader;
+
+static inline int32_t markdoc_line_reader_lookahead(void *payload) {
+    MarkdocLineReader *reader = payload;
+    return reader->cursor < reader->end ? (unsigned char)*reader->cursor : 0;
+}
+
+static inline void markdoc_line_reader_advance(void *payload) {
+    MarkdocLineReader *reader = payload;
+    if (reader->cursor < reader->end) {
+        reader->cursor++;
+    }
+}
+
+// Classifies a `{%` line with the scanner's own markdoc_scan_tag_line().
+static inline MarkdocTagLine markdoc_line_tag(const char *line, const char *eol) {
+    MarkdocLineReader state = {line, eol};
+    MarkdocCharReader reader = {markdoc_line_reader_lookahead, markdoc_line_reader_advance,
+                                &state};
+    return markdoc_scan_tag_line(&reader);
+}
+
+#endif // TREE_SITTER_MARKDOC_LINES_H_
@@ -0,0 +1,472 @@
+#include "tree_sitter/markdoc/links.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "incremental.h"
+#include "inlines.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+typedef struct {
+    // The index being updated, or NULL for a build, which walks everything.
+    const MarkdocLinkIndex *old;
+    const TSRange *changed;
+    uint32_t changed_count;
+    const char *source;
+    // Interns destinations; the same as `old` in an update.
+    MarkdocLinkIndex *index;
+    MarkdocLink *links;
+    uint32_t count;
+    uint32_t capacity;
+} Walk;
+
+// Destinations
+
+static uint32_t hash_destination(const char *destination, uint32_t length) {
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)destination[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// The slot holding `destination`, or the empty slot where it belongs.
+static uint32_t *find_slot(const MarkdocLinkIndex *index, const char *destination,
+                           uint32_t length) {
+    uint32_t mask = index->slot_capacity - 1;
+    for (uint32_t i = hash_destination(destination, length) & mask;; i = (i + 1) & mask) {
+        uint32_t *slot = &index->slots[i];
+        if (*slot == 0) {
+            return slot;
+        }
+        const char *other = index->destinations + index->destination_offsets[*slot - 1];
+        if (memcmp(other, destination, length) == 0 && other[length] == '\0') {
+            return slot;
+        }
+    }
+}
+
+// Keeps the table at most half full.
+static bool grow_slots(MarkdocLinkIndex *index) {
+    if (index->destination_count * 2 < index->slot_capacity) {
+        return true;
+    }
+    uint32_t capacity = index->slot_capacity ? index->slot_capacity * 2 : 64;
+    uint32_t *slots = calloc(capacity, sizeof(uint32_t));
+    if (slots == NULL) {
+        return false;
+    }
+    free(index->slots);
+    index->slots = slots;
+    index->slot_capacity = capacity;
+    for (uint32_t id = 0; id < index->destination_count; id++) {
+        const char *destination = index->destinations + index->destination_offsets[id];
+        *find_slot(index, destination, (uint32_t)strlen(destination)) = id + 1;
+    }
+    return true;
+}
+
+// Returns the id of [destination, destination + length), adding it if it
+// is new, or MARKDOC_LINK_NO_DESTINATION when out of memory.
+static uint32_t intern(MarkdocLinkIndex *index, const char *destination, uint32_t length) {
+    if (!grow_slots(index)) {
+        return MARKDOC_LINK_NO_DESTINATION;
+    }
+    uint32_t *slot = find_slot(index, destination, length);
+    if (*slot != 0) {
+        return *slot - 1;
+    }
+
+    if (index->destination_count == index->destination_capacity) {
+        uint32_t capacity = index->destination_capacity ? index->destination_capacity * 2 : 32;
+        uint32_t *grown = realloc(index->destination_offsets, capacity * sizeof(uint32_t));
+        if (grown == NULL) {
+            return MARKDOC_LINK_NO_DESTINATION;
+        }
+        index->destination_offsets = grown;
+        index->destination_capacity = capacity;
+    }
+    if (index->destinations_length + length + 1 > index->destinations_capacity) {
+        uint32_t capacity = index->destinations_capacity ? index->destinations_capacity : 256;
+        while (capacity < index->destinations_length + length + 1) {
+            capacity *= 2;
+        }
+        char *grown = realloc(index->destinations, capacity);
+        if (grown == NULL) {
+            return MARKDOC_LINK_NO_DESTINATION;
+        }
+        index->destinations = grown;
+        index->destinations_capacity = capacity;
+    }
+    memcpy(index->destinations + index->destinations_length, destination, length);
+    index->destinations[index->destinations_length + length] = '\0';
+    index->destination_offsets[index->destination_count] = index->destinations_length;
+    index->destinations_length += length + 1;
+    *slot = index->destination_count + 1;
+    return index->destination_count++;
+}
+
+// Drops the destinations no link points to any more once they are more
+// than half of the table, renumbering the others in order of first use so
+// that edits which keep changing URLs do not grow the table without bound.
+// Out of memory, the table is left as it is.
+static void compact_destinations(MarkdocLinkIndex *index, MarkdocLink *links, uint32_t count) {
+    index->renumbered = false;
+    uint32_t *ids = malloc((index->destination_count + 1) * sizeof(uint32_t));
+    if (ids == NULL) {
+        return;
+    }
+    memset(ids, 0xff, (index->destination_count + 1) * sizeof(uint32_t));
+    uint32_t live = 0, live_length = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t id = links[i].destination;
+        if (ids[id] == MARKDOC_LINK_NO_DESTINATION) {
+            ids[id] = live++;
+            live_length += (uint32_t)strlen(index->destinations +
+                                            index->destination_offsets[id]) + 1;
+        }
+    }
+    if (live * 2 >= index->destination_count) {
+        free(ids);
+        return;
+    }
+    char *destinations = malloc(live_length + 1);
+    uint32_t *offsets = malloc((live + 1) * sizeof(uint32_t));
+    if (destinations == NULL || offsets == NULL) {
+        free(offsets);
+        free(destinations);
+        free(ids);
+        return;
+    }
+
+    uint32_t length = 0;
+    for (uint32_t id = 0; id < index->destination_count; id++) {
+        if (ids[id] == MARKDOC_LINK_NO_DESTINATION) {
+            continue;
+        }
+        const char *destination = index->destinations + index->destination_offsets[id];
+        uint32_t size = (uint32_t)strlen(destination) + 1;
+        memcpy(destinations + length, destination, size);
+        offsets[ids[id]] = length;
+        length += size;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        links[i].destination = ids[links[i].destination];
+    }
+    free(index->destinations);
+    free(index->destination_offsets);
+    index->destinations = destinations;
+    index->destinations_length = length;
+    index->destinations_capacity = live_length + 1;
+    index->destination_offsets = offsets;
+    index->destination_count = live;
+    index->destination_capacity = live + 1;
+    memset(index->slots, 0, index->slot_capacity * sizeof(uint32_t));
+    for (uint32_t id = 0; id < live; id++) {
+        const char *destination = destinations + offsets[id];
+        *find_slot(index, destination, (uint32_t)strlen(destination)) = id + 1;
+    }
+    index->renumbered = true;
+    free(ids);
+}
+
+// Walking
+
+static bool push_link(Walk *walk, MarkdocLink link) {
+    if (walk->count == walk->capacity) {
+        uint32_t capacity = walk->capacity ? walk->capacity * 2 : 16;
+        MarkdocLink *grown = realloc(walk->links, capacity * sizeof(MarkdocLink));
+        if (grown == NULL) {
+            return false;
+        }
+        walk->links = grown;
+        walk->capacity = capacity;
+    }
+    walk->links[walk->count++] = link;
+    return true;
+}
+
+// Whether [start, end) may differ from what the old index saw.
+static bool is_dirty(const Walk *walk, uint32_t start, uint32_t end) {
+    return walk->old == NULL ||
+           markdoc_is_dirty(walk->changed, walk->changed_count, walk->old->edited,
+                            walk->old->edited_count, start, end);
+}
+
+// Copies the old links that start in [start, end), unchanged.
+static bool keep_links(Walk *walk, uint32_t start, uint32_t end) {
+    const MarkdocLink *links = walk->old->links;
+    uint32_t low = MARKDOC_FIRST_STARTING_AT(MarkdocLink, links, walk->old->count, start);
+    for (uint32_t i = low; i < walk->old->count && links[i].start_byte < end; i++) {
+        MarkdocLink link = links[i];
+        link.changed = false;
+        if (!push_link(walk, link)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool ends_with(const char *name, uint32_t length, const char *suffix) {
+    uint32_t suffix_length = (uint32_t)strlen(suffix);
+    if (length < suffix_length) {
+        return false;
+    }
+    for (uint32_t i = 0; i < suffix_length; i++) {
+        char c = name[length - suffix_length + i];
+        if ((c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c) != suffix[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Adds the link or image [start, end) whose text or alt is [text_start,
+// text_end), reading its destination from [start_destination,
+// end_destination): `destination "title"`.
+static bool add_link(Walk *walk, MarkdocLinkKind kind, uint32_t start, uint32_t end,
+                     uint32_t text_start, uint32_t text_end, uint32_t destination_start,
+                     uint32_t destination_end) {
+    const char *source = walk->source;
+    uint32_t url_start = destination_start, url_end = destination_end;
+    while (url_start < url_end && (source[url_start] == ' ' || source[url_start] == '\t')) {
+        url_start++;
+    }
+    if (url_start < url_end && source[url_start] == '<') {
+        const char *close = memchr(source + url_start, '>', url_end - url_start);
+        if (close != NULL) {
+            url_start++;
+            url_end = (uint32_t)(close - source);
+        }
+    } else {
+        uint32_t at = url_start;
+        while (at < url_end && source[at] != ' ' && source[at] != '\t') {
+            at++;
+        }
+        url_end = at;
+    }
+
+    uint32_t id = intern(walk->index, source + url_start, url_end - url_start);
+    return id != MARKDOC_LINK_NO_DESTINATION &&
+           push_link(walk, (MarkdocLink){
+                               .kind = kind,
+                               .start_byte = start,
+                               .end_byte = end,
+                               .text_start = text_start,
+                               .text_end = text_end,
+                               .destination_start = url_start,
+                               .destination_end = url_end,
+                               .destination = id,
+                               .changed = true,
+                           });
+}
+
+// Reads the link or image `node`: [text](destination "title").
+static bool add_link_node(Walk *walk, TSNode node, MarkdocLinkKind kind) {
+    TSNode text = ts_node_named_child(node, 0);
+    TSNode destination = ts_node_named_child(node, 1);
+    if (ts_node_is_null(destination)) {
+        return true;
+    }
+    return add_link(walk, kind, ts_node_start_byte(node), ts_node_end_byte(node),
+                    ts_node_start_byte(text), ts_node_end_byte(text),
+                    ts_node_start_byte(destination), ts_node_end_byte(destination));
+}
+
+// Reads the links and images in [start, end) of a heading_text, emphasis,
+// strong or blockquote token, which the grammar leaves without inline nodes,
+// one line at a time.
+static bool add_spans(Walk *walk, uint32_t start, uint32_t end) {
+    const char *source = walk->source;
+    while (start < end) {
+        const char *newline = memchr(source + start, '\n', end - start);
+        uint32_t line_end = newline != NULL ? (uint32_t)(newline - source) : end;
+        MarkdocSpan span;
+        for (uint32_t at = start; markdoc_next_span(source, at, line_end, &span); at = span.end) {
+            bool ok = true;
+            if (span.kind == MARKDOC_SPAN_LINK || span.kind == MARKDOC_SPAN_IMAGE) {
+                ok = add_link(walk, span.kind == MARKDOC_SPAN_LINK ? MARKDOC_LINK
+                                                                   : MARKDOC_LINK_IMAGE,
+                              span.start, span.end, span.content_start, span.content_end,
+                              span.destination_start, span.destination_end);
+            } else if (span.kind != MARKDOC_SPAN_CODE) {
+                ok = add_spans(walk, span.content_start, span.content_end);
+            }
+            if (!ok) {
+                return false;
+            }
+        }
+        start = line_end + 1;
+    }
+    return true;
+}
+
+// Reads the attribute `node` if it is link-like: `href="..."`.
+static bool add_attribute(Walk *walk, TSNode node) {
+    TSNode name = ts_node_named_child(node, 0);
+    const char *text = walk->source + ts_node_start_byte(name);
+    uint32_t length = ts_node_end_byte(name) - ts_node_start_byte(name);
+    if (!ends_with(text, length, "href") && !ends_with(text, length, "src") &&
+        !ends_with(text, length, "url")) {
+        return true;
+    }
+    // attribute_value > value_expression > json_value > string
+    TSNode value = ts_node_named_child(ts_node_named_child(ts_node_named_child(node, 1), 0), 0);
+    TSNode string = ts_node_named_child(value, 0);
+    if (ts_node_symbol(value) != MARKDOC_SYM_JSON_VALUE ||
+        ts_node_symbol(string) != MARKDOC_SYM_STRING || ts_node_has_error(string)) {
+        return true;
+    }
+    uint32_t start = ts_node_start_byte(string) + 1, end = ts_node_end_byte(string) - 1;
+    uint32_t id = intern(walk->index, walk->source + start, end - start);
+    return id != MARKDOC_LINK_NO_DESTINATION &&
+           push_link(walk, (MarkdocLink){
+                               .kind = MARKDOC_LINK_ATTRIBUTE,
+                               .start_byte = ts_node_start_byte(node),
+                               .end_byte = ts_node_end_byte(node),
+                               .text_start = ts_node_start_byte(name),
+                               .text_end = ts_node_end_byte(name),
+                               .destination_start = start,
+                               .destination_end = end,
+                               .destination = id,
+                               .changed = true,
+                           });
+}
+
+// Nodes that cannot contain a link, so the walk steps over them.
+static bool is_opaque(TSSymbol symbol) {
+    switch (symbol) {
+        case MARKDOC_SYM_FRONTMATTER:
+        case MARKDOC_SYM_FENCED_CODE_BLOCK:
+        case MARKDOC_SYM_HTML_BLOCK:
+        case MARKDOC_SYM_HTML_COMMENT:
+        case MARKDOC_SYM_HTML_INLINE:
+        case MARKDOC_SYM_THEMATIC_BREAK:
+        case MARKDOC_SYM_COMMENT_BLOCK:
+        case MARKDOC_SYM_TEXT:
+        case MARKDOC_SYM_INLINE_CODE:
+        case MARKDOC_SYM_INLINE_EXPRESSION:
+        case MARKDOC_SYM_TAG_CLOSE:
+        case MARKDOC_SYM_TAG_NAME:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool visit(Walk *walk, TSTreeCursor *cursor) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    TSSymbol symbol = ts_node_symbol(node);
+    if (!ts_node_is_named(node) || is_opaque(symbol)) {
+        return true;
+    }
+    uint32_t start = ts_node_start_byte(node), end = ts_node_end_byte(node);
+    if (!is_dirty(walk, start, end)) {
+        return keep_links(walk, start, end);
+    }
+    switch (symbol) {
+        case MARKDOC_SYM_LINK: return add_link_node(walk, node, MARKDOC_LINK);
+        case MARKDOC_SYM_IMAGE: return add_link_node(walk, node, MARKDOC_LINK_IMAGE);
+        case MARKDOC_SYM_ATTRIBUTE: return add_attribute(walk, node);
+        case MARKDOC_SYM_HEADING_TEXT:
+        case MARKDOC_SYM_EMPHASIS:
+        case MARKDOC_SYM_STRONG:
+        case MARKDOC_SYM_BLOCKQUOTE: return add_spans(walk, start, end);
+        default: break;
+    }
+
+    bool ok = true;
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            ok = visit(walk, cursor);
+        } while (ok && ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    return ok;
+}
+
+static bool run(Walk *walk, TSNode node) {
+    if (ts_node_is_null(node)) {
+        return true;
+    }
+    TSTreeCursor cursor = ts_tree_cursor_new(node);
+    bool ok = visit(walk, &cursor);
+    ts_tree_cursor_delete(&cursor);
+    return ok;
+}
+
+bool markdoc_link_index_build(TSNode node, const char *source, MarkdocLinkIndex *index) {
+    *index = (MarkdocLinkIndex){0};
+    if (!ts_node_is_null(node) && !markdoc_symbols_match(ts_node_language(node))) {
+        return false;
+    }
+    Walk walk = {.source = source, .index = index};
+    // markdoc_link_index_edit() relies on room for one edited range.
+    index->edited = markdoc_edited_new();
+    index->edited_capacity = MARKDOC_EDITED_INITIAL_CAPACITY;
+    if (index->edited == NULL || !grow_slots(index) || !run(&walk, node)) {
+        free(walk.links);
+        markdoc_link_index_delete(index);
+        return false;
+    }
+    index->links = walk.links;
+    index->count = walk.count;
+    index->capacity = walk.capacity;
+    return true;
+}
+
+void markdoc_link_index_edit(MarkdocLinkIndex *index, const TSInputEdit *edit) {
+    for (uint32_t i = 0; i < index->count; i++) {
+        MarkdocLink *link = &index->links[i];
+        link->start_byte = markdoc_shift(link->start_byte, edit);
+        link->end_byte = markdoc_shift(link->end_byte, edit);
+        link->text_start = markdoc_shift(link->text_start, edit);
+        link->text_end = markdoc_shift(link->text_end, edit);
+        link->destination_start = markdoc_shift(link->destination_start, edit);
+        link->destination_end = markdoc_shift(link->destination_end, edit);
+    }
+    markdoc_edited_add(&index->edited, &index->edited_count, &index->edited_capacity, edit);
+}
+
+bool markdoc_link_index_update(MarkdocLinkIndex *index, TSNode node, const char *source,
+                               const TSRange *changed, uint32_t changed_count) {
+    if (!ts_node_is_null(node) && !markdoc_symbols_match(ts_node_language(node))) {
+        return false;
+    }
+    Walk walk = {
+        .old = index,
+        .changed = changed,
+        .changed_count = changed_count,
+        .source = source,
+        .index = index,
+    };
+    if (!run(&walk, node)) {
+        free(walk.links);
+        return false;
+    }
+    compact_destinations(index, walk.links, walk.count);
+    free(index->links);
+    index->links = walk.links;
+    index->count = walk.count;
+    index->capacity = walk.capacity;
+    index->edited_count = 0;
+    return true;
+}
+
+uint32_t markdoc_link_index_find(const MarkdocLinkIndex *index, const char *destination,
+                                 uint32_t length) {
+    if (index->slot_capacity == 0) {
+        return MARKDOC_LINK_NO_DESTINATION;
+    }
+    uint32_t slot = *find_slot(index, destination, length);
+    return slot != 0 ? slot - 1 : MARKDOC_LINK_NO_DESTINATION;
+}
+
+void markdoc_link_index_delete(MarkdocLinkIndex *index) {
+    free(index->links);
+    free(index->destinations);
+    free(index->destination_offsets);
+    free(index->slots);
+    free(index->edited);
+    *index = (MarkdocLinkIndex){0};
+}
@@ -0,0 +1,272 @@
+#include "tree_sitter/markdoc/outline.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lines.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+// A slug already handed out, and the suffix to try next when it repeats.
+typedef struct {
+    // Offset into the slugs plus one; 0 marks an empty slot.
+    uint32_t offset;
+    uint32_t next_suffix;
+} SeenSlug;
+
+typedef struct {
+    const char *source;
+    MarkdocOutline *outline;
+    uint32_t entry_capacity;
+    uint32_t slug_capacity;
+    SeenSlug *seen;
+    uint32_t seen_capacity;
+    uint32_t seen_count;
+} Builder;
+
+static bool push_entry(Builder *builder, MarkdocOutlineEntry entry) {
+    MarkdocOutline *outline = builder->outline;
+    if (outline->count == builder->entry_capacity) {
+        uint32_t capacity = builder->entry_capacity ? builder->entry_capacity * 2 : 32;
+        MarkdocOutlineEntry *grown = realloc(outline->entries, capacity * sizeof(*grown));
+        if (grown == NULL) {
+            return false;
+        }
+        outline->entries = grown;
+        builder->entry_capacity = capacity;
+    }
+    outline->entries[outline->count++] = entry;
+    return true;
+}
+
+static bool reserve_slugs(Builder *builder, uint32_t length) {
+    MarkdocOutline *outline = builder->outline;
+    if (outline->slugs_length + length <= builder->slug_capacity) {
+        return true;
+    }
+    uint32_t capacity = builder->slug_capacity ? builder->slug_capacity : 256;
+    while (capacity < outline->slugs_length + length) {
+        capacity *= 2;
+    }
+    char *grown = realloc(outline->slugs, capacity);
+    if (grown == NULL) {
+        return false;
+    }
+    outline->slugs = grown;
+    builder->slug_capacity = capacity;
+    return true;
+}
+
+static uint32_t hash_slug(const char *slug, uint32_t length) {
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)slug[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Finds the slot of the slug [slug, slug + length), or the empty slot where
+// it belongs.
+static SeenSlug *find_slug(Builder *builder, const char *slug, uint32_t length) {
+    uint32_t mask = builder->seen_capacity - 1;
+    for (uint32_t i = hash_slug(slug, length) & mask;; i = (i + 1) & mask) {
+        SeenSlug *seen = &builder->seen[i];
+        if (seen->offset == 0) {
+            return seen;
+        }
+        const char *other = builder->outline->slugs + seen->offset - 1;
+        if (memcmp(other, slug, length) == 0 && other[length] == '\0') {
+            return seen;
+        }
+    }
+}
+
+// Keeps the table at most half full.
+static bool grow_seen(Builder *builder) {
+    if (builder->seen_count * 2 < builder->seen_capacity) {
+        return true;
+    }
+    SeenSlug *old = builder->seen;
+    uint32_t old_capacity = builder->seen_capacity;
+    builder->seen_capacity = old_capacity ? old_capacity * 2 : 64;
+    builder->seen = calloc(builder->seen_capacity, sizeof(SeenSlug));
+    if (builder->seen == NULL) {
+        builder->seen = old;
+        builder->seen_capacity = old_capacity;
+        return false;
+    }
+    for (uint32_t i = 0; i < old_capacity; i++) {
+        if (old[i].offset != 0) {
+            const char *slug = builder->outline->slugs + old[i].offset - 1;
+            *find_slug(builder, slug, (uint32_t)strlen(slug)) = old[i];
+        }
+    }
+    free(old);
+    return true;
+}
+
+// Appends the slug of [start, end) to the outline's slugs, with a suffix if
+// it was handed out before, and stores where it went in `entry`.
+static bool add_slug(Builder *builder, uint32_t start, uint32_t end, MarkdocOutlineEntry *entry) {
+    MarkdocOutline *outline = builder->outline;
+    // Room for the text, a `-` and ten digits of suffix, and the NUL.
+    if (!reserve_slugs(builder, end - start + 12) || !grow_seen(builder)) {
+        return false;
+    }
+    uint32_t offset = outline->slugs_length;
+    char *slug = outline->slugs + offset;
+    uint32_t length = 0;
+    for (uint32_t i = start; i < end; i++) {
+        unsigned char c = (unsigned char)builder->source[i];
+        if (c >= 'A' && c <= 'Z') {
+            slug[length++] = (char)(c - 'A' + 'a');
+        } else if (c == ' ') {
+            slug[length++] = '-';
+        } else if (c >= 0x80 || c == '-' || markdoc_is_identifier_char((char)c)) {
+            slug[length++] = (char)c;
+        }
+    }
+    slug[length] = '\0';
+
+    SeenSlug *seen = find_slug(builder, slug, length);
+    if (seen->offset != 0) {
+        // github-slugger: count up from the last suffix the base slug got,
+        // skipping suffixed slugs that some heading already has.
+        SeenSlug *base = seen;
+        uint32_t base_length = length;
+        do {
+            length = base_length +
+                     (uint32_t)snprintf(slug + base_length, 12, "-%u", base->next_suffix++);
+            seen = find_slug(builder, slug, length);
+        } while (seen->offset != 0);
+    }
+    *seen = (SeenSlug){.offset = offset + 1, .next_suffix = 1};
+    builder->seen_count++;
+
+    outline->slugs_length += length + 1;
+    entry->slug_offset = offset;
+    entry->slug_length = length;
+    return true;
+}
+
+static bool add_heading(Builder *builder, TSNode node) {
+    const char *source = builder->source;
+    TSNode marker = ts_node_child_by_field_id(node, MARKDOC_FIELD_HEADING_MARKER);
+    TSNode text = ts_node_child_by_field_id(node, MARKDOC_FIELD_HEADING_TEXT);
+    MarkdocOutlineEntry entry = {
+        .kind = MARKDOC_OUTLINE_HEADING,
+        .row = ts_node_start_point(node).row,
+    };
+    for (uint32_t i = ts_node_start_byte(marker); i < ts_node_end_byte(marker); i++) {
+        entry.level += source[i] == '#';
+    }
+    if (!ts_node_is_null(text)) {
+        uint32_t start = ts_node_start_byte(text), end = ts_node_end_byte(text);
+        while (end > start && markdoc_is_space(source[end - 1])) {
+            end--;
+        }
+        // A closing sequence of `#`s, as in `## Title ##`, is not text.
+        uint32_t closing = end;
+        while (closing > start && source[closing - 1] == '#') {
+            closing--;
+        }
+        if (closing < end && (closing == start || markdoc_is_space(source[closing - 1]))) {
+            end = closing;
+            while (end > start && markdoc_is_space(source[end - 1])) {
+                end--;
+            }
+        }
+        entry.start_byte = start;
+        entry.end_byte = end;
+    } else {
+        entry.start_byte = entry.end_byte = ts_node_end_byte(node);
+    }
+    return add_slug(builder, entry.start_byte, entry.end_byte, &entry) &&
+           push_entry(builder, entry);
+}
+
+static bool add_tag(Builder *builder, TSNode node) {
+    TSNode open = ts_node_child(node, 0);
+    uint32_t count = ts_node_named_child_count(open);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode name = ts_node_named_child(open, i);
+        if (ts_node_symbol(name) == MARKDOC_SYM_TAG_NAME) {
+            MarkdocOutlineEntry entry = {
+                .kind = MARKDOC_OUTLINE_TAG,
+                .start_byte = ts_node_start_byte(name),
+                .end_byte = ts_node_end_byte(name),
+                .row = ts_node_start_point(node).row,
+                .slug_offset = builder->outline->slugs_length,
+            };
+            return push_entry(builder, entry);
+        }
+    }
+    return true;
+}
+
+// Blocks whose children can be headings.
+static bool is_container(TSSymbol symbol) {
+    switch (symbol) {
+        case MARKDOC_SYM_SOURCE_FILE:
+        case MARKDOC_SYM_MARKDOC_TAG:
+        case MARKDOC_SYM_BLOCKQUOTE:
+        case MARKDOC_SYM_UNORDERED_LIST:
+        case MARKDOC_SYM_ORDERED_LIST:
+        case MARKDOC_SYM_UNORDERED_LIST_ITEM:
+        case MARKDOC_SYM_ORDERED_LIST_ITEM:
+        case MARKDOC_SYM_LIST_ITEM_CONTINUATION:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool markdoc_outline(TSNode node, const char *source, MarkdocOutline *outline) {
+    *outline = (MarkdocOutline){0};
+    if (!ts_node_is_null(node) && !markdoc_symbols_match(ts_node_language(node))) {
+        return false;
+    }
+    if (ts_node_is_null(node)) {
+        return true;
+    }
+    Builder builder = {.source = source, .outline = outline};
+    bool ok = reserve_slugs(&builder, 1);
+
+    TSTreeCursor cursor = ts_tree_cursor_new(node);
+    uint32_t depth = 0;
+    for (bool more = true; more && ok;) {
+        TSNode current = ts_tree_cursor_current_node(&cursor);
+        TSSymbol symbol = ts_node_symbol(current);
+        if (symbol == MARKDOC_SYM_HEADING) {
+            ok = add_heading(&builder, current);
+        } else if (symbol == MARKDOC_SYM_MARKDOC_TAG && depth == 1) {
+            ok = add_tag(&builder, current);
+        }
+        if (is_container(symbol) && ts_tree_cursor_goto_first_child(&cursor)) {
+            depth++;
+            continue;
+        }
+
+        while (depth > 0 && !ts_tree_cursor_goto_next_sibling(&cursor)) {
+            ts_tree_cursor_goto_parent(&cursor);
+            depth--;
+        }
+        more = depth > 0;
+    }
+    ts_tree_cursor_delete(&cursor);
+    free(builder.seen);
+
+    if (!ok) {
+        markdoc_outline_delete(outline);
+        return false;
+    }
+    if (outline->slugs_length == 0) {
+        outline->slugs[0] = '\0';
+    }
+    return true;
+}
+
+void markdoc_outline_delete(MarkdocOutline *outline) {
+    free(outline->entries);
+    free(outline->slugs);
+    *outline = (MarkdocOutline){0};
+}
@@ -0,0 +1,63 @@
+// Buffered output for the emitters: small writes collect in a fixed buffer
+// and reach the caller's MarkdocWriter in runs of a few KiB. After a failed
+// write everything else is dropped, so emitters only check `failed` at the
+// end.
+
+#ifndef TREE_SITTER_MARKDOC_OUTPUT_H_
+#define TREE_SITTER_MARKDOC_OUTPUT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "tree_sitter/markdoc/writer.h"
+
+#define MARKDOC_OUTPUT_BUFFER_SIZE 8192
+
+typedef struct {
+    MarkdocWriter writer;
+    uint32_t length;
+    bool failed;
+    char buffer[MARKDOC_OUTPUT_BUFFER_SIZE];
+} MarkdocOutput;
+
+static inline void markdoc_output_init(MarkdocOutput *output, MarkdocWriter writer) {
+    output->writer = writer;
+    output->length = 0;
+    output->failed = false;
+}
+
+static inline void markdoc_output_flush(MarkdocOutput *output) {
+    if (output->length > 0 && !output->failed) {
+        output->failed = !output->writer.write(output->writer.payload, output->buffer,
+                                               output->length);
+    }
+    output->length = 0;
+}
+
+static inline void markdoc_output_write(MarkdocOutput *output, const char *data, size_t length) {
+    if (length > MARKDOC_OUTPUT_BUFFER_SIZE - output->length) {
+        markdoc_output_flush(output);
+        if (length > MARKDOC_OUTPUT_BUFFER_SIZE) {
+            if (!output->failed) {
+                output->failed = !output->writer.write(output->writer.payload, data, length);
+            }
+            return;
+        }
+    }
+    memcpy(output->buffer + output->length, data, length);
+    output->length += (uint32_t)length;
+}
+
+static inline void markdoc_output_string(MarkdocOutput *output, const char *string) {
+    markdoc_output_write(output, string, strlen(string));
+}
+
+static inline void markdoc_output_char(MarkdocOutput *output, char c) {
+    if (output->length == MARKDOC_OUTPUT_BUFFER_SIZE) {
+        markdoc_output_flush(output);
+    }
+    output->buffer[output->length++] = c;
+}
+
+#endif // TREE_SITTER_MARKDOC_OUTPUT_H_
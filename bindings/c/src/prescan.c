@@ -0,0 +1,257 @@
+#include "tree_sitter/markdoc/prescan.h"
+
+#include <stdlib.h>
+
+#include "lines.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define MARKDOC_HAVE_SSE2 1
+#include <emmintrin.h>
+// AVX2 is compiled per function and chosen at run time, so the library still
+// runs on CPUs without it.
+#if defined(__GNUC__) || defined(__clang__)
+#define MARKDOC_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// The lines found so far. Every line but the last open one is classified as
+// soon as its line break is found, while its bytes are still in cache, so
+// the input is swept once.
+typedef struct {
+    const char *source;
+    uint32_t length;
+    uint32_t *starts;
+    uint8_t *flags;
+    uint32_t count;
+    uint32_t capacity;
+} Sweep;
+
+static bool sweep_reserve(Sweep *sweep, uint32_t extra) {
+    if (sweep->count + extra <= sweep->capacity) {
+        return true;
+    }
+    uint32_t capacity = sweep->capacity ? sweep->capacity : 256;
+    while (capacity < sweep->count + extra) {
+        capacity *= 2;
+    }
+    uint32_t *starts = realloc(sweep->starts, capacity * sizeof(uint32_t));
+    if (starts == NULL) {
+        return false;
+    }
+    sweep->starts = starts;
+    uint8_t *flags = realloc(sweep->flags, capacity);
+    if (flags == NULL) {
+        return false;
+    }
+    sweep->flags = flags;
+    sweep->capacity = capacity;
+    return true;
+}
+
+// Only the first bytes of a line decide its class, except for blank lines.
+static uint8_t classify_line(const char *line, const char *eol) {
+    if (markdoc_line_is_blank(line, eol)) {
+        return MARKDOC_LINE_BLANK;
+    }
+
+    char fence_char;
+    uint32_t fence_length;
+    switch (*line) {
+    case '`':
+    case '~':
+        return markdoc_line_fence(line, eol, &fence_char, &fence_length) ? MARKDOC_LINE_FENCE : 0;
+    case '{':
+        switch (markdoc_line_tag(line, eol)) {
+        case MARKDOC_TAG_LINE_OPEN:
+            return MARKDOC_LINE_TAG_OPEN;
+        case MARKDOC_TAG_LINE_CLOSE:
+            return MARKDOC_LINE_TAG_CLOSE;
+        case MARKDOC_TAG_LINE_SELF_CLOSE:
+            return MARKDOC_LINE_TAG_SELF_CLOSE;
+        case MARKDOC_TAG_LINE_COMMENT_OPEN:
+            return MARKDOC_LINE_COMMENT_OPEN;
+        default:
+            return 0;
+        }
+    case '-':
+        return markdoc_line_is_frontmatter_delimiter(line, eol) ? MARKDOC_LINE_DELIMITER : 0;
+    default:
+        break;
+    }
+
+    while (line < eol && markdoc_is_space(*line)) {
+        line++;
+    }
+    if (eol - line >= 4 && memcmp(line, "<!--", 4) == 0) {
+        return MARKDOC_LINE_HTML_COMMENT;
+    }
+    return 0;
+}
+
+// Classifies the open line, which ends at `eol`, and opens the next one at
+// `next` unless the input ends there.
+static inline void sweep_end_line(Sweep *sweep, uint32_t eol, uint32_t next) {
+    const char *line = sweep->source + sweep->starts[sweep->count - 1];
+    const char *end = sweep->source + eol;
+    if (end > line && end[-1] == '\r') {
+        end--;
+    }
+    sweep->flags[sweep->count - 1] = classify_line(line, end);
+    if (next < sweep->length) {
+        sweep->starts[sweep->count++] = next;
+    }
+}
+
+static inline unsigned count_trailing_zeros(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+// Ends a line at each line break in `mask`, whose bit i stands for byte
+// `base + i`.
+static inline void sweep_line_breaks(Sweep *sweep, uint32_t base, uint32_t mask) {
+    while (mask != 0) {
+        uint32_t newline = base + count_trailing_zeros(mask);
+        sweep_end_line(sweep, newline, newline + 1);
+        mask &= mask - 1;
+    }
+}
+
+static bool sweep_scalar(Sweep *sweep, uint32_t from) {
+    for (uint32_t i = from; i < sweep->length; i++) {
+        if (sweep->source[i] == '\n') {
+            if (!sweep_reserve(sweep, 1)) {
+                return false;
+            }
+            sweep_end_line(sweep, i, i + 1);
+        }
+    }
+    return true;
+}
+
+#ifdef MARKDOC_HAVE_SSE2
+static bool sweep_sse2(Sweep *sweep) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    uint32_t i = 0;
+    for (; i + 16 <= sweep->length; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(sweep->source + i));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline));
+        if (mask != 0) {
+            if (!sweep_reserve(sweep, 16)) {
+                return false;
+            }
+            sweep_line_breaks(sweep, i, mask);
+        }
+    }
+    return sweep_scalar(sweep, i);
+}
+#endif
+
+#ifdef MARKDOC_HAVE_AVX2
+__attribute__((target("avx2")))
+static bool sweep_avx2(Sweep *sweep) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    uint32_t i = 0;
+    for (; i + 32 <= sweep->length; i += 32) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i *)(sweep->source + i));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline));
+        if (mask != 0) {
+            if (!sweep_reserve(sweep, 32)) {
+                return false;
+            }
+            sweep_line_breaks(sweep, i, mask);
+        }
+    }
+    return sweep_scalar(sweep, i);
+}
+
+static bool cpu_has_avx2(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+
+MarkdocSimdLevel markdoc_prescan_level(void) {
+#ifdef MARKDOC_HAVE_AVX2
+    if (cpu_has_avx2()) {
+        return MARKDOC_SIMD_AVX2;
+    }
+#endif
+#ifdef MARKDOC_HAVE_SSE2
+    return MARKDOC_SIMD_SSE2;
+#else
+    return MARKDOC_SIMD_SCALAR;
+#endif
+}
+
+bool markdoc_prescan_with_level(const char *source, uint32_t length, MarkdocLineIndex *index,
+                                MarkdocSimdLevel level) {
+    *index = (MarkdocLineIndex){0};
+    if (level == MARKDOC_SIMD_AUTO) {
+        level = markdoc_prescan_level();
+    }
+
+    Sweep sweep = {.source = source, .length = length};
+    if (!sweep_reserve(&sweep, length / 32 + 1)) {
+        free(sweep.starts);
+        free(sweep.flags);
+        return false;
+    }
+    if (length > 0) {
+        sweep.starts[sweep.count++] = 0;
+    }
+
+    bool ok;
+    switch (level) {
+    case MARKDOC_SIMD_SCALAR:
+        ok = sweep_scalar(&sweep, 0);
+        break;
+#ifdef MARKDOC_HAVE_SSE2
+    case MARKDOC_SIMD_SSE2:
+        ok = sweep_sse2(&sweep);
+        break;
+#endif
+#ifdef MARKDOC_HAVE_AVX2
+    case MARKDOC_SIMD_AVX2:
+        ok = cpu_has_avx2() && sweep_avx2(&sweep);
+        break;
+#endif
+    default:
+        ok = false;
+        break;
+    }
+    if (!ok) {
+        free(sweep.starts);
+        free(sweep.flags);
+        return false;
+    }
+    // The last line has no line break to end it.
+    if (length > 0 && source[length - 1] != '\n') {
+        sweep_end_line(&sweep, length, length);
+    }
+
+    index->line_starts = sweep.starts;
+    index->line_flags = sweep.flags;
+    index->line_count = sweep.count;
+    return true;
+}
+
+bool markdoc_prescan(const char *source, uint32_t length, MarkdocLineIndex *index) {
+    return markdoc_prescan_with_level(source, length, index, MARKDOC_SIMD_AUTO);
+}
+
+void markdoc_line_index_delete(MarkdocLineIndex *index) {
+    free(index->line_starts);
+    free(index->line_flags);
+    *index = (MarkdocLineIndex){0};
+}
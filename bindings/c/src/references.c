@@ -0,0 +1,309 @@
+#include "tree_sitter/markdoc/references.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "tree_sitter/markdoc/symbols.h"
+
+typedef struct {
+    const char *source;
+    MarkdocReferences *references;
+} Collector;
+
+static uint32_t hash_name(const char *name, uint32_t length) {
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// The slot holding `name`, or the empty slot where it belongs.
+static uint32_t *find_slot(const MarkdocReferences *references, const char *name,
+                           uint32_t length) {
+    uint32_t mask = references->slot_capacity - 1;
+    for (uint32_t i = hash_name(name, length) & mask;; i = (i + 1) & mask) {
+        uint32_t *slot = &references->slots[i];
+        if (*slot == 0) {
+            return slot;
+        }
+        const char *other = references->names + references->name_offsets[*slot - 1];
+        if (memcmp(other, name, length) == 0 && other[length] == '\0') {
+            return slot;
+        }
+    }
+}
+
+// Keeps the table at most half full.
+static bool grow_slots(MarkdocReferences *references) {
+    if (references->name_count * 2 < references->slot_capacity) {
+        return true;
+    }
+    uint32_t capacity = references->slot_capacity ? references->slot_capacity * 2 : 64;
+    uint32_t *slots = calloc(capacity, sizeof(uint32_t));
+    if (slots == NULL) {
+        return false;
+    }
+    free(references->slots);
+    references->slots = slots;
+    references->slot_capacity = capacity;
+    for (uint32_t id = 0; id < references->name_count; id++) {
+        const char *name = references->names + references->name_offsets[id];
+        *find_slot(references, name, (uint32_t)strlen(name)) = id + 1;
+    }
+    return true;
+}
+
+// Returns the id of [name, name + length), adding it if it is new, or
+// MARKDOC_REFERENCE_NO_NAME when out of memory.
+static uint32_t intern(MarkdocReferences *references, const char *name, uint32_t length) {
+    if (!grow_slots(references)) {
+        return MARKDOC_REFERENCE_NO_NAME;
+    }
+    uint32_t *slot = find_slot(references, name, length);
+    if (*slot != 0) {
+        return *slot - 1;
+    }
+
+    if (references->name_count == references->name_capacity) {
+        uint32_t capacity = references->name_capacity ? references->name_capacity * 2 : 32;
+        uint32_t *grown = realloc(references->name_offsets, capacity * sizeof(uint32_t));
+        if (grown == NULL) {
+            return MARKDOC_REFERENCE_NO_NAME;
+        }
+        references->name_offsets = grown;
+        references->name_capacity = capacity;
+    }
+    if (references->names_length + length + 1 > references->names_capacity) {
+        uint32_t capacity = references->names_capacity ? references->names_capacity : 256;
+        while (capacity < references->names_length + length + 1) {
+            capacity *= 2;
+        }
+        char *grown = realloc(references->names, capacity);
+        if (grown == NULL) {
+            return MARKDOC_REFERENCE_NO_NAME;
+        }
+        references->names = grown;
+        references->names_capacity = capacity;
+    }
+    memcpy(references->names + references->names_length, name, length);
+    references->names[references->names_length + length] = '\0';
+    references->name_offsets[references->name_count] = references->names_length;
+    references->names_length += length + 1;
+    *slot = references->name_count + 1;
+    return references->name_count++;
+}
+
+static bool push_element(MarkdocReferences *references, uint32_t element) {
+    if (references->path_length == references->path_capacity) {
+        uint32_t capacity = references->path_capacity ? references->path_capacity * 2 : 64;
+        uint32_t *grown = realloc(references->path, capacity * sizeof(uint32_t));
+        if (grown == NULL) {
+            return false;
+        }
+        references->path = grown;
+        references->path_capacity = capacity;
+    }
+    references->path[references->path_length++] = element;
+    return true;
+}
+
+static bool push_name(Collector *collector, TSNode node, uint32_t trim) {
+    uint32_t start = ts_node_start_byte(node) + trim, end = ts_node_end_byte(node) - trim;
+    uint32_t id = intern(collector->references, collector->source + start, end - start);
+    return id != MARKDOC_REFERENCE_NO_NAME && push_element(collector->references, id);
+}
+
+static bool push_reference(Collector *collector, MarkdocReferenceKind kind, TSNode node,
+                           uint32_t path_offset, bool in_attribute) {
+    MarkdocReferences *references = collector->references;
+    if (references->count == references->capacity) {
+        uint32_t capacity = references->capacity ? references->capacity * 2 : 64;
+        MarkdocReference *grown = realloc(references->references, capacity * sizeof(*grown));
+        if (grown == NULL) {
+            return false;
+        }
+        references->references = grown;
+        references->capacity = capacity;
+    }
+    references->references[references->count++] = (MarkdocReference){
+        .kind = kind,
+        .start_byte = ts_node_start_byte(node),
+        .end_byte = ts_node_end_byte(node),
+        .start_point = ts_node_start_point(node),
+        .path_offset = path_offset,
+        .path_length = references->path_length - path_offset,
+        .in_attribute = in_attribute,
+    };
+    return true;
+}
+
+// Reads the number [start, end), /-?[0-9]+(\.[0-9]+)?/, as an index path
+// element, or MARKDOC_REFERENCE_UNKNOWN_INDEX when it is negative, has a
+// fraction or does not fit. `-0` and `2.0` are the indices 0 and 2, as an
+// array lookup would read them.
+static uint32_t read_index(const char *source, uint32_t start, uint32_t end) {
+    bool negative = start < end && source[start] == '-';
+    uint32_t index = 0;
+    uint32_t at = start + negative;
+    for (; at < end && source[at] >= '0' && source[at] <= '9'; at++) {
+        if (index > (MARKDOC_REFERENCE_MAX_INDEX - (uint32_t)(source[at] - '0')) / 10) {
+            return MARKDOC_REFERENCE_UNKNOWN_INDEX;
+        }
+        index = index * 10 + (uint32_t)(source[at] - '0');
+    }
+    if (at < end && source[at] == '.') {
+        while (++at < end) {
+            if (source[at] != '0') {
+                return MARKDOC_REFERENCE_UNKNOWN_INDEX;
+            }
+        }
+    }
+    if (negative && index != 0) {
+        return MARKDOC_REFERENCE_UNKNOWN_INDEX;
+    }
+    return MARKDOC_REFERENCE_INDEX | index;
+}
+
+// Adds the variable_value `node`: its variable's name, each `.field`, then
+// each subscript.
+static bool add_variable(Collector *collector, TSNode node, bool in_attribute) {
+    MarkdocReferences *references = collector->references;
+    uint32_t path_offset = references->path_length;
+    TSNode reference = ts_node_named_child(node, 0);
+    TSNode base = reference;
+    if (ts_node_symbol(reference) == MARKDOC_SYM_SUBSCRIPT_REFERENCE) {
+        base = ts_node_named_child(reference, 0);
+    }
+    MarkdocReferenceKind kind = ts_node_symbol(base) == MARKDOC_SYM_SPECIAL_VARIABLE_REFERENCE
+                                    ? MARKDOC_REFERENCE_SPECIAL
+                                    : MARKDOC_REFERENCE_VARIABLE;
+
+    uint32_t count = ts_node_named_child_count(base);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode child = ts_node_named_child(base, i);
+        TSSymbol symbol = ts_node_symbol(child);
+        if (symbol == MARKDOC_SYM_VARIABLE || symbol == MARKDOC_SYM_SPECIAL_VARIABLE) {
+            child = ts_node_named_child(child, 0);
+        } else if (symbol != MARKDOC_SYM_IDENTIFIER) {
+            continue;
+        }
+        if (!push_name(collector, child, 0)) {
+            return false;
+        }
+    }
+
+    if (!ts_node_eq(base, reference)) {
+        count = ts_node_named_child_count(reference);
+        for (uint32_t i = 1; i < count; i++) {
+            TSNode key = ts_node_named_child(ts_node_named_child(reference, i), 0);
+            if (ts_node_symbol(key) == MARKDOC_SYM_STRING) {
+                if (!push_name(collector, key, 1)) {
+                    return false;
+                }
+                continue;
+            }
+            uint32_t index = read_index(collector->source, ts_node_start_byte(key),
+                                        ts_node_end_byte(key));
+            if (!push_element(references, index)) {
+                return false;
+            }
+        }
+    }
+    return push_reference(collector, kind, node, path_offset, in_attribute);
+}
+
+static bool add_function(Collector *collector, TSNode node, bool in_attribute) {
+    uint32_t path_offset = collector->references->path_length;
+    TSNode name = ts_node_child_by_field_id(node, MARKDOC_FIELD_FUNCTION);
+    return push_name(collector, name, 0) &&
+           push_reference(collector, MARKDOC_REFERENCE_FUNCTION, name, path_offset, in_attribute);
+}
+
+// Nodes that cannot contain an expression, so the walk steps over them.
+static bool is_opaque(TSSymbol symbol) {
+    switch (symbol) {
+        case MARKDOC_SYM_FRONTMATTER:
+        case MARKDOC_SYM_HEADING:
+        case MARKDOC_SYM_FENCED_CODE_BLOCK:
+        case MARKDOC_SYM_HTML_BLOCK:
+        case MARKDOC_SYM_HTML_COMMENT:
+        case MARKDOC_SYM_HTML_INLINE:
+        case MARKDOC_SYM_THEMATIC_BREAK:
+        case MARKDOC_SYM_COMMENT_BLOCK:
+        case MARKDOC_SYM_TEXT:
+        case MARKDOC_SYM_EMPHASIS:
+        case MARKDOC_SYM_STRONG:
+        case MARKDOC_SYM_INLINE_CODE:
+        case MARKDOC_SYM_LINK:
+        case MARKDOC_SYM_IMAGE:
+        case MARKDOC_SYM_TAG_CLOSE:
+        case MARKDOC_SYM_TAG_NAME:
+        case MARKDOC_SYM_ATTRIBUTE_NAME:
+        case MARKDOC_SYM_STRING:
+        case MARKDOC_SYM_NUMBER:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool collect(Collector *collector, TSTreeCursor *cursor, bool in_attribute) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    TSSymbol symbol = ts_node_symbol(node);
+    if (!ts_node_is_named(node) || is_opaque(symbol)) {
+        return true;
+    }
+    if (symbol == MARKDOC_SYM_VARIABLE_VALUE) {
+        return add_variable(collector, node, in_attribute);
+    }
+    if (symbol == MARKDOC_SYM_CALL_EXPRESSION && !add_function(collector, node, in_attribute)) {
+        return false;
+    }
+    in_attribute = in_attribute || symbol == MARKDOC_SYM_ATTRIBUTE;
+
+    bool ok = true;
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            ok = collect(collector, cursor, in_attribute);
+        } while (ok && ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    return ok;
+}
+
+bool markdoc_references_collect(TSNode node, const char *source, MarkdocReferences *references) {
+    *references = (MarkdocReferences){0};
+    if (!ts_node_is_null(node) && !markdoc_symbols_match(ts_node_language(node))) {
+        return false;
+    }
+    if (ts_node_is_null(node)) {
+        return true;
+    }
+    Collector collector = {.source = source, .references = references};
+    TSTreeCursor cursor = ts_tree_cursor_new(node);
+    bool ok = grow_slots(references) && collect(&collector, &cursor, false);
+    ts_tree_cursor_delete(&cursor);
+    if (!ok) {
+        markdoc_references_delete(references);
+    }
+    return ok;
+}
+
+uint32_t markdoc_references_find(const MarkdocReferences *references, const char *name,
+                                 uint32_t length) {
+    if (references->slot_capacity == 0) {
+        return MARKDOC_REFERENCE_NO_NAME;
+    }
+    uint32_t slot = *find_slot(references, name, length);
+    return slot != 0 ? slot - 1 : MARKDOC_REFERENCE_NO_NAME;
+}
+
+void markdoc_references_delete(MarkdocReferences *references) {
+    free(references->references);
+    free(references->path);
+    free(references->names);
+    free(references->name_offsets);
+    free(references->slots);
+    *references = (MarkdocReferences){0};
+}
@@ -0,0 +1,183 @@
+#include "tree_sitter/markdoc/stream.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define read _read
+#else
+#include <unistd.h>
+#endif
+
+#define DEFAULT_CHUNK_SIZE (64 * 1024)
+#define DEFAULT_CHUNK_COUNT 16
+
+// The longest UTF-8 character.
+#define BRIDGE_SIZE 4
+
+// Chunk n of the input covers bytes [n * chunk_size, (n + 1) * chunk_size)
+// and lives in slot n % chunk_count. Every chunk but the last is full, so a
+// byte index maps to its chunk by division.
+typedef struct {
+    int fd;
+    uint32_t chunk_size;
+    uint32_t chunk_count;
+    char *data;
+    uint32_t *lengths;
+    uint64_t loaded_chunks;
+    bool at_eof;
+    int error;
+    // The last bytes of a chunk followed by the first of the next ones.
+    char bridge[BRIDGE_SIZE];
+} ChunkRing;
+
+// Reads the next chunk into its slot, retrying short reads so that only the
+// final chunk can be partial.
+static void ring_load_chunk(ChunkRing *ring) {
+    uint32_t slot = (uint32_t)(ring->loaded_chunks % ring->chunk_count);
+    char *buffer = ring->data + (size_t)slot * ring->chunk_size;
+    uint32_t length = 0;
+    while (length < ring->chunk_size) {
+        long count = (long)read(ring->fd, buffer + length, ring->chunk_size - length);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ring->error = errno;
+            break;
+        }
+        if (count == 0) {
+            break;
+        }
+        length += (uint32_t)count;
+    }
+
+    if (length < ring->chunk_size) {
+        ring->at_eof = true;
+    }
+    if (length > 0) {
+        if ((ring->loaded_chunks * ring->chunk_size) + length > UINT32_MAX) {
+            ring->error = EFBIG;
+            ring->at_eof = true;
+            return;
+        }
+        ring->lengths[slot] = length;
+        ring->loaded_chunks++;
+    }
+}
+
+// Loads chunks until `chunk` is in the ring or the input ends. Returns false
+// if it never arrives or was already evicted.
+static bool ring_has_chunk(ChunkRing *ring, uint64_t chunk) {
+    while (chunk >= ring->loaded_chunks && !ring->at_eof && ring->error == 0) {
+        ring_load_chunk(ring);
+    }
+    if (ring->error != 0 || chunk >= ring->loaded_chunks) {
+        return false;
+    }
+    if (ring->loaded_chunks - chunk > ring->chunk_count) {
+        ring->error = ENOBUFS;
+        return false;
+    }
+    return true;
+}
+
+// Copies the `length` bytes left at the end of a chunk, and the start of the
+// chunks after it, into the bridge. When a character is cut off at the end
+// of what read returned, the lexer asks again from the character's start. A
+// slot would hand it the same cut-off bytes, so a UTF-8 character across a
+// chunk boundary would decode as an error.
+static const char *read_bridge(ChunkRing *ring, const char *tail, uint32_t length,
+                               uint64_t next_chunk, uint32_t *bytes_read) {
+    memcpy(ring->bridge, tail, length);
+    for (uint64_t chunk = next_chunk; length < BRIDGE_SIZE && ring_has_chunk(ring, chunk);
+         chunk++) {
+        uint32_t slot = (uint32_t)(chunk % ring->chunk_count);
+        uint32_t wanted = BRIDGE_SIZE - length;
+        uint32_t count = ring->lengths[slot] < wanted ? ring->lengths[slot] : wanted;
+        memcpy(ring->bridge + length, ring->data + (size_t)slot * ring->chunk_size, count);
+        length += count;
+    }
+    if (ring->error != 0) {
+        return "";
+    }
+    *bytes_read = length;
+    return ring->bridge;
+}
+
+// The length of the UTF-8 character that starts with `lead`, or 1 for a byte
+// that cannot start one.
+static uint32_t utf8_length(unsigned char lead) {
+    if (lead >= 0xf0 && lead < 0xf8) {
+        return 4;
+    }
+    if (lead >= 0xe0 && lead < 0xf0) {
+        return 3;
+    }
+    if (lead >= 0xc0 && lead < 0xe0) {
+        return 2;
+    }
+    return 1;
+}
+
+static const char *read_ring(void *payload, uint32_t byte_index, TSPoint position,
+                             uint32_t *bytes_read) {
+    (void)position;
+    ChunkRing *ring = payload;
+    uint64_t chunk = byte_index / ring->chunk_size;
+    *bytes_read = 0;
+    if (!ring_has_chunk(ring, chunk)) {
+        return "";
+    }
+
+    uint32_t slot = (uint32_t)(chunk % ring->chunk_count);
+    uint32_t offset = (uint32_t)(byte_index - chunk * ring->chunk_size);
+    if (offset >= ring->lengths[slot]) {
+        return "";
+    }
+    const char *data = ring->data + (size_t)slot * ring->chunk_size + offset;
+    uint32_t available = ring->lengths[slot] - offset;
+    // Only a full chunk can be followed by another. Bridging a character
+    // that fits would load the next chunk early and could evict this one.
+    if (utf8_length((unsigned char)*data) > available &&
+        ring->lengths[slot] == ring->chunk_size) {
+        return read_bridge(ring, data, available, chunk + 1, bytes_read);
+    }
+    *bytes_read = available;
+    return data;
+}
+
+TSTree *markdoc_parse_fd(TSParser *parser, int fd, const MarkdocStreamOptions *options) {
+    ChunkRing ring = {
+        .fd = fd,
+        .chunk_size = options && options->chunk_size ? options->chunk_size : DEFAULT_CHUNK_SIZE,
+        .chunk_count = options && options->chunk_count ? options->chunk_count
+                                                        : DEFAULT_CHUNK_COUNT,
+    };
+    ring.data = malloc((size_t)ring.chunk_size * ring.chunk_count);
+    ring.lengths = calloc(ring.chunk_count, sizeof(uint32_t));
+    if (ring.data == NULL || ring.lengths == NULL) {
+        free(ring.data);
+        free(ring.lengths);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    TSInput input = {
+        .payload = &ring,
+        .read = read_ring,
+        .encoding = TSInputEncodingUTF8,
+    };
+    TSTree *tree = ts_parser_parse(parser, NULL, input);
+
+    free(ring.data);
+    free(ring.lengths);
+    if (ring.error != 0) {
+        ts_tree_delete(tree);
+        errno = ring.error;
+        return NULL;
+    }
+    return tree;
+}
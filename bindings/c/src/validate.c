@@ -0,0 +1,417 @@
+#include "tree_sitter/markdoc/validate.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "tree_sitter/markdoc/symbols.h"
+
+// The Markdoc node types a children list can name, besides tags.
+enum {
+    CHILD_PARAGRAPH = 1 << 0,
+    CHILD_HEADING = 1 << 1,
+    CHILD_FENCE = 1 << 2,
+    CHILD_LIST = 1 << 3,
+    CHILD_BLOCKQUOTE = 1 << 4,
+    CHILD_HR = 1 << 5,
+    // `tag`: any tag.
+    CHILD_TAG = 1 << 6,
+};
+
+static const struct {
+    const char *name;
+    uint32_t kind;
+} child_kinds[] = {
+    {"paragraph", CHILD_PARAGRAPH}, {"heading", CHILD_HEADING},       {"fence", CHILD_FENCE},
+    {"list", CHILD_LIST},           {"blockquote", CHILD_BLOCKQUOTE}, {"hr", CHILD_HR},
+    {"tag", CHILD_TAG},
+};
+
+struct MarkdocValidator {
+    MarkdocSchema schema;
+    // For each tag, the CHILD_* kinds its children list names.
+    uint32_t *child_kinds;
+    // An open-addressing table of tag indices plus one.
+    uint32_t *slots;
+    uint32_t slot_capacity;
+};
+
+static uint32_t hash_name(const char *name, uint32_t length) {
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static bool name_is(const char *name, const char *text, uint32_t length) {
+    return strncmp(name, text, length) == 0 && name[length] == '\0';
+}
+
+static uint32_t find_tag(const MarkdocValidator *validator, const char *name, uint32_t length) {
+    uint32_t mask = validator->slot_capacity - 1;
+    for (uint32_t i = hash_name(name, length) & mask; validator->slots[i] != 0;
+         i = (i + 1) & mask) {
+        uint32_t tag = validator->slots[i] - 1;
+        if (name_is(validator->schema.tags[tag].name, name, length)) {
+            return tag;
+        }
+    }
+    return MARKDOC_SCHEMA_NONE;
+}
+
+MarkdocValidator *markdoc_validator_new(const MarkdocSchema *schema) {
+    MarkdocValidator *validator = calloc(1, sizeof(MarkdocValidator));
+    if (validator == NULL) {
+        return NULL;
+    }
+    validator->schema = *schema;
+    validator->slot_capacity = 16;
+    while (validator->slot_capacity < 2 * schema->tag_count) {
+        validator->slot_capacity *= 2;
+    }
+    validator->slots = calloc(validator->slot_capacity, sizeof(uint32_t));
+    validator->child_kinds = calloc(schema->tag_count + 1, sizeof(uint32_t));
+    if (validator->slots == NULL || validator->child_kinds == NULL) {
+        markdoc_validator_delete(validator);
+        return NULL;
+    }
+
+    for (uint32_t tag = 0; tag < schema->tag_count; tag++) {
+        const MarkdocTagSchema *tag_schema = &schema->tags[tag];
+        uint32_t length = (uint32_t)strlen(tag_schema->name);
+        // The first of two tags with the same name wins.
+        if (find_tag(validator, tag_schema->name, length) == MARKDOC_SCHEMA_NONE) {
+            uint32_t mask = validator->slot_capacity - 1;
+            uint32_t i = hash_name(tag_schema->name, length) & mask;
+            while (validator->slots[i] != 0) {
+                i = (i + 1) & mask;
+            }
+            validator->slots[i] = tag + 1;
+        }
+        for (uint32_t i = 0; i < tag_schema->child_count; i++) {
+            for (size_t j = 0; j < sizeof(child_kinds) / sizeof(child_kinds[0]); j++) {
+                if (strcmp(tag_schema->children[i], child_kinds[j].name) == 0) {
+                    validator->child_kinds[tag] |= child_kinds[j].kind;
+                }
+            }
+        }
+    }
+    return validator;
+}
+
+void markdoc_validator_delete(MarkdocValidator *validator) {
+    if (validator == NULL) {
+        return;
+    }
+    free(validator->slots);
+    free(validator->child_kinds);
+    free(validator);
+}
+
+// Checking
+
+typedef struct {
+    const MarkdocValidator *validator;
+    const char *source;
+    MarkdocDiagnostics *diagnostics;
+    uint32_t capacity;
+} Checker;
+
+static bool report(Checker *checker, MarkdocDiagnosticKind kind, TSNode node, uint32_t tag,
+                   uint32_t attribute) {
+    MarkdocDiagnostics *diagnostics = checker->diagnostics;
+    if (diagnostics->count == checker->capacity) {
+        uint32_t capacity = checker->capacity ? checker->capacity * 2 : 16;
+        MarkdocDiagnostic *grown =
+            realloc(diagnostics->diagnostics, capacity * sizeof(MarkdocDiagnostic));
+        if (grown == NULL) {
+            return false;
+        }
+        diagnostics->diagnostics = grown;
+        checker->capacity = capacity;
+    }
+    diagnostics->diagnostics[diagnostics->count++] = (MarkdocDiagnostic){
+        .kind = kind,
+        .start_byte = ts_node_start_byte(node),
+        .end_byte = ts_node_end_byte(node),
+        .start_point = ts_node_start_point(node),
+        .tag = tag,
+        .attribute = attribute,
+    };
+    return true;
+}
+
+static bool node_is(const Checker *checker, TSNode node, const char *name) {
+    uint32_t start = ts_node_start_byte(node);
+    return name_is(name, checker->source + start, ts_node_end_byte(node) - start);
+}
+
+static TSNode child_of_type(TSNode node, TSSymbol symbol) {
+    if (ts_node_is_null(node)) {
+        return node;
+    }
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode child = ts_node_named_child(node, i);
+        if (ts_node_symbol(child) == symbol) {
+            return child;
+        }
+    }
+    return (TSNode){0};
+}
+
+// The MARKDOC_TYPE_* of an attribute_value, or 0 for a variable or call.
+static uint32_t value_type(TSNode value) {
+    TSNode expression = ts_node_named_child(ts_node_named_child(value, 0), 0);
+    if (ts_node_symbol(expression) != MARKDOC_SYM_JSON_VALUE) {
+        return 0;
+    }
+    switch (ts_node_symbol(ts_node_named_child(expression, 0))) {
+        case MARKDOC_SYM_STRING: return MARKDOC_TYPE_STRING;
+        case MARKDOC_SYM_NUMBER: return MARKDOC_TYPE_NUMBER;
+        case MARKDOC_SYM_BOOLEAN: return MARKDOC_TYPE_BOOLEAN;
+        case MARKDOC_SYM_NULL: return MARKDOC_TYPE_NULL;
+        case MARKDOC_SYM_ARRAY_LITERAL: return MARKDOC_TYPE_ARRAY;
+        case MARKDOC_SYM_OBJECT_LITERAL: return MARKDOC_TYPE_OBJECT;
+        default: return 0;
+    }
+}
+
+static bool check_attributes(Checker *checker, TSNode opener, uint32_t tag) {
+    const MarkdocTagSchema *schema = &checker->validator->schema.tags[tag];
+    uint32_t count = ts_node_named_child_count(opener);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode attribute = ts_node_named_child(opener, i);
+        if (ts_node_symbol(attribute) != MARKDOC_SYM_ATTRIBUTE) {
+            continue;
+        }
+        TSNode name = ts_node_named_child(attribute, 0);
+        uint32_t index = MARKDOC_SCHEMA_NONE;
+        for (uint32_t j = 0; j < schema->attribute_count && index == MARKDOC_SCHEMA_NONE; j++) {
+            if (node_is(checker, name, schema->attributes[j].name)) {
+                index = j;
+            }
+        }
+
+        bool duplicate = false;
+        for (uint32_t j = 0; j < i && !duplicate; j++) {
+            TSNode earlier = ts_node_named_child(opener, j);
+            if (ts_node_symbol(earlier) == MARKDOC_SYM_ATTRIBUTE) {
+                TSNode earlier_name = ts_node_named_child(earlier, 0);
+                uint32_t start = ts_node_start_byte(earlier_name);
+                uint32_t length = ts_node_end_byte(earlier_name) - start;
+                duplicate = length == ts_node_end_byte(name) - ts_node_start_byte(name) &&
+                            memcmp(checker->source + start,
+                                   checker->source + ts_node_start_byte(name), length) == 0;
+            }
+        }
+
+        bool ok = true;
+        if (duplicate) {
+            ok = report(checker, MARKDOC_DIAGNOSTIC_DUPLICATE_ATTRIBUTE, attribute, tag, index);
+        } else if (index == MARKDOC_SCHEMA_NONE) {
+            if (!schema->any_attributes) {
+                ok = report(checker, MARKDOC_DIAGNOSTIC_UNKNOWN_ATTRIBUTE, name, tag, index);
+            }
+        } else {
+            TSNode value = ts_node_named_child(attribute, 1);
+            uint32_t type = value_type(value);
+            if (schema->attributes[index].types != 0 && type != 0 &&
+                (schema->attributes[index].types & type) == 0) {
+                ok = report(checker, MARKDOC_DIAGNOSTIC_ATTRIBUTE_TYPE, value, tag, index);
+            }
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+
+    for (uint32_t j = 0; j < schema->attribute_count; j++) {
+        if (!schema->attributes[j].required) {
+            continue;
+        }
+        bool present = false;
+        for (uint32_t i = 0; i < count && !present; i++) {
+            TSNode attribute = ts_node_named_child(opener, i);
+            present = ts_node_symbol(attribute) == MARKDOC_SYM_ATTRIBUTE &&
+                      node_is(checker, ts_node_named_child(attribute, 0),
+                              schema->attributes[j].name);
+        }
+        if (!present && !report(checker, MARKDOC_DIAGNOSTIC_MISSING_ATTRIBUTE, opener, tag, j)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Checks the markdoc_tag or inline_tag `node` and stores its schema index
+// in `tag`.
+static bool check_tag(Checker *checker, TSNode node, uint32_t *tag) {
+    const MarkdocSchema *schema = &checker->validator->schema;
+    TSNode opener = ts_node_named_child(node, 0);
+    TSNode name = child_of_type(opener, MARKDOC_SYM_TAG_NAME);
+    *tag = MARKDOC_SCHEMA_NONE;
+    if (ts_node_is_null(name)) {
+        return true;
+    }
+    uint32_t start = ts_node_start_byte(name);
+    const char *text = checker->source + start;
+    uint32_t length = ts_node_end_byte(name) - start;
+
+    bool self_closing = ts_node_symbol(opener) == MARKDOC_SYM_TAG_SELF_CLOSE;
+    if (!self_closing) {
+        TSNode close = child_of_type(node, MARKDOC_SYM_TAG_CLOSE);
+        TSNode close_name = child_of_type(close, MARKDOC_SYM_TAG_NAME);
+        if (!ts_node_is_null(close_name) &&
+            (ts_node_end_byte(close_name) - ts_node_start_byte(close_name) != length ||
+             memcmp(checker->source + ts_node_start_byte(close_name), text, length) != 0) &&
+            !report(checker, MARKDOC_DIAGNOSTIC_CLOSE_MISMATCH, close_name,
+                    find_tag(checker->validator, text, length), MARKDOC_SCHEMA_NONE)) {
+            return false;
+        }
+    }
+
+    *tag = find_tag(checker->validator, text, length);
+    if (*tag == MARKDOC_SCHEMA_NONE) {
+        return schema->any_tags || report(checker, MARKDOC_DIAGNOSTIC_UNKNOWN_TAG, name,
+                                          MARKDOC_SCHEMA_NONE, MARKDOC_SCHEMA_NONE);
+    }
+    MarkdocTagForm form = schema->tags[*tag].form;
+    if ((form == MARKDOC_TAG_SELF_CLOSING && !self_closing) ||
+        (form == MARKDOC_TAG_WITH_BODY && self_closing)) {
+        if (!report(checker, MARKDOC_DIAGNOSTIC_WRONG_FORM, opener, *tag, MARKDOC_SCHEMA_NONE)) {
+            return false;
+        }
+    }
+    return check_attributes(checker, opener, *tag);
+}
+
+// Checks that the block `node`, directly in the body of `parent`, is one
+// that the parent's children list allows.
+static bool check_child(Checker *checker, TSNode node, uint32_t parent) {
+    const MarkdocTagSchema *schema = &checker->validator->schema.tags[parent];
+    uint32_t kinds = checker->validator->child_kinds[parent];
+    uint32_t kind;
+    switch (ts_node_symbol(node)) {
+        case MARKDOC_SYM_PARAGRAPH: kind = CHILD_PARAGRAPH; break;
+        case MARKDOC_SYM_HEADING: kind = CHILD_HEADING; break;
+        case MARKDOC_SYM_FENCED_CODE_BLOCK: kind = CHILD_FENCE; break;
+        case MARKDOC_SYM_UNORDERED_LIST:
+        case MARKDOC_SYM_ORDERED_LIST: kind = CHILD_LIST; break;
+        case MARKDOC_SYM_BLOCKQUOTE: kind = CHILD_BLOCKQUOTE; break;
+        case MARKDOC_SYM_THEMATIC_BREAK: kind = CHILD_HR; break;
+        case MARKDOC_SYM_MARKDOC_TAG: kind = CHILD_TAG; break;
+        default: return true;
+    }
+    if (schema->children == NULL || (kinds & kind) != 0) {
+        return true;
+    }
+    if (kind == CHILD_TAG) {
+        TSNode name = child_of_type(ts_node_named_child(node, 0), MARKDOC_SYM_TAG_NAME);
+        for (uint32_t i = 0; i < schema->child_count && !ts_node_is_null(name); i++) {
+            if (node_is(checker, name, schema->children[i])) {
+                return true;
+            }
+        }
+    }
+    return report(checker, MARKDOC_DIAGNOSTIC_CHILD_NOT_ALLOWED, node, parent,
+                  MARKDOC_SCHEMA_NONE);
+}
+
+// Nodes that cannot contain a tag. They are only entered to find errors.
+static bool is_opaque(TSSymbol symbol) {
+    switch (symbol) {
+        case MARKDOC_SYM_FRONTMATTER:
+        case MARKDOC_SYM_HEADING:
+        case MARKDOC_SYM_FENCED_CODE_BLOCK:
+        case MARKDOC_SYM_HTML_BLOCK:
+        case MARKDOC_SYM_HTML_COMMENT:
+        case MARKDOC_SYM_HTML_INLINE:
+        case MARKDOC_SYM_THEMATIC_BREAK:
+        case MARKDOC_SYM_COMMENT_BLOCK:
+        case MARKDOC_SYM_TEXT:
+        case MARKDOC_SYM_EMPHASIS:
+        case MARKDOC_SYM_STRONG:
+        case MARKDOC_SYM_INLINE_CODE:
+        case MARKDOC_SYM_LINK:
+        case MARKDOC_SYM_IMAGE:
+        case MARKDOC_SYM_INLINE_EXPRESSION:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// `parent` is the schema index of the tag whose body directly holds the
+// node under the cursor, or MARKDOC_SCHEMA_NONE.
+static bool visit(Checker *checker, TSTreeCursor *cursor, uint32_t parent) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    TSSymbol symbol = ts_node_symbol(node);
+    if (ts_node_is_missing(node) || symbol == MARKDOC_SYM_ERROR) {
+        return report(checker, MARKDOC_DIAGNOSTIC_SYNTAX, node, MARKDOC_SCHEMA_NONE,
+                      MARKDOC_SCHEMA_NONE);
+    }
+    if (parent != MARKDOC_SCHEMA_NONE && !check_child(checker, node, parent)) {
+        return false;
+    }
+    if (!ts_node_is_named(node) || (is_opaque(symbol) && !ts_node_has_error(node))) {
+        return true;
+    }
+
+    uint32_t tag = MARKDOC_SCHEMA_NONE;
+    if ((symbol == MARKDOC_SYM_MARKDOC_TAG || symbol == MARKDOC_SYM_INLINE_TAG) &&
+        !check_tag(checker, node, &tag)) {
+        return false;
+    }
+    if (symbol != MARKDOC_SYM_MARKDOC_TAG) {
+        tag = MARKDOC_SCHEMA_NONE;
+    }
+
+    bool ok = true;
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            ok = visit(checker, cursor, tag);
+        } while (ok && ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    return ok;
+}
+
+bool markdoc_validate(const MarkdocValidator *validator, TSNode node, const char *source,
+                      MarkdocDiagnostics *diagnostics) {
+    *diagnostics = (MarkdocDiagnostics){0};
+    if (!ts_node_is_null(node) && !markdoc_symbols_match(ts_node_language(node))) {
+        return false;
+    }
+    if (ts_node_is_null(node)) {
+        return true;
+    }
+    Checker checker = {.validator = validator, .source = source, .diagnostics = diagnostics};
+    TSTreeCursor cursor = ts_tree_cursor_new(node);
+    bool ok = visit(&checker, &cursor, MARKDOC_SCHEMA_NONE);
+    ts_tree_cursor_delete(&cursor);
+    if (!ok) {
+        markdoc_diagnostics_delete(diagnostics);
+    }
+    return ok;
+}
+
+void markdoc_diagnostics_delete(MarkdocDiagnostics *diagnostics) {
+    free(diagnostics->diagnostics);
+    *diagnostics = (MarkdocDiagnostics){0};
+}
+
+const char *markdoc_diagnostic_message(MarkdocDiagnosticKind kind) {
+    switch (kind) {
+        case MARKDOC_DIAGNOSTIC_SYNTAX: return "syntax error";
+        case MARKDOC_DIAGNOSTIC_UNKNOWN_TAG: return "unknown tag";
+        case MARKDOC_DIAGNOSTIC_CLOSE_MISMATCH: return "closing tag does not match";
+        case MARKDOC_DIAGNOSTIC_WRONG_FORM: return "tag is in the wrong form";
+        case MARKDOC_DIAGNOSTIC_UNKNOWN_ATTRIBUTE: return "unknown attribute";
+        case MARKDOC_DIAGNOSTIC_DUPLICATE_ATTRIBUTE: return "duplicate attribute";
+        case MARKDOC_DIAGNOSTIC_MISSING_ATTRIBUTE: return "missing required attribute";
+        case MARKDOC_DIAGNOSTIC_ATTRIBUTE_TYPE: return "attribute value has the wrong type";
+        case MARKDOC_DIAGNOSTIC_CHILD_NOT_ALLOWED: return "not allowed in this tag";
+    }
+    return "unknown diagnostic";
+}
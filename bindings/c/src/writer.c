@@ -0,0 +1,41 @@
+#include "tree_sitter/markdoc/writer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static bool buffer_write(void *payload, const char *data, size_t length) {
+    MarkdocBuffer *buffer = payload;
+    if (buffer->capacity - buffer->length <= length) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+        while (capacity - buffer->length <= length) {
+            capacity *= 2;
+        }
+        char *grown = realloc(buffer->data, capacity);
+        if (grown == NULL) {
+            return false;
+        }
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+    buffer->data[buffer->length] = '\0';
+    return true;
+}
+
+MarkdocWriter markdoc_buffer_writer(MarkdocBuffer *buffer) {
+    return (MarkdocWriter){.write = buffer_write, .payload = buffer};
+}
+
+void markdoc_buffer_delete(MarkdocBuffer *buffer) {
+    free(buffer->data);
+    *buffer = (MarkdocBuffer){0};
+}
+
+static bool file_write(void *payload, const char *data, size_t length) {
+    return fwrite(data, 1, length, payload) == length;
+}
+
+MarkdocWriter markdoc_file_writer(FILE *file) {
+    return (MarkdocWriter){.write = file_write, .payload = file};
+}
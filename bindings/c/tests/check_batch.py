@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""
+Run markdoc-batch over a directory and check its NDJSON report: exactly one
+record per .mdoc/.md file under it, each with the file's size in bytes, a
+non-empty tree and integer error and timing fields.
+
+    check_batch.py MARKDOC_BATCH DIRECTORY
+"""
+
+import json
+import os
+import subprocess
+import sys
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    batch, directory = sys.argv[1:]
+
+    expected = {}
+    for parent, _, names in os.walk(directory):
+        for name in names:
+            if name.endswith((".mdoc", ".md")):
+                path = os.path.join(parent, name)
+                expected[os.path.normpath(path)] = os.path.getsize(path)
+
+    result = subprocess.run([batch, "-j", "2", directory], capture_output=True, text=True)
+    if result.returncode != 0:
+        print(f"markdoc-batch exited with {result.returncode}:\n{result.stderr}",
+              file=sys.stderr)
+        return 1
+
+    failures = 0
+    seen = set()
+    for line in result.stdout.splitlines():
+        try:
+            record = json.loads(line)
+        except json.JSONDecodeError:
+            print(f"not JSON: {line}", file=sys.stderr)
+            failures += 1
+            continue
+        path = os.path.normpath(str(record.get("path")))
+        if path not in expected or path in seen:
+            print(f"unexpected or repeated path: {path}", file=sys.stderr)
+            failures += 1
+            continue
+        seen.add(path)
+        if record.get("bytes") != expected[path]:
+            print(f"{path}: bytes {record.get('bytes')}, file has {expected[path]}",
+                  file=sys.stderr)
+            failures += 1
+        if not isinstance(record.get("nodes"), int) or record["nodes"] < 1:
+            print(f"{path}: no nodes", file=sys.stderr)
+            failures += 1
+        for key in ("errors", "parse_us"):
+            if not isinstance(record.get(key), int) or record[key] < 0:
+                print(f"{path}: bad {key}: {record.get(key)}", file=sys.stderr)
+                failures += 1
+    for path in sorted(set(expected) - seen):
+        print(f"{path}: no record", file=sys.stderr)
+        failures += 1
+
+    if failures == 0:
+        print(f"batch: ok ({len(seen)} records)")
+    return 0 if failures == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
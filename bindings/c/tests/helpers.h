@@ -0,0 +1,35 @@
+// Helpers shared by the tests and the benchmarks.
+
+#ifndef TREE_SITTER_MARKDOC_TESTS_HELPERS_H_
+#define TREE_SITTER_MARKDOC_TESTS_HELPERS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tree_sitter/tree-sitter-tree-sitter-markdoc.h"
+
+// Reads a whole file into a NUL-terminated heap buffer the caller frees.
+// Returns NULL if it cannot be read.
+static inline char *read_file(const char *path, uint32_t *length) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *buffer = size < 0 ? NULL : malloc((size_t)size + 1);
+    if (buffer != NULL && fread(buffer, 1, (size_t)size, file) != (size_t)size) {
+        free(buffer);
+        buffer = NULL;
+    }
+    fclose(file);
+    if (buffer != NULL) {
+        buffer[size] = '\0';
+        *length = (uint32_t)size;
+    }
+    return buffer;
+}
+
+#endif // TREE_SITTER_MARKDOC_TESTS_HELPERS_H_
@@ -0,0 +1,74 @@
+// Asserts that parsing with tree-sitter's allocations routed to an arena
+// yields the same trees as the heap, and that a reset arena serves the next
+// parse from the blocks it already has.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/arena.h"
+
+// Parses `source` with a fresh parser and returns the tree's node count.
+static uint32_t parse_and_count(const char *source, uint32_t length) {
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+    uint32_t count = ts_node_descendant_count(ts_tree_root_node(tree));
+    ts_tree_delete(tree);
+    ts_parser_delete(parser);
+    return count;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    markdoc_arena_install();
+    MarkdocArena *arena = markdoc_arena_new(0);
+
+    int failures = 0;
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+
+        uint32_t expected = parse_and_count(source, length);
+
+        markdoc_arena_activate(arena);
+        uint32_t first = parse_and_count(source, length);
+        markdoc_arena_activate(NULL);
+        MarkdocArenaStats after_first = markdoc_arena_stats(arena);
+        markdoc_arena_reset(arena);
+
+        markdoc_arena_activate(arena);
+        uint32_t second = parse_and_count(source, length);
+        markdoc_arena_activate(NULL);
+        MarkdocArenaStats after_second = markdoc_arena_stats(arena);
+        markdoc_arena_reset(arena);
+
+        if (first != expected || second != expected) {
+            fprintf(stderr, "%s: %u and %u nodes in the arena, %u on the heap\n", argv[i],
+                    first, second, expected);
+            failures++;
+        } else if (after_first.allocations == 0 ||
+                   after_second.bytes_reserved != after_first.bytes_reserved) {
+            fprintf(stderr, "%s: arena served %llu allocations, reserved %zu then %zu bytes\n",
+                    argv[i], (unsigned long long)after_first.allocations,
+                    after_first.bytes_reserved, after_second.bytes_reserved);
+            failures++;
+        } else {
+            printf("%s: ok (%u nodes, %zu bytes reserved)\n", argv[i], expected,
+                   after_second.bytes_reserved);
+        }
+        free(source);
+    }
+
+    markdoc_arena_delete(arena);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,281 @@
+// Asserts that markdoc_ast_write_json() writes well-formed JSON with one
+// heading, fence and tag node per heading, fenced_code_block and tag in the
+// tree, that tag attributes and variables take Markdoc's shapes, that the
+// markup inside heading text, emphasis, link text, HTML blocks and
+// blockquotes is written as Markdoc's nodes, that string escapes stay valid
+// JSON, and that a failing writer stops the emitter.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/ast.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+// A recursive-descent JSON checker; returns the end of the value at `at`,
+// or NULL if it is malformed.
+static const char *skip_value(const char *at);
+
+static const char *skip_space(const char *at) {
+    while (*at == ' ' || *at == '\n' || *at == '\r' || *at == '\t') {
+        at++;
+    }
+    return at;
+}
+
+static const char *skip_string(const char *at) {
+    if (*at++ != '"') {
+        return NULL;
+    }
+    while (*at != '"') {
+        if ((unsigned char)*at < 0x20) {
+            return NULL;
+        }
+        if (*at == '\\') {
+            at++;
+            if (*at == 'u') {
+                for (int i = 1; i <= 4; i++) {
+                    if (strchr("0123456789abcdefABCDEF", at[i]) == NULL || at[i] == '\0') {
+                        return NULL;
+                    }
+                }
+                at += 4;
+            } else if (strchr("\"\\/bfnrt", *at) == NULL || *at == '\0') {
+                return NULL;
+            }
+        }
+        at++;
+    }
+    return at + 1;
+}
+
+static const char *skip_members(const char *at, char close, bool keys) {
+    at = skip_space(at + 1);
+    if (*at == close) {
+        return at + 1;
+    }
+    for (;;) {
+        if (keys) {
+            at = skip_string(skip_space(at));
+            if (at == NULL || *(at = skip_space(at)) != ':') {
+                return NULL;
+            }
+            at++;
+        }
+        at = skip_value(at);
+        if (at == NULL) {
+            return NULL;
+        }
+        at = skip_space(at);
+        if (*at == close) {
+            return at + 1;
+        }
+        if (*at++ != ',') {
+            return NULL;
+        }
+    }
+}
+
+static const char *skip_value(const char *at) {
+    at = skip_space(at);
+    switch (*at) {
+        case '{': return skip_members(at, '}', true);
+        case '[': return skip_members(at, ']', false);
+        case '"': return skip_string(at);
+        case 't': return strncmp(at, "true", 4) == 0 ? at + 4 : NULL;
+        case 'f': return strncmp(at, "false", 5) == 0 ? at + 5 : NULL;
+        case 'n': return strncmp(at, "null", 4) == 0 ? at + 4 : NULL;
+        default: break;
+    }
+    const char *start = at;
+    if (*at == '-') {
+        at++;
+    }
+    if (*at == '0' && at[1] >= '0' && at[1] <= '9') {
+        return NULL;
+    }
+    while (*at >= '0' && *at <= '9') {
+        at++;
+    }
+    if (*at == '.') {
+        at++;
+        while (*at >= '0' && *at <= '9') {
+            at++;
+        }
+    }
+    return at > start && at[-1] != '-' ? at : NULL;
+}
+
+static bool is_json(const char *text) {
+    const char *end = skip_value(text);
+    return end != NULL && *skip_space(end) == '\0';
+}
+
+static uint32_t count_substring(const char *text, const char *needle) {
+    uint32_t count = 0;
+    for (const char *at = strstr(text, needle); at != NULL; at = strstr(at + 1, needle)) {
+        count++;
+    }
+    return count;
+}
+
+// Counts headings, tags, and fences outside other fences' code.
+static void count_nodes(TSNode node, uint32_t *headings, uint32_t *fences, uint32_t *tags) {
+    TSSymbol symbol = ts_node_symbol(node);
+    *headings += symbol == MARKDOC_SYM_HEADING;
+    *tags += symbol == MARKDOC_SYM_TAG_OPEN || symbol == MARKDOC_SYM_TAG_SELF_CLOSE;
+    if (symbol == MARKDOC_SYM_FENCED_CODE_BLOCK) {
+        (*fences)++;
+        return;
+    }
+    // Error nodes are written without their contents.
+    if (symbol == MARKDOC_SYM_ERROR) {
+        return;
+    }
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        count_nodes(ts_node_named_child(node, i), headings, fences, tags);
+    }
+}
+
+static bool failing_write(void *payload, const char *data, size_t length) {
+    (void)data;
+    size_t *budget = payload;
+    if (length > *budget) {
+        return false;
+    }
+    *budget -= length;
+    return true;
+}
+
+// Emits `source` and reports whether the JSON contains each of `expected`.
+static int check_snippets(TSParser *parser, const char *source, const char *const *expected,
+                          size_t expected_count) {
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)strlen(source));
+    MarkdocBuffer buffer = {0};
+    int failures = 0;
+    if (!markdoc_ast_write_json(ts_tree_root_node(tree), source, markdoc_buffer_writer(&buffer)) ||
+        !is_json(buffer.data)) {
+        fprintf(stderr, "snippet: invalid output for %s\n", source);
+        failures++;
+    } else {
+        for (size_t i = 0; i < expected_count; i++) {
+            if (strstr(buffer.data, expected[i]) == NULL) {
+                fprintf(stderr, "snippet: %s not in %s\n", expected[i], buffer.data);
+                failures++;
+            }
+        }
+    }
+    if (failures == 0) {
+        printf("snippet: ok (%zu bytes)\n", buffer.length);
+    }
+    markdoc_buffer_delete(&buffer);
+    ts_tree_delete(tree);
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+
+    static const char *const expected[] = {
+        "\"attributes\":{\"frontmatter\":\"title: Hi\"}",
+        "\"attributes\":{\"level\":2}",
+        "\"attributes\":{\"type\":\"note\",\"count\":3}",
+        "\"type\":\"tag\",\"tag\":\"callout\"",
+        "\"content\":{\"$$mdtype\":\"Variable\",\"path\":[\"user\",\"name\"]}",
+        "\"attributes\":{\"content\":\"let a = 1;\\n\",\"language\":\"js\"}",
+    };
+    int failures = check_snippets(parser,
+                                  "---\ntitle: Hi\n---\n\n## Intro\n\n"
+                                  "{% callout type=\"note\" count=3 %}\n"
+                                  "Hello {% $user.name %}\n"
+                                  "{% /callout %}\n\n"
+                                  "```js\nlet a = 1;\n```\n",
+                                  expected, sizeof(expected) / sizeof(expected[0]));
+
+    // Each expectation ends a node with its last child.
+    static const char *const nested[] = {
+        "\"attributes\":{\"content\":\"world\"},\"children\":[],\"type\":\"text\","
+        "\"annotations\":[],\"slots\":{}}],\"type\":\"em\"",
+        "\"attributes\":{\"content\":\" in snake_case_name\"}",
+        "\"attributes\":{\"content\":\"b\"},\"children\":[],\"type\":\"text\","
+        "\"annotations\":[],\"slots\":{}}],\"type\":\"strong\"",
+        "\"attributes\":{\"content\":\" text\"},\"children\":[],\"type\":\"text\","
+        "\"annotations\":[],\"slots\":{}}],\"type\":\"link\"",
+        "\"attributes\":{\"content\":\"<div>\"}",
+        "\"type\":\"softbreak\"",
+        "\"attributes\":{\"content\":\"four\"},\"children\":[],\"type\":\"text\","
+        "\"annotations\":[],\"slots\":{}}],\"type\":\"inline\",\"annotations\":[],"
+        "\"slots\":{}}],\"type\":\"paragraph\",\"annotations\":[],\"slots\":{}}],"
+        "\"type\":\"blockquote\"",
+    };
+    failures += check_snippets(parser,
+                               "## Hello *world* and `code` in snake_case_name\n\n"
+                               "Read _a **b** c_ and [**bold** text](x.md).\n\n"
+                               "<div>\n*hi* there\n</div>\n\n"
+                               "> one *two*\n> three\n>\n> four\n",
+                               nested, sizeof(nested) / sizeof(nested[0]));
+
+    // JSON only knows `\u` before four hex digits; other backslashes before
+    // `u` are written as backslashes.
+    static const char *const escapes[] = {
+        "\"attributes\":{\"a\":\"\\u0041\",\"b\":\"\\\\u12\",\"c\":\"\\\\uZZZZ\","
+        "\"d\":\"x\\\\u\"}",
+    };
+    failures += check_snippets(parser, "{% note a=\"\\u0041\" b=\"\\u12\" c=\"\\uZZZZ\" "
+                                       "d=\"x\\u\" /%}\n",
+                               escapes, sizeof(escapes) / sizeof(escapes[0]));
+
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+        TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+        TSNode root = ts_tree_root_node(tree);
+
+        MarkdocBuffer buffer = {0};
+        bool ok = markdoc_ast_write_json(root, source, markdoc_buffer_writer(&buffer));
+        uint32_t headings = 0, fences = 0, tags = 0;
+        count_nodes(root, &headings, &fences, &tags);
+
+        size_t budget = buffer.length / 2;
+        MarkdocWriter failing = {.write = failing_write, .payload = &budget};
+        bool stopped = !markdoc_ast_write_json(root, source, failing);
+
+        if (!ok || !is_json(buffer.data)) {
+            fprintf(stderr, "%s: output is not valid JSON\n", argv[i]);
+            failures++;
+        } else if (count_substring(buffer.data, "\"type\":\"heading\"") != headings ||
+                   count_substring(buffer.data, "\"type\":\"fence\"") != fences ||
+                   count_substring(buffer.data, "\"type\":\"tag\"") != tags) {
+            fprintf(stderr, "%s: %u/%u/%u heading/fence/tag nodes, tree has %u/%u/%u\n",
+                    argv[i], count_substring(buffer.data, "\"type\":\"heading\""),
+                    count_substring(buffer.data, "\"type\":\"fence\""),
+                    count_substring(buffer.data, "\"type\":\"tag\""), headings, fences, tags);
+            failures++;
+        } else if (!stopped) {
+            fprintf(stderr, "%s: a failing writer did not stop the emitter\n", argv[i]);
+            failures++;
+        } else {
+            printf("%s: ok (%zu bytes of JSON)\n", argv[i], buffer.length);
+        }
+
+        markdoc_buffer_delete(&buffer);
+        ts_tree_delete(tree);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
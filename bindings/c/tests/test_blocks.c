@@ -0,0 +1,249 @@
+// Asserts that markdoc_block_hashes_build() hashes the top-level blocks and
+// every markdoc_tag a full walk of the tree finds, that equal blocks hash
+// equally wherever they are, and that after an edit and an incremental
+// reparse markdoc_block_hashes_update() gives the same hashes as a fresh
+// build, changing those of an edited tag and of the tags it is nested in.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/blocks.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+// Counts the markdoc_tags under `node` at any depth, outside error nodes.
+static uint32_t count_tags(TSNode node) {
+    if (ts_node_symbol(node) == MARKDOC_SYM_ERROR) {
+        return 0;
+    }
+    uint32_t tags = ts_node_symbol(node) == MARKDOC_SYM_MARKDOC_TAG;
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        tags += count_tags(ts_node_named_child(node, i));
+    }
+    return tags;
+}
+
+// The named children of the root and the markdoc_tags nested in them.
+static uint32_t count_blocks(TSNode root) {
+    uint32_t blocks = 0;
+    uint32_t count = ts_node_named_child_count(root);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode child = ts_node_named_child(root, i);
+        blocks += ts_node_symbol(child) == MARKDOC_SYM_MARKDOC_TAG ? count_tags(child)
+                                                                   : 1 + count_tags(child);
+    }
+    return blocks;
+}
+
+static bool same_hash(const MarkdocBlock *a, const MarkdocBlock *b) {
+    return a->hash[0] == b->hash[0] && a->hash[1] == b->hash[1];
+}
+
+static bool same_blocks(const MarkdocBlockHashes *a, const MarkdocBlockHashes *b) {
+    if (a->count != b->count) {
+        return false;
+    }
+    for (uint32_t i = 0; i < a->count; i++) {
+        const MarkdocBlock *x = &a->blocks[i], *y = &b->blocks[i];
+        if (x->start_byte != y->start_byte || x->end_byte != y->end_byte ||
+            x->symbol != y->symbol || x->parent != y->parent || !same_hash(x, y)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static TSPoint point_at(const char *source, uint32_t byte) {
+    TSPoint point = {0, 0};
+    for (uint32_t i = 0; i < byte; i++) {
+        if (source[i] == '\n') {
+            point.row++;
+            point.column = 0;
+        } else {
+            point.column++;
+        }
+    }
+    return point;
+}
+
+// Inserts `text` at `at`, reparses incrementally and updates `hashes`.
+// Returns the new source, or NULL if the update disagrees with a build.
+static char *edit_and_update(TSParser *parser, TSTree **tree, char *source, uint32_t *length,
+                             uint32_t at, const char *text, MarkdocBlockHashes *hashes) {
+    uint32_t inserted = (uint32_t)strlen(text);
+    char *edited = malloc(*length + inserted + 1);
+    memcpy(edited, source, at);
+    memcpy(edited + at, text, inserted);
+    memcpy(edited + at + inserted, source + at, *length - at + 1);
+
+    TSInputEdit edit = {
+        .start_byte = at,
+        .old_end_byte = at,
+        .new_end_byte = at + inserted,
+        .start_point = point_at(source, at),
+        .old_end_point = point_at(source, at),
+        .new_end_point = point_at(edited, at + inserted),
+    };
+    ts_tree_edit(*tree, &edit);
+    markdoc_block_hashes_edit(hashes, &edit);
+    TSTree *new_tree = ts_parser_parse_string(parser, *tree, edited, *length + inserted);
+    uint32_t changed_count = 0;
+    TSRange *changed = ts_tree_get_changed_ranges(*tree, new_tree, &changed_count);
+    bool ok = markdoc_block_hashes_update(hashes, ts_tree_root_node(new_tree), edited, changed,
+                                          changed_count);
+    free(changed);
+    ts_tree_delete(*tree);
+    *tree = new_tree;
+    free(source);
+    *length += inserted;
+
+    MarkdocBlockHashes fresh = {0};
+    ok = ok && markdoc_block_hashes_build(ts_tree_root_node(new_tree), edited, &fresh);
+    ok = ok && same_blocks(hashes, &fresh);
+    markdoc_block_hashes_delete(&fresh);
+    if (!ok) {
+        free(edited);
+        return NULL;
+    }
+    return edited;
+}
+
+static int check_snippet(TSParser *parser) {
+    static const char text[] = "{% note %}\nSame text.\n{% /note %}\n\n"
+                               "{% note %}\nSame text.\n{% /note %}\n\n"
+                               "{% card %}\n{% note %}\nOther.\n{% /note %}\n{% /card %}\n";
+    uint32_t length = sizeof(text) - 1;
+    char *source = malloc(length + 1);
+    memcpy(source, text, length + 1);
+
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+    MarkdocBlockHashes hashes;
+    int failures = 0;
+    if (!markdoc_block_hashes_build(ts_tree_root_node(tree), source, &hashes)) {
+        fprintf(stderr, "snippet: out of memory\n");
+        ts_tree_delete(tree);
+        free(source);
+        return 1;
+    }
+    if (hashes.count != 4 || hashes.blocks[3].parent != 2) {
+        fprintf(stderr, "snippet: %u blocks, expected the card's note nested in it\n",
+                hashes.count);
+        failures++;
+    } else if (!same_hash(&hashes.blocks[0], &hashes.blocks[1]) ||
+               same_hash(&hashes.blocks[0], &hashes.blocks[3])) {
+        fprintf(stderr, "snippet: equal notes hash differently, or different ones equally\n");
+        failures++;
+    }
+    MarkdocBlock before[4] = {{0}};
+    if (failures == 0) {
+        memcpy(before, hashes.blocks, sizeof(before));
+    }
+
+    // Text above the notes moves them without changing their hashes.
+    source = edit_and_update(parser, &tree, source, &length, 0, "Intro\n\n", &hashes);
+    if (source == NULL) {
+        fprintf(stderr, "snippet: the updated hashes differ from a fresh build\n");
+        failures++;
+    } else if (failures == 0 &&
+               (hashes.count != 5 || !same_hash(&hashes.blocks[1], &before[0]) ||
+                !same_hash(&hashes.blocks[3], &before[2]))) {
+        fprintf(stderr, "snippet: moved blocks hash differently\n");
+        failures++;
+    }
+
+    // Editing the nested note changes its hash and the card's, not the others.
+    if (source != NULL) {
+        const char *other = strstr(source, "Other.");
+        source = edit_and_update(parser, &tree, source, &length, (uint32_t)(other - source), "An",
+                                 &hashes);
+        if (source == NULL) {
+            fprintf(stderr, "snippet: the updated hashes differ from a fresh build\n");
+            failures++;
+        } else if (failures == 0 &&
+                   (hashes.count != 5 || !same_hash(&hashes.blocks[1], &before[0]) ||
+                    hashes.blocks[1].changed || same_hash(&hashes.blocks[3], &before[2]) ||
+                    same_hash(&hashes.blocks[4], &before[3]) || !hashes.blocks[4].changed)) {
+            fprintf(stderr, "snippet: the edited note did not change its hash and the card's\n");
+            failures++;
+        }
+    }
+    if (failures == 0) {
+        printf("snippet: ok (%u blocks)\n", hashes.count);
+    }
+    markdoc_block_hashes_delete(&hashes);
+    ts_tree_delete(tree);
+    free(source);
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+    int failures = check_snippet(parser);
+
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+        TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+
+        MarkdocBlockHashes hashes;
+        if (!markdoc_block_hashes_build(ts_tree_root_node(tree), source, &hashes)) {
+            fprintf(stderr, "%s: out of memory\n", argv[i]);
+            failures++;
+            ts_tree_delete(tree);
+            free(source);
+            continue;
+        }
+        uint32_t expected = count_blocks(ts_tree_root_node(tree));
+        bool matches = hashes.count == expected;
+        if (!matches) {
+            fprintf(stderr, "%s: hashed %u blocks, the tree has %u\n", argv[i], hashes.count,
+                    expected);
+            failures++;
+        }
+
+        // Add a paragraph in the middle of the document, then at the start.
+        uint32_t changed_blocks = 0;
+        uint32_t middle = length / 2;
+        while (middle < length && source[middle - 1] != '\n') {
+            middle++;
+        }
+        source = edit_and_update(parser, &tree, source, &length, middle, "A new paragraph.\n\n",
+                                 &hashes);
+        bool updated = source != NULL;
+        for (uint32_t j = 0; updated && j < hashes.count; j++) {
+            changed_blocks += hashes.blocks[j].changed;
+        }
+        if (updated) {
+            source = edit_and_update(parser, &tree, source, &length, 0, "Intro\n\n", &hashes);
+            updated = source != NULL;
+        }
+
+        if (!updated) {
+            fprintf(stderr, "%s: the updated hashes differ from a fresh build\n", argv[i]);
+            failures++;
+        } else if (matches) {
+            printf("%s: ok (%u blocks, %u hashed again after an edit)\n", argv[i], hashes.count,
+                   changed_blocks);
+        }
+
+        markdoc_block_hashes_delete(&hashes);
+        ts_tree_delete(tree);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
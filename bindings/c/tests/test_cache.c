@@ -0,0 +1,169 @@
+// Asserts that a tree stored in the parse cache loads back identical to a
+// fresh export, that the second markdoc_cache_parse() of a file is a hit,
+// that changing one byte of the document misses, and that threads storing
+// the same entry at once all succeed and leave no temporary file behind.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <dirent.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/cache.h"
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static bool same_tree(const MarkdocFlatTree *a, const MarkdocFlatTree *b) {
+    uint32_t n = a->node_count;
+    return n == b->node_count &&
+           memcmp(a->start_bytes, b->start_bytes, n * sizeof(uint32_t)) == 0 &&
+           memcmp(a->end_bytes, b->end_bytes, n * sizeof(uint32_t)) == 0 &&
+           memcmp(a->parents, b->parents, n * sizeof(uint32_t)) == 0 &&
+           memcmp(a->first_children, b->first_children, n * sizeof(uint32_t)) == 0 &&
+           memcmp(a->next_siblings, b->next_siblings, n * sizeof(uint32_t)) == 0 &&
+           memcmp(a->symbols, b->symbols, n * sizeof(TSSymbol)) == 0 &&
+           memcmp(a->field_ids, b->field_ids, n * sizeof(TSFieldId)) == 0;
+}
+
+typedef struct {
+    const char *directory;
+    const MarkdocCacheKey *key;
+    const MarkdocFlatTree *flat;
+    bool ok;
+} StoreJob;
+
+static void *store_entry(void *payload) {
+    StoreJob *job = payload;
+    job->ok = markdoc_cache_store(job->directory, job->key, job->flat);
+    return NULL;
+}
+
+// Stores `flat` under one key from several threads at once. A temporary
+// file shared between them would be truncated and renamed away under the
+// others.
+static int check_concurrent_store(const char *directory, const MarkdocFlatTree *flat) {
+    enum { THREADS = 8 };
+    static const char name[] = "concurrent store";
+    MarkdocCacheKey key = markdoc_cache_key(tree_sitter_markdoc(), name, sizeof(name) - 1);
+    StoreJob jobs[THREADS];
+    pthread_t threads[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        jobs[i] = (StoreJob){directory, &key, flat, false};
+        pthread_create(&threads[i], NULL, store_entry, &jobs[i]);
+    }
+    int failures = 0;
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        if (!jobs[i].ok) {
+            fprintf(stderr, "concurrent store: thread %d failed\n", i);
+            failures++;
+        }
+    }
+
+    MarkdocFlatTree loaded;
+    if (!markdoc_cache_load(directory, &key, &loaded)) {
+        fprintf(stderr, "concurrent store: entry does not load\n");
+        failures++;
+    } else {
+        if (!same_tree(flat, &loaded)) {
+            fprintf(stderr, "concurrent store: loaded tree differs\n");
+            failures++;
+        }
+        markdoc_flat_tree_delete(&loaded);
+    }
+
+    // Entries live in <directory>/<first byte>/<other 15 bytes>, in hex.
+    char fan_out[4096], entry[31];
+    snprintf(fan_out, sizeof(fan_out), "%s/%02x", directory, key.bytes[0]);
+    for (int i = 1; i < 16; i++) {
+        snprintf(entry + (i - 1) * 2, 3, "%02x", key.bytes[i]);
+    }
+    DIR *listing = opendir(fan_out);
+    for (struct dirent *file; listing != NULL && (file = readdir(listing)) != NULL;) {
+        if (strncmp(file->d_name, entry, 30) == 0 && file->d_name[30] != '\0') {
+            fprintf(stderr, "concurrent store: %s left behind\n", file->d_name);
+            failures++;
+        }
+    }
+    if (listing != NULL) {
+        closedir(listing);
+    }
+    if (failures == 0) {
+        printf("concurrent store: ok (%d threads)\n", THREADS);
+    }
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <empty-cache-dir> <file>...\n", argv[0]);
+        return 2;
+    }
+    const char *directory = argv[1];
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+
+    int failures = 0;
+    for (int i = 2; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL || length == 0) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            free(source);
+            failures++;
+            continue;
+        }
+
+        double start = now_us();
+        TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+        MarkdocFlatTree expected;
+        markdoc_flat_tree_export(ts_tree_root_node(tree), &expected);
+        double parse_us = now_us() - start;
+        ts_tree_delete(tree);
+
+        MarkdocFlatTree stored, loaded, edited;
+        bool first_hit = true, second_hit = false, edited_hit = true;
+        bool ok = markdoc_cache_parse(directory, parser, source, length, &stored, &first_hit);
+        start = now_us();
+        ok = markdoc_cache_parse(directory, parser, source, length, &loaded, &second_hit) && ok;
+        double load_us = now_us() - start;
+
+        source[length - 1] ^= 1;
+        ok = markdoc_cache_parse(directory, parser, source, length, &edited, &edited_hit) && ok;
+
+        if (!ok || first_hit || !second_hit || edited_hit) {
+            fprintf(stderr, "%s: expected miss, hit, miss; got %s, %s, %s\n", argv[i],
+                    first_hit ? "hit" : "miss", second_hit ? "hit" : "miss",
+                    edited_hit ? "hit" : "miss");
+            failures++;
+        } else if (!same_tree(&expected, &stored) || !same_tree(&expected, &loaded)) {
+            fprintf(stderr, "%s: cached tree differs\n", argv[i]);
+            failures++;
+        } else {
+            printf("%s: ok (%u nodes, parse %.0f us, cache load %.0f us)\n", argv[i],
+                   expected.node_count, parse_us, load_us);
+        }
+
+        if (i == 2) {
+            failures += check_concurrent_store(directory, &expected);
+        }
+
+        markdoc_flat_tree_delete(&expected);
+        markdoc_flat_tree_delete(&stored);
+        markdoc_flat_tree_delete(&loaded);
+        markdoc_flat_tree_delete(&edited);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+// Asserts that markdoc_fence_index_build() finds the fences a full walk of
+// the tree finds, with their language, and that after an edit and an
+// incremental reparse markdoc_fence_index_update() gives the same index as a
+// fresh build while marking the edited fence changed.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/fences.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+// Collects the fenced_code_blocks of the whole tree in pre-order, outside
+// error nodes, as injections.scm would match them.
+static void collect_fences(TSNode node, TSNode *fences, uint32_t *count, uint32_t capacity) {
+    TSSymbol symbol = ts_node_symbol(node);
+    if (symbol == MARKDOC_SYM_ERROR) {
+        return;
+    }
+    if (symbol == MARKDOC_SYM_FENCED_CODE_BLOCK && *count < capacity) {
+        fences[(*count)++] = node;
+    }
+    uint32_t child_count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < child_count; i++) {
+        collect_fences(ts_node_named_child(node, i), fences, count, capacity);
+    }
+}
+
+static bool same_fences(const MarkdocFenceIndex *a, const MarkdocFenceIndex *b) {
+    if (a->count != b->count) {
+        return false;
+    }
+    for (uint32_t i = 0; i < a->count; i++) {
+        const MarkdocFence *x = &a->fences[i], *y = &b->fences[i];
+        if (x->start_byte != y->start_byte || x->end_byte != y->end_byte ||
+            x->language_start != y->language_start || x->language_end != y->language_end ||
+            x->attributes_start != y->attributes_start ||
+            x->attributes_end != y->attributes_end || x->code_start != y->code_start ||
+            x->code_end != y->code_end || x->depth != y->depth) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static TSPoint point_at(const char *source, uint32_t byte) {
+    TSPoint point = {0, 0};
+    for (uint32_t i = 0; i < byte; i++) {
+        if (source[i] == '\n') {
+            point.row++;
+            point.column = 0;
+        } else {
+            point.column++;
+        }
+    }
+    return point;
+}
+
+// Inserts `text` at `at`, reparses incrementally and updates `index`.
+// Returns the new source, or NULL if the update disagrees with a build.
+static char *edit_and_update(TSParser *parser, TSTree **tree, char *source, uint32_t *length,
+                             uint32_t at, const char *text, MarkdocFenceIndex *index) {
+    uint32_t inserted = (uint32_t)strlen(text);
+    char *edited = malloc(*length + inserted + 1);
+    memcpy(edited, source, at);
+    memcpy(edited + at, text, inserted);
+    memcpy(edited + at + inserted, source + at, *length - at + 1);
+
+    TSInputEdit edit = {
+        .start_byte = at,
+        .old_end_byte = at,
+        .new_end_byte = at + inserted,
+        .start_point = point_at(source, at),
+        .old_end_point = point_at(source, at),
+        .new_end_point = point_at(edited, at + inserted),
+    };
+    ts_tree_edit(*tree, &edit);
+    markdoc_fence_index_edit(index, &edit);
+    TSTree *new_tree = ts_parser_parse_string(parser, *tree, edited, *length + inserted);
+    uint32_t changed_count = 0;
+    TSRange *changed = ts_tree_get_changed_ranges(*tree, new_tree, &changed_count);
+    bool ok = markdoc_fence_index_update(index, ts_tree_root_node(new_tree), changed,
+                                         changed_count);
+    free(changed);
+    ts_tree_delete(*tree);
+    *tree = new_tree;
+    free(source);
+    *length += inserted;
+
+    MarkdocFenceIndex fresh;
+    ok = ok && markdoc_fence_index_build(ts_tree_root_node(new_tree), &fresh);
+    ok = ok && same_fences(index, &fresh);
+    markdoc_fence_index_delete(&fresh);
+    if (!ok) {
+        free(edited);
+        return NULL;
+    }
+    return edited;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+    int failures = 0;
+
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+        TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+
+        static TSNode expected[4096];
+        uint32_t expected_count = 0;
+        collect_fences(ts_tree_root_node(tree), expected, &expected_count, 4096);
+
+        MarkdocFenceIndex index;
+        if (!markdoc_fence_index_build(ts_tree_root_node(tree), &index)) {
+            fprintf(stderr, "%s: out of memory\n", argv[i]);
+            failures++;
+            ts_tree_delete(tree);
+            free(source);
+            continue;
+        }
+        bool matches = index.count == expected_count;
+        for (uint32_t j = 0; matches && j < index.count; j++) {
+            const MarkdocFence *fence = &index.fences[j];
+            TSNode info = ts_node_named_child(ts_node_named_child(expected[j], 0), 0);
+            TSNode language = ts_node_is_null(info) ? info : ts_node_named_child(info, 0);
+            if (!ts_node_is_null(language) && ts_node_symbol(language) == MARKDOC_SYM_LANGUAGE) {
+                matches = fence->language_start == ts_node_start_byte(language) &&
+                          fence->language_end == ts_node_end_byte(language);
+            } else {
+                matches = fence->language_start == fence->language_end;
+            }
+            matches = matches && fence->start_byte == ts_node_start_byte(expected[j]);
+        }
+        if (!matches) {
+            fprintf(stderr, "%s: indexed %u fences, the tree has %u or their ranges differ\n",
+                    argv[i], index.count, expected_count);
+            failures++;
+        }
+
+        // Edit inside the first fence with code, then at the very start.
+        uint32_t changed_fences = 0;
+        bool updated = true;
+        for (uint32_t j = 0; j < index.count; j++) {
+            if (index.fences[j].code_end > index.fences[j].code_start) {
+                uint32_t edited_fence = j;
+                source = edit_and_update(parser, &tree, source, &length,
+                                         index.fences[j].code_start, "let x = 1;\n", &index);
+                updated = source != NULL && edited_fence < index.count &&
+                          index.fences[edited_fence].changed;
+                for (uint32_t k = 0; updated && k < index.count; k++) {
+                    changed_fences += index.fences[k].changed;
+                }
+                break;
+            }
+        }
+        if (updated && source != NULL) {
+            source = edit_and_update(parser, &tree, source, &length, 0, "Intro\n\n", &index);
+            updated = source != NULL;
+        }
+
+        if (!updated) {
+            fprintf(stderr, "%s: the updated index differs from a fresh build\n", argv[i]);
+            failures++;
+        } else if (matches) {
+            printf("%s: ok (%u fences, %u read again after a code edit)\n", argv[i],
+                   expected_count, changed_fences);
+        }
+
+        markdoc_fence_index_delete(&index);
+        ts_tree_delete(tree);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+// Asserts that the flat export of each file's tree lists the same nodes, in
+// pre-order and with the same links, as walking it with ts_node_child().
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/flat.h"
+
+static bool same_field(const char *expected, const char *actual) {
+    return expected == NULL ? actual == NULL : actual != NULL && strcmp(expected, actual) == 0;
+}
+
+// Checks `node` against entry `*next` and recurses into its children, which
+// must follow it in order. Returns false at the first difference.
+static bool check_node(const MarkdocFlatTree *flat, TSNode node, uint32_t parent,
+                       const char *field, uint32_t *next) {
+    uint32_t index = (*next)++;
+    if (index >= flat->node_count || flat->symbols[index] != ts_node_symbol(node) ||
+        flat->start_bytes[index] != ts_node_start_byte(node) ||
+        flat->end_bytes[index] != ts_node_end_byte(node) || flat->parents[index] != parent ||
+        !same_field(field, ts_language_field_name_for_id(tree_sitter_markdoc(),
+                                                         flat->field_ids[index]))) {
+        fprintf(stderr, "node %u (%s) differs\n", index, ts_node_type(node));
+        return false;
+    }
+
+    uint32_t child_count = ts_node_child_count(node);
+    uint32_t expected = child_count > 0 ? *next : MARKDOC_FLAT_NONE;
+    if (flat->first_children[index] != expected) {
+        fprintf(stderr, "node %u (%s) has the wrong first child\n", index, ts_node_type(node));
+        return false;
+    }
+    uint32_t previous = MARKDOC_FLAT_NONE;
+    for (uint32_t i = 0; i < child_count; i++) {
+        uint32_t child = *next;
+        if (previous != MARKDOC_FLAT_NONE && flat->next_siblings[previous] != child) {
+            fprintf(stderr, "node %u has the wrong next sibling\n", previous);
+            return false;
+        }
+        if (!check_node(flat, ts_node_child(node, i), index,
+                        ts_node_field_name_for_child(node, i), next)) {
+            return false;
+        }
+        previous = child;
+    }
+    if (previous != MARKDOC_FLAT_NONE && flat->next_siblings[previous] != MARKDOC_FLAT_NONE) {
+        fprintf(stderr, "node %u has a sibling after the last child\n", previous);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+
+    int failures = 0;
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+
+        TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+        TSNode root = ts_tree_root_node(tree);
+        MarkdocFlatTree flat;
+        uint32_t visited = 0;
+        if (!markdoc_flat_tree_export(root, &flat)) {
+            fprintf(stderr, "%s: markdoc_flat_tree_export failed\n", argv[i]);
+            failures++;
+        } else if (!check_node(&flat, root, MARKDOC_FLAT_NONE, NULL, &visited) ||
+                   visited != flat.node_count) {
+            fprintf(stderr, "%s: flat tree differs (%u of %u nodes visited)\n", argv[i],
+                    visited, flat.node_count);
+            failures++;
+        } else {
+            printf("%s: ok (%u nodes)\n", argv[i], flat.node_count);
+        }
+
+        markdoc_flat_tree_delete(&flat);
+        ts_tree_delete(tree);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
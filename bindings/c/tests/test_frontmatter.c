@@ -0,0 +1,191 @@
+// Asserts that markdoc_frontmatter_find() agrees with the scanner on where
+// frontmatter starts and ends, that markdoc_frontmatter_read_fd() returns
+// without reading past the closing `---` line (the pipe it reads from is
+// left open), and that both match the tree's frontmatter in the samples.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/frontmatter.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+static bool same_range(const char *source, uint32_t start, uint32_t end, const char *text) {
+    return end - start == strlen(text) && memcmp(source + start, text, end - start) == 0;
+}
+
+static bool same_frontmatter(const MarkdocFrontmatter *a, const MarkdocFrontmatter *b) {
+    return a->start_byte == b->start_byte && a->end_byte == b->end_byte &&
+           a->yaml_start_byte == b->yaml_start_byte && a->yaml_end_byte == b->yaml_end_byte;
+}
+
+// Writes `source` to a pipe and reads it back with
+// markdoc_frontmatter_read_fd(). Unless `close_first`, the write end stays
+// open while reading, so reading past the frontmatter would block.
+static bool read_through_pipe(const char *source, uint32_t length, bool close_first,
+                              MarkdocFrontmatterFile *file) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    bool ok = write(fds[1], source, length) == (ssize_t)length;
+    if (close_first) {
+        close(fds[1]);
+    }
+    ok = ok && markdoc_frontmatter_read_fd(fds[0], file);
+    if (!close_first) {
+        close(fds[1]);
+    }
+    close(fds[0]);
+    return ok;
+}
+
+static int check_snippets(void) {
+    // `block` is NULL when there is no frontmatter.
+    static const struct {
+        const char *source;
+        const char *block;
+        const char *yaml;
+    } cases[] = {
+        {"---\ntitle: x\n---\nbody\n", "---\ntitle: x\n---", "title: x\n"},
+        {"---  \r\na: 1\r\n---\t\r\nbody", "---  \r\na: 1\r\n---\t", "a: 1\r\n"},
+        {"---\na\n----\n---", "---\na\n----\n---", "a\n----\n"},
+        {"---\na: 1\n", NULL, NULL},
+        {"---", NULL, NULL},
+        {" ---\na\n---\n", NULL, NULL},
+        {"----\na\n---\n", NULL, NULL},
+        {"--- x\na\n---\n", NULL, NULL},
+        {"# Title\n\n---\n", NULL, NULL},
+        {"---\n---\n", NULL, NULL},
+        {"---\r\n---  \r\na\n---\n", NULL, NULL},
+        {"", NULL, NULL},
+    };
+    int failures = 0;
+    uint32_t found = 0;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const char *source = cases[i].source;
+        uint32_t length = (uint32_t)strlen(source);
+        MarkdocFrontmatter frontmatter;
+        bool has = markdoc_frontmatter_find(source, length, &frontmatter);
+        if (has != (cases[i].block != NULL) ||
+            (has && (!same_range(source, frontmatter.start_byte, frontmatter.end_byte,
+                                 cases[i].block) ||
+                     !same_range(source, frontmatter.yaml_start_byte, frontmatter.yaml_end_byte,
+                                 cases[i].yaml)))) {
+            fprintf(stderr, "snippet %zu: frontmatter not found as the scanner would\n", i);
+            failures++;
+            continue;
+        }
+        found += has;
+
+        MarkdocFrontmatterFile file;
+        // Without frontmatter, or with a closing line that only the end of
+        // input ends, the reader has to see the end of input.
+        if (!read_through_pipe(source, length, !has || frontmatter.end_byte == length, &file)) {
+            perror("pipe");
+            failures++;
+            continue;
+        }
+        if (file.found != has || (has && !same_frontmatter(&file.frontmatter, &frontmatter)) ||
+            file.length > length || memcmp(file.data, source, file.length) != 0) {
+            fprintf(stderr, "snippet %zu: read_fd disagrees with find\n", i);
+            failures++;
+        }
+        markdoc_frontmatter_file_delete(&file);
+    }
+
+    // Frontmatter longer than the first read.
+    static const char line[] = "key: value that fills the frontmatter\n";
+    const uint32_t lines = 1000;
+    uint32_t length = 4 + lines * (sizeof(line) - 1) + 4;
+    char *source = malloc(length + 1);
+    memcpy(source, "---\n", 4);
+    for (uint32_t i = 0; i < lines; i++) {
+        memcpy(source + 4 + i * (sizeof(line) - 1), line, sizeof(line) - 1);
+    }
+    memcpy(source + length - 4, "---\n", 4);
+    MarkdocFrontmatterFile file;
+    if (!read_through_pipe(source, length, false, &file)) {
+        perror("pipe");
+        failures++;
+    } else if (!file.found || file.frontmatter.yaml_start_byte != 4 ||
+               file.frontmatter.yaml_end_byte != length - 4 ||
+               file.frontmatter.end_byte != length - 1) {
+        fprintf(stderr, "snippet: long frontmatter not found\n");
+        failures++;
+    }
+    markdoc_frontmatter_file_delete(&file);
+    free(source);
+
+    if (failures == 0) {
+        printf("snippets: ok (%u of %zu with frontmatter)\n", found,
+               sizeof(cases) / sizeof(cases[0]));
+    }
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    int failures = check_snippets();
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+        TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+        TSNode node = ts_node_named_child(ts_tree_root_node(tree), 0);
+        bool has_node =
+            !ts_node_is_null(node) && ts_node_symbol(node) == MARKDOC_SYM_FRONTMATTER;
+
+        MarkdocFrontmatter frontmatter = {0};
+        MarkdocFrontmatterFile file;
+        bool found = markdoc_frontmatter_find(source, length, &frontmatter);
+
+        MarkdocFrontmatter expected = {0};
+        if (has_node) {
+            expected.start_byte = ts_node_start_byte(node);
+            expected.end_byte = ts_node_end_byte(node);
+            TSNode yaml = ts_node_named_child(node, 0);
+            expected.yaml_start_byte = ts_node_start_byte(yaml);
+            expected.yaml_end_byte = ts_node_end_byte(yaml);
+        }
+        if (!markdoc_frontmatter_read_file(argv[i], &file)) {
+            perror(argv[i]);
+            failures++;
+        } else if (found != has_node || file.found != has_node ||
+                   (has_node && (!same_frontmatter(&frontmatter, &expected) ||
+                                 !same_frontmatter(&file.frontmatter, &expected)))) {
+            fprintf(stderr, "%s: frontmatter %u-%u, the tree has %u-%u\n", argv[i],
+                    frontmatter.start_byte, frontmatter.end_byte, expected.start_byte,
+                    expected.end_byte);
+            failures++;
+        } else if (file.length > length || memcmp(file.data, source, file.length) != 0) {
+            fprintf(stderr, "%s: read_file returned other bytes than the file's\n", argv[i]);
+            failures++;
+        } else {
+            printf("%s: ok (%u bytes of YAML, read %u of %u bytes)\n", argv[i],
+                   frontmatter.yaml_end_byte - frontmatter.yaml_start_byte, file.length, length);
+        }
+
+        markdoc_frontmatter_file_delete(&file);
+        ts_tree_delete(tree);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
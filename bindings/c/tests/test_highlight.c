@@ -0,0 +1,434 @@
+// Asserts that the native highlighter satisfies the highlight assertions in
+// test/highlight, the `<!-- ^ capture -->` comments `tree-sitter test`
+// checks `tree-sitter highlight` against, read with the CLI's rules; that it
+// produces the same spans as running the whole highlights query through the
+// query engine with the first pattern matching a node winning; that
+// highlighting a byte range yields the full result's spans in it; and that
+// `#eq?`/`#any-of?` predicates are evaluated while `#match?` is refused.
+//
+//   test-highlight <highlights.scm> <file>...
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/highlight.h"
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+typedef struct {
+    uintptr_t id;
+    uint32_t pattern;
+    MarkdocHighlight span;
+} Capture;
+
+static int compare_captures(const void *a, const void *b) {
+    const Capture *left = a, *right = b;
+    if (left->id != right->id) {
+        return left->id < right->id ? -1 : 1;
+    }
+    return left->pattern < right->pattern ? -1 : left->pattern > right->pattern;
+}
+
+static int compare_spans(const void *a, const void *b) {
+    const MarkdocHighlight *left = a, *right = b;
+    if (left->start_byte != right->start_byte) {
+        return left->start_byte < right->start_byte ? -1 : 1;
+    }
+    if (left->end_byte != right->end_byte) {
+        return left->end_byte > right->end_byte ? -1 : 1;
+    }
+    return left->capture < right->capture ? -1 : left->capture > right->capture;
+}
+
+// Highlights with the query engine alone: every capture of every pattern,
+// keeping the lowest pattern index per node. Returns spans sorted by
+// compare_spans(). queries/highlights.scm has no predicates, so none are
+// evaluated here.
+static MarkdocHighlights query_highlights(const TSQuery *query, TSNode root) {
+    uint32_t count = 0, capacity = 256;
+    Capture *captures = malloc(capacity * sizeof(Capture));
+    TSQueryCursor *cursor = ts_query_cursor_new();
+    ts_query_cursor_exec(cursor, query, root);
+    TSQueryMatch match;
+    uint32_t index;
+    while (ts_query_cursor_next_capture(cursor, &match, &index)) {
+        if (count == capacity) {
+            capacity *= 2;
+            captures = realloc(captures, capacity * sizeof(Capture));
+        }
+        TSNode node = match.captures[index].node;
+        captures[count++] = (Capture){
+            .id = (uintptr_t)node.id,
+            .pattern = match.pattern_index,
+            .span = {ts_node_start_byte(node), ts_node_end_byte(node),
+                     match.captures[index].index},
+        };
+    }
+    ts_query_cursor_delete(cursor);
+    qsort(captures, count, sizeof(Capture), compare_captures);
+
+    MarkdocHighlights highlights = {malloc((count + 1) * sizeof(MarkdocHighlight)), 0};
+    for (uint32_t i = 0; i < count; i++) {
+        if (i == 0 || captures[i].id != captures[i - 1].id) {
+            highlights.spans[highlights.count++] = captures[i].span;
+        }
+    }
+    free(captures);
+    qsort(highlights.spans, highlights.count, sizeof(MarkdocHighlight), compare_spans);
+    return highlights;
+}
+
+static bool is_pre_order(const MarkdocHighlights *highlights) {
+    for (uint32_t i = 1; i < highlights->count; i++) {
+        if (highlights->spans[i].start_byte < highlights->spans[i - 1].start_byte) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool same_spans(const MarkdocHighlights *a, const MarkdocHighlights *b) {
+    return a->count == b->count &&
+           memcmp(a->spans, b->spans, a->count * sizeof(MarkdocHighlight)) == 0;
+}
+
+static bool capture_is(const MarkdocHighlighter *highlighter, uint32_t capture,
+                       const char *name, uint32_t length) {
+    uint32_t capture_length;
+    const char *capture_name =
+        markdoc_highlighter_capture_name(highlighter, capture, &capture_length);
+    return capture_length == length && memcmp(capture_name, name, length) == 0;
+}
+
+typedef struct {
+    TSPoint position;
+    bool negative;
+    const char *name;
+    uint32_t name_length;
+} Assertion;
+
+typedef struct {
+    Assertion *items;
+    uint32_t count;
+    uint32_t capacity;
+} Assertions;
+
+static bool is_capture_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == '-' || c == '.';
+}
+
+// Reads the assertion in a comment node as `tree-sitter test` does: `<-`
+// points at the comment's first column and `^` at its own, `!` negates, and
+// the capture name follows.
+static void read_assertion(TSNode node, const char *source, Assertions *assertions) {
+    TSPoint position = ts_node_start_point(node);
+    const char *text = source + ts_node_start_byte(node);
+    const char *end = source + ts_node_end_byte(node);
+    if (position.row == 0) {
+        return;
+    }
+    bool left_caret = false, arrow = false;
+    while (text < end && !arrow) {
+        char c = *text++;
+        if (c == '-' && left_caret) {
+            arrow = true;
+        } else if (c == '^') {
+            arrow = true;
+            position.column += (uint32_t)(text - 1 - (source + ts_node_start_byte(node)));
+        }
+        left_caret = c == '<';
+    }
+    bool negative = false;
+    while (text < end && (*text == ' ' || *text == '\t' || *text == '!')) {
+        negative = negative || *text == '!';
+        text++;
+    }
+    while (text < end && !is_capture_char(*text)) {
+        text++;
+    }
+    const char *name = text;
+    while (text < end && is_capture_char(*text)) {
+        text++;
+    }
+    if (!arrow || text == name) {
+        return;
+    }
+    if (assertions->count == assertions->capacity) {
+        assertions->capacity = assertions->capacity ? assertions->capacity * 2 : 16;
+        assertions->items =
+            realloc(assertions->items, assertions->capacity * sizeof(Assertion));
+    }
+    assertions->items[assertions->count++] = (Assertion){
+        .position = position,
+        .negative = negative,
+        .name = name,
+        .name_length = (uint32_t)(text - name),
+    };
+}
+
+static void collect_assertions(TSNode node, const char *source, Assertions *assertions) {
+    if (strstr(ts_node_type(node), "comment") != NULL) {
+        read_assertion(node, source, assertions);
+        return;
+    }
+    uint32_t count = ts_node_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        collect_assertions(ts_node_child(node, i), source, assertions);
+    }
+}
+
+// Checks each assertion against the spans containing the position it
+// points at, which is on the line above the comment once lines holding
+// assertions, or too short to reach the column, are skipped. Returns the
+// number of failed assertions.
+static int check_assertions(const MarkdocHighlighter *highlighter, TSNode root,
+                            const char *source, uint32_t length,
+                            const MarkdocHighlights *highlights, const char *path,
+                            uint32_t *checked) {
+    Assertions assertions = {0};
+    collect_assertions(root, source, &assertions);
+    *checked = assertions.count;
+
+    uint32_t line_count = 1;
+    for (uint32_t i = 0; i < length; i++) {
+        line_count += source[i] == '\n';
+    }
+    uint32_t *line_starts = malloc((line_count + 1) * sizeof(uint32_t));
+    line_starts[0] = 0;
+    for (uint32_t i = 0, line = 1; i < length; i++) {
+        if (source[i] == '\n') {
+            line_starts[line++] = i + 1;
+        }
+    }
+    line_starts[line_count] = length;
+
+    int failures = 0;
+    for (uint32_t i = 0; i < assertions.count; i++) {
+        Assertion *assertion = &assertions.items[i];
+        uint32_t row = assertion->position.row;
+        uint32_t column = assertion->position.column;
+        for (;;) {
+            bool on_assertion_line = false;
+            for (uint32_t j = 0; j < assertions.count; j++) {
+                on_assertion_line = on_assertion_line || assertions.items[j].position.row == row;
+            }
+            bool on_short_line = line_starts[row + 1] - line_starts[row] <= column;
+            if (row == 0 || !(on_assertion_line || on_short_line)) {
+                break;
+            }
+            row--;
+        }
+        uint32_t byte = line_starts[row] + column;
+        bool found = false;
+        for (uint32_t j = 0; j < highlights->count && !found; j++) {
+            const MarkdocHighlight *span = &highlights->spans[j];
+            found = span->start_byte <= byte && byte < span->end_byte &&
+                    capture_is(highlighter, span->capture, assertion->name,
+                               assertion->name_length);
+        }
+        if (found == assertion->negative) {
+            fprintf(stderr, "%s:%u:%u: expected %s%.*s\n", path, row + 1, column + 1,
+                    assertion->negative ? "no " : "", (int)assertion->name_length,
+                    assertion->name);
+            failures++;
+        }
+    }
+    free(line_starts);
+    free(assertions.items);
+    return failures;
+}
+
+static int check_predicates(const TSLanguage *language, TSParser *parser) {
+    static const char query[] =
+        "((tag_name) @tag.builtin (#any-of? @tag.builtin \"partial\" \"slot\"))\n"
+        "((tag_name) @tag.other (#not-eq? @tag.other \"image\"))\n"
+        "(tag_name) @tag\n";
+    static const char refused[] = "((tag_name) @tag (#match? @tag \"^p\"))\n";
+    static const char source[] = "{% partial /%}\n\n{% image /%}\n\n{% note /%}\n";
+    static const char *const expected[][2] = {
+        {"partial", "tag.builtin"},
+        {"image", "tag"},
+        {"note", "tag.other"},
+    };
+
+    uint32_t error_offset;
+    TSQueryError error_type;
+    MarkdocHighlighter *highlighter = markdoc_highlighter_new(
+        language, refused, sizeof(refused) - 1, &error_offset, &error_type);
+    if (highlighter != NULL || error_type != TSQueryErrorSyntax) {
+        fprintf(stderr, "predicates: a #match? pattern was not refused\n");
+        markdoc_highlighter_delete(highlighter);
+        return 1;
+    }
+    highlighter = markdoc_highlighter_new(language, query, sizeof(query) - 1, &error_offset,
+                                          &error_type);
+    if (highlighter == NULL) {
+        fprintf(stderr, "predicates: query error %d at byte %u\n", (int)error_type,
+                error_offset);
+        return 1;
+    }
+
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source, sizeof(source) - 1);
+    MarkdocHighlights highlights;
+    int failures = 0;
+    if (!markdoc_highlight(highlighter, ts_tree_root_node(tree), source, 0, UINT32_MAX,
+                           &highlights)) {
+        fprintf(stderr, "predicates: out of memory\n");
+        failures++;
+        highlights = (MarkdocHighlights){0};
+    }
+    uint32_t matched = 0;
+    for (uint32_t i = 0; i < highlights.count; i++) {
+        const MarkdocHighlight *span = &highlights.spans[i];
+        for (size_t j = 0; j < sizeof(expected) / sizeof(expected[0]); j++) {
+            uint32_t name_length = (uint32_t)strlen(expected[j][0]);
+            if (span->end_byte - span->start_byte != name_length ||
+                memcmp(source + span->start_byte, expected[j][0], name_length) != 0) {
+                continue;
+            }
+            if (!capture_is(highlighter, span->capture, expected[j][1],
+                            (uint32_t)strlen(expected[j][1]))) {
+                fprintf(stderr, "predicates: %s is not highlighted as @%s\n", expected[j][0],
+                        expected[j][1]);
+                failures++;
+            }
+            matched++;
+        }
+    }
+    if (failures == 0 && matched != sizeof(expected) / sizeof(expected[0])) {
+        fprintf(stderr, "predicates: %u of the tag names highlighted\n", matched);
+        failures++;
+    }
+    if (failures == 0) {
+        printf("predicates: ok (%u tag names)\n", matched);
+    }
+    markdoc_highlights_delete(&highlights);
+    ts_tree_delete(tree);
+    markdoc_highlighter_delete(highlighter);
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <highlights.scm> <file>...\n", argv[0]);
+        return 2;
+    }
+    uint32_t query_length = 0;
+    char *query_source = read_file(argv[1], &query_length);
+    if (query_source == NULL) {
+        fprintf(stderr, "%s: cannot read\n", argv[1]);
+        return 1;
+    }
+
+    const TSLanguage *language = tree_sitter_markdoc();
+    uint32_t error_offset;
+    TSQueryError error_type;
+    TSQuery *query = ts_query_new(language, query_source, query_length, &error_offset,
+                                  &error_type);
+    MarkdocHighlighter *highlighter =
+        markdoc_highlighter_new(language, query_source, query_length, &error_offset, &error_type);
+    if (query == NULL || highlighter == NULL) {
+        fprintf(stderr, "%s: query error %d at byte %u\n", argv[1], (int)error_type,
+                error_offset);
+        return 1;
+    }
+    printf("%s: %u of %u patterns native\n", argv[1],
+           markdoc_highlighter_native_pattern_count(highlighter), ts_query_pattern_count(query));
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, language);
+
+    int failures = check_predicates(language, parser);
+    for (int i = 2; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+        TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+        TSNode root = ts_tree_root_node(tree);
+
+        double start = now_us();
+        MarkdocHighlights expected = query_highlights(query, root);
+        double query_us = now_us() - start;
+
+        MarkdocHighlights native, ranged;
+        start = now_us();
+        bool ok = markdoc_highlight(highlighter, root, source, 0, UINT32_MAX, &native);
+        double native_us = now_us() - start;
+
+        // The middle third of the document, as an editor would highlight
+        // the visible lines.
+        uint32_t range_start = length / 3, range_end = length - length / 3;
+        ok = markdoc_highlight(highlighter, root, source, range_start, range_end, &ranged) &&
+             ok;
+
+        bool ordered = is_pre_order(&native) && is_pre_order(&ranged);
+        qsort(native.spans, native.count, sizeof(MarkdocHighlight), compare_spans);
+        qsort(ranged.spans, ranged.count, sizeof(MarkdocHighlight), compare_spans);
+        MarkdocHighlights in_range = {malloc((native.count + 1) * sizeof(MarkdocHighlight)), 0};
+        for (uint32_t j = 0; j < native.count; j++) {
+            if (native.spans[j].end_byte > range_start && native.spans[j].start_byte < range_end) {
+                in_range.spans[in_range.count++] = native.spans[j];
+            }
+        }
+
+        uint32_t assertion_count = 0;
+        int failed_assertions = ok ? check_assertions(highlighter, root, source, length, &native,
+                                                      argv[i], &assertion_count)
+                                   : 0;
+
+        if (!ok || !ordered) {
+            fprintf(stderr, "%s: highlighting failed or spans out of order\n", argv[i]);
+            failures++;
+        } else if (failed_assertions > 0) {
+            failures += failed_assertions;
+        } else if (!same_spans(&native, &expected)) {
+            fprintf(stderr, "%s: %u native spans, %u from the query\n", argv[i], native.count,
+                    expected.count);
+            for (uint32_t j = 0; j < native.count && j < expected.count; j++) {
+                if (compare_spans(&native.spans[j], &expected.spans[j]) != 0) {
+                    fprintf(stderr,
+                            "  first difference: [%u, %u) capture %u vs [%u, %u) capture %u\n",
+                            native.spans[j].start_byte, native.spans[j].end_byte,
+                            native.spans[j].capture, expected.spans[j].start_byte,
+                            expected.spans[j].end_byte, expected.spans[j].capture);
+                    break;
+                }
+            }
+            failures++;
+        } else if (!same_spans(&ranged, &in_range)) {
+            fprintf(stderr, "%s: %u spans in [%u, %u), expected %u\n", argv[i], ranged.count,
+                    range_start, range_end, in_range.count);
+            failures++;
+        } else {
+            printf("%s: ok (%u spans, %u assertions, native %.0f us, query %.0f us)\n", argv[i],
+                   native.count, assertion_count, native_us, query_us);
+        }
+
+        markdoc_highlights_delete(&expected);
+        markdoc_highlights_delete(&native);
+        markdoc_highlights_delete(&ranged);
+        markdoc_highlights_delete(&in_range);
+        ts_tree_delete(tree);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    markdoc_highlighter_delete(highlighter);
+    ts_query_delete(query);
+    free(query_source);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+// Asserts that markdoc_render_html() renders markdown the way markdown-it
+// does, that tag handlers see each tag once entering and once leaving, with
+// its attributes, and that a failing writer stops the renderer.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/html.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+typedef struct {
+    uint32_t entered;
+    uint32_t left;
+} Counts;
+
+// Renders `callout` as a div, and counts every tag.
+static bool render_callout(void *payload, MarkdocHtmlRenderer *html, const MarkdocHtmlTag *tag,
+                           bool entering) {
+    Counts *counts = payload;
+    if (!entering) {
+        counts->left++;
+        markdoc_html_write(html, "</div>\n", 7);
+        return true;
+    }
+    counts->entered++;
+    const char *type;
+    uint32_t length;
+    markdoc_html_write(html, "<div class=\"callout", 19);
+    if (markdoc_html_tag_attribute(tag, "type", &type, &length)) {
+        markdoc_html_write(html, " ", 1);
+        markdoc_html_write_escaped(html, type, length);
+    }
+    markdoc_html_write(html, "\">\n", 3);
+    return true;
+}
+
+static bool count_tag(void *payload, MarkdocHtmlRenderer *html, const MarkdocHtmlTag *tag,
+                      bool entering) {
+    (void)html;
+    (void)tag;
+    Counts *counts = payload;
+    if (entering) {
+        counts->entered++;
+    } else {
+        counts->left++;
+    }
+    return true;
+}
+
+static void render_expression(void *payload, MarkdocHtmlRenderer *html, TSNode node) {
+    (void)payload;
+    (void)node;
+    markdoc_html_write(html, "Ada", 3);
+}
+
+// Counts the tags a handler for every name would see, outside fences' code.
+static uint32_t count_tags(TSNode node) {
+    TSSymbol symbol = ts_node_symbol(node);
+    if (symbol == MARKDOC_SYM_FENCED_CODE_BLOCK || symbol == MARKDOC_SYM_ERROR ||
+        symbol == MARKDOC_SYM_HTML_BLOCK) {
+        return 0;
+    }
+    uint32_t tags = symbol == MARKDOC_SYM_TAG_OPEN || symbol == MARKDOC_SYM_TAG_SELF_CLOSE;
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        tags += count_tags(ts_node_named_child(node, i));
+    }
+    return tags;
+}
+
+static bool failing_write(void *payload, const char *data, size_t length) {
+    (void)data;
+    size_t *budget = payload;
+    if (length > *budget) {
+        return false;
+    }
+    *budget -= length;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+    int failures = 0;
+
+    static const char snippet[] = "---\ntitle: Hi\n---\n\n# Hi *there* and `` a ` b ``\n\n"
+                                  "Some *em `c`* and **strong [s](/s)** with ` a < b `  \n"
+                                  "and [a *link*](/x \"T\").\n\n"
+                                  "- one\n- two\n\n"
+                                  "> Quoted a < b\n> more\n>\n> second\n\n"
+                                  "1. a\n\n2. b\n\n"
+                                  "{% callout type=\"note\" %}\n"
+                                  "Hello {% $user.name %}\n"
+                                  "{% /callout %}\n\n"
+                                  "```js\nx < 1\n```\n";
+    static const char *const expected[] = {
+        "<h1>Hi <em>there</em> and <code>a ` b</code></h1>\n",
+        "<em>em <code>c</code></em>",
+        "<strong>strong <a href=\"/s\">s</a></strong>",
+        "<code>a &lt; b</code><br>\nand <a href=\"/x\" title=\"T\">a <em>link</em></a>.</p>\n",
+        "<ul>\n<li>one</li>\n<li>two</li>\n</ul>\n",
+        "<blockquote>\n<p>Quoted a &lt; b\nmore</p>\n<p>second</p>\n</blockquote>\n",
+        "<ol>\n<li>\n<p>a</p>\n</li>\n<li>\n<p>b</p>\n</li>\n</ol>\n",
+        "<div class=\"callout note\">\n<p>Hello Ada</p>\n</div>\n",
+        "<pre><code class=\"language-js\">x &lt; 1\n</code></pre>\n",
+    };
+    Counts callouts = {0};
+    MarkdocHtmlTagHandler callout = {
+        .name = "callout", .render = render_callout, .payload = &callouts};
+    MarkdocHtmlOptions options = {
+        .tags = &callout, .tag_count = 1, .expression = render_expression};
+    TSTree *tree = ts_parser_parse_string(parser, NULL, snippet, sizeof(snippet) - 1);
+    MarkdocBuffer buffer = {0};
+    if (!markdoc_render_html(ts_tree_root_node(tree), snippet, &options,
+                             markdoc_buffer_writer(&buffer))) {
+        fprintf(stderr, "snippet: rendering failed\n");
+        failures++;
+    } else {
+        for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+            if (strstr(buffer.data, expected[i]) == NULL) {
+                fprintf(stderr, "snippet: %s not in %s\n", expected[i], buffer.data);
+                failures++;
+            }
+        }
+        if (strstr(buffer.data, "title: Hi") != NULL || callouts.entered != 1 ||
+            callouts.left != 1) {
+            fprintf(stderr, "snippet: frontmatter rendered or callout not handled once\n");
+            failures++;
+        }
+    }
+    if (failures == 0) {
+        printf("snippet: ok (%zu bytes)\n", buffer.length);
+    }
+    markdoc_buffer_delete(&buffer);
+    ts_tree_delete(tree);
+
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+        tree = ts_parser_parse_string(parser, NULL, source, length);
+        TSNode root = ts_tree_root_node(tree);
+
+        // One handler per tag name in the document would do; a handler list
+        // is searched by name, so register the names the tree uses.
+        MarkdocHtmlTagHandler handlers[64];
+        uint32_t handler_count = 0;
+        Counts counts = {0};
+        for (uint32_t at = 0; at + 2 < length && handler_count < 64; at++) {
+            if (source[at] != '{' || source[at + 1] != '%') {
+                continue;
+            }
+            uint32_t start = at + 2;
+            while (start < length && (source[start] == ' ' || source[start] == '/')) {
+                start++;
+            }
+            uint32_t end = start;
+            while (end < length && (source[end] == '-' || source[end] == '_' ||
+                                    (source[end] >= 'a' && source[end] <= 'z') ||
+                                    (source[end] >= 'A' && source[end] <= 'Z') ||
+                                    (source[end] >= '0' && source[end] <= '9'))) {
+                end++;
+            }
+            bool known = end == start;
+            for (uint32_t h = 0; h < handler_count && !known; h++) {
+                known = strlen(handlers[h].name) == end - start &&
+                        memcmp(handlers[h].name, source + start, end - start) == 0;
+            }
+            if (!known) {
+                char *name = malloc(end - start + 1);
+                memcpy(name, source + start, end - start);
+                name[end - start] = '\0';
+                handlers[handler_count++] = (MarkdocHtmlTagHandler){
+                    .name = name, .render = count_tag, .payload = &counts};
+            }
+        }
+        MarkdocHtmlOptions counting = {.tags = handlers, .tag_count = handler_count};
+
+        buffer = (MarkdocBuffer){0};
+        bool ok = markdoc_render_html(root, source, &counting, markdoc_buffer_writer(&buffer));
+        uint32_t tags = count_tags(root);
+
+        size_t budget = buffer.length / 2;
+        MarkdocWriter failing = {.write = failing_write, .payload = &budget};
+        bool stopped = !markdoc_render_html(root, source, NULL, failing);
+
+        if (!ok || buffer.length == 0) {
+            fprintf(stderr, "%s: rendering failed\n", argv[i]);
+            failures++;
+        } else if (counts.entered != tags || counts.left != tags) {
+            fprintf(stderr, "%s: handlers entered %u and left %u tags, tree has %u\n", argv[i],
+                    counts.entered, counts.left, tags);
+            failures++;
+        } else if (!stopped) {
+            fprintf(stderr, "%s: a failing writer did not stop the renderer\n", argv[i]);
+            failures++;
+        } else {
+            printf("%s: ok (%zu bytes of HTML, %u tags)\n", argv[i], buffer.length, tags);
+        }
+
+        for (uint32_t h = 0; h < handler_count; h++) {
+            free((char *)handlers[h].name);
+        }
+        markdoc_buffer_delete(&buffer);
+        ts_tree_delete(tree);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,295 @@
+// Asserts that markdoc_link_index_build() finds links, images and link-like
+// tag attributes with their destinations deduplicated, including links in
+// headings, emphasis and blockquotes, that it finds every link and image a
+// full walk of the tree finds, that after an edit and an incremental
+// reparse markdoc_link_index_update() gives the same links as a fresh
+// build, and that an update drops destinations that are mostly unused.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/links.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+// Counts the links and images outside code and raw HTML: the nodes, and
+// each `](` in the tokens whose inline markup has no nodes.
+static uint32_t count_links(TSNode node, const char *source) {
+    uint32_t links = 0;
+    switch (ts_node_symbol(node)) {
+        case MARKDOC_SYM_FENCED_CODE_BLOCK:
+        case MARKDOC_SYM_HTML_BLOCK:
+            return 0;
+        case MARKDOC_SYM_LINK:
+        case MARKDOC_SYM_IMAGE:
+            return 1;
+        case MARKDOC_SYM_HEADING_TEXT:
+        case MARKDOC_SYM_EMPHASIS:
+        case MARKDOC_SYM_STRONG:
+        case MARKDOC_SYM_BLOCKQUOTE:
+            for (uint32_t i = ts_node_start_byte(node); i + 1 < ts_node_end_byte(node); i++) {
+                links += source[i] == ']' && source[i + 1] == '(';
+            }
+            return links;
+        default:
+            break;
+    }
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        links += count_links(ts_node_named_child(node, i), source);
+    }
+    return links;
+}
+
+// Compares the links of two indices, destinations by their text.
+static bool same_links(const MarkdocLinkIndex *a, const MarkdocLinkIndex *b) {
+    if (a->count != b->count) {
+        return false;
+    }
+    for (uint32_t i = 0; i < a->count; i++) {
+        const MarkdocLink *x = &a->links[i], *y = &b->links[i];
+        if (x->kind != y->kind || x->start_byte != y->start_byte || x->end_byte != y->end_byte ||
+            x->text_start != y->text_start || x->text_end != y->text_end ||
+            x->destination_start != y->destination_start ||
+            x->destination_end != y->destination_end ||
+            strcmp(a->destinations + a->destination_offsets[x->destination],
+                   b->destinations + b->destination_offsets[y->destination]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int check_snippet(TSParser *parser) {
+    static const char source[] =
+        "# Read [the guide](/docs/guide)\n\n"
+        "See [the guide](/docs/guide \"Guide\") and ![logo](/logo.png), *or [em](/em)*.\n\n"
+        "> Quoted [q](/q)\n\n"
+        "{% card href=\"/docs/guide\" imageSrc=\"/logo.png\" title=\"x\" /%}\n\n"
+        "Again [here](</docs/guide>).\n";
+    static const struct {
+        MarkdocLinkKind kind;
+        const char *text;
+        const char *destination;
+        uint32_t id;
+    } expected[] = {
+        {MARKDOC_LINK, "the guide", "/docs/guide", 0},
+        {MARKDOC_LINK, "the guide", "/docs/guide", 0},
+        {MARKDOC_LINK_IMAGE, "logo", "/logo.png", 1},
+        {MARKDOC_LINK, "em", "/em", 2},
+        {MARKDOC_LINK, "q", "/q", 3},
+        {MARKDOC_LINK_ATTRIBUTE, "href", "/docs/guide", 0},
+        {MARKDOC_LINK_ATTRIBUTE, "imageSrc", "/logo.png", 1},
+        {MARKDOC_LINK, "here", "/docs/guide", 0},
+    };
+    const uint32_t expected_count = sizeof(expected) / sizeof(expected[0]);
+
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source, sizeof(source) - 1);
+    MarkdocLinkIndex index;
+    int failures = 0;
+    if (!markdoc_link_index_build(ts_tree_root_node(tree), source, &index)) {
+        fprintf(stderr, "snippet: out of memory\n");
+        failures++;
+    } else if (index.count != expected_count || index.destination_count != 4) {
+        fprintf(stderr, "snippet: %u links to %u destinations, expected %u to 4\n", index.count,
+                index.destination_count, expected_count);
+        failures++;
+    } else {
+        for (uint32_t i = 0; i < expected_count; i++) {
+            const MarkdocLink *link = &index.links[i];
+            uint32_t text_length = link->text_end - link->text_start;
+            uint32_t length = link->destination_end - link->destination_start;
+            if (link->kind != expected[i].kind || link->destination != expected[i].id ||
+                text_length != strlen(expected[i].text) ||
+                memcmp(source + link->text_start, expected[i].text, text_length) != 0 ||
+                length != strlen(expected[i].destination) ||
+                memcmp(source + link->destination_start, expected[i].destination, length) != 0) {
+                fprintf(stderr,
+                        "snippet: link %u is \"%.*s\" to \"%.*s\", expected \"%s\" to \"%s\"\n",
+                        i, (int)text_length, source + link->text_start, (int)length,
+                        source + link->destination_start, expected[i].text,
+                        expected[i].destination);
+                failures++;
+            }
+        }
+        if (markdoc_link_index_find(&index, "/logo.png", 9) != 1 ||
+            markdoc_link_index_find(&index, "/missing", 8) != MARKDOC_LINK_NO_DESTINATION) {
+            fprintf(stderr, "snippet: destinations are not interned\n");
+            failures++;
+        }
+    }
+    if (failures == 0) {
+        printf("snippet: ok (%u links, %u destinations)\n", index.count, index.destination_count);
+    }
+    markdoc_link_index_delete(&index);
+    ts_tree_delete(tree);
+    return failures;
+}
+
+static TSPoint point_at(const char *source, uint32_t byte) {
+    TSPoint point = {0, 0};
+    for (uint32_t i = 0; i < byte; i++) {
+        if (source[i] == '\n') {
+            point.row++;
+            point.column = 0;
+        } else {
+            point.column++;
+        }
+    }
+    return point;
+}
+
+// Inserts `text` at `at`, reparses incrementally and updates `index`.
+// Returns the new source, or NULL if the update disagrees with a build.
+static char *edit_and_update(TSParser *parser, TSTree **tree, char *source, uint32_t *length,
+                             uint32_t at, const char *text, MarkdocLinkIndex *index) {
+    uint32_t inserted = (uint32_t)strlen(text);
+    char *edited = malloc(*length + inserted + 1);
+    memcpy(edited, source, at);
+    memcpy(edited + at, text, inserted);
+    memcpy(edited + at + inserted, source + at, *length - at + 1);
+
+    TSInputEdit edit = {
+        .start_byte = at,
+        .old_end_byte = at,
+        .new_end_byte = at + inserted,
+        .start_point = point_at(source, at),
+        .old_end_point = point_at(source, at),
+        .new_end_point = point_at(edited, at + inserted),
+    };
+    ts_tree_edit(*tree, &edit);
+    markdoc_link_index_edit(index, &edit);
+    TSTree *new_tree = ts_parser_parse_string(parser, *tree, edited, *length + inserted);
+    uint32_t changed_count = 0;
+    TSRange *changed = ts_tree_get_changed_ranges(*tree, new_tree, &changed_count);
+    bool ok = markdoc_link_index_update(index, ts_tree_root_node(new_tree), edited, changed,
+                                        changed_count);
+    free(changed);
+    ts_tree_delete(*tree);
+    *tree = new_tree;
+    free(source);
+    *length += inserted;
+
+    MarkdocLinkIndex fresh = {0};
+    ok = ok && markdoc_link_index_build(ts_tree_root_node(new_tree), edited, &fresh);
+    ok = ok && same_links(index, &fresh);
+    markdoc_link_index_delete(&fresh);
+    if (!ok) {
+        free(edited);
+        return NULL;
+    }
+    return edited;
+}
+
+// Updates an index of four destinations with a document that links to only
+// one of them, which drops the other three.
+static int check_compaction(TSParser *parser) {
+    static const char before[] = "[a](/a)\n\n[b](/b)\n\n[c](/c)\n\n[d](/d)\n";
+    static const char after[] = "[d](/d) and [d again](/d)\n";
+    TSTree *tree = ts_parser_parse_string(parser, NULL, before, sizeof(before) - 1);
+    MarkdocLinkIndex index;
+    int failures = 0;
+    if (!markdoc_link_index_build(ts_tree_root_node(tree), before, &index)) {
+        fprintf(stderr, "compaction: out of memory\n");
+        ts_tree_delete(tree);
+        return 1;
+    }
+    ts_tree_delete(tree);
+
+    tree = ts_parser_parse_string(parser, NULL, after, sizeof(after) - 1);
+    TSRange everything = {.start_byte = 0, .end_byte = sizeof(after) - 1,
+                          .end_point = {1, 0}};
+    if (!markdoc_link_index_update(&index, ts_tree_root_node(tree), after, &everything, 1)) {
+        fprintf(stderr, "compaction: out of memory\n");
+        failures++;
+    } else if (!index.renumbered || index.destination_count != 1 || index.count != 2 ||
+               index.links[0].destination != 0 || index.links[1].destination != 0 ||
+               strcmp(index.destinations + index.destination_offsets[0], "/d") != 0 ||
+               markdoc_link_index_find(&index, "/d", 2) != 0 ||
+               markdoc_link_index_find(&index, "/a", 2) != MARKDOC_LINK_NO_DESTINATION) {
+        fprintf(stderr, "compaction: %u destinations left, expected only /d\n",
+                index.destination_count);
+        failures++;
+    } else {
+        printf("compaction: ok (4 destinations down to 1)\n");
+    }
+    markdoc_link_index_delete(&index);
+    ts_tree_delete(tree);
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+    int failures = check_snippet(parser);
+    failures += check_compaction(parser);
+
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+        TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+
+        MarkdocLinkIndex index;
+        if (!markdoc_link_index_build(ts_tree_root_node(tree), source, &index)) {
+            fprintf(stderr, "%s: out of memory\n", argv[i]);
+            failures++;
+            ts_tree_delete(tree);
+            free(source);
+            continue;
+        }
+        uint32_t expected = count_links(ts_tree_root_node(tree), source);
+        uint32_t found = 0;
+        for (uint32_t j = 0; j < index.count; j++) {
+            found += index.links[j].kind != MARKDOC_LINK_ATTRIBUTE;
+        }
+        bool matches = found == expected;
+        if (!matches) {
+            fprintf(stderr, "%s: indexed %u links and images, the tree has %u\n", argv[i], found,
+                    expected);
+            failures++;
+        }
+
+        // Add a link in the middle of the document, then text at the start.
+        uint32_t changed_links = 0;
+        uint32_t middle = length / 2;
+        while (middle < length && source[middle - 1] != '\n') {
+            middle++;
+        }
+        source = edit_and_update(parser, &tree, source, &length, middle,
+                                 "A [new link](/new).\n\n", &index);
+        bool updated = source != NULL;
+        for (uint32_t j = 0; updated && j < index.count; j++) {
+            changed_links += index.links[j].changed;
+        }
+        if (updated) {
+            source = edit_and_update(parser, &tree, source, &length, 0, "Intro\n\n", &index);
+            updated = source != NULL;
+        }
+
+        if (!updated) {
+            fprintf(stderr, "%s: the updated index differs from a fresh build\n", argv[i]);
+            failures++;
+        } else if (matches) {
+            printf("%s: ok (%u links to %u destinations, %u read again after an edit)\n", argv[i],
+                   index.count, index.destination_count, changed_links);
+        }
+
+        markdoc_link_index_delete(&index);
+        ts_tree_delete(tree);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+// Asserts that src/parser.c's parse table has at most the given number of
+// (state, token) cells with more than one action. Those cells are where the
+// GLR parser forks its stack, so 0 means the grammar never forks outside
+// error recovery. The check reads only the generated tables, so it runs
+// without the tree-sitter runtime.
+//
+//   test-no-forks <max-conflicting-cells>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tree_sitter/parser.h"
+
+const TSLanguage *tree_sitter_markdoc(void);
+
+static bool forks(const TSLanguage *language, uint16_t action_index, uint16_t symbol) {
+    return symbol < language->token_count && action_index != 0 &&
+           language->parse_actions[action_index].entry.count > 1;
+}
+
+// The conflicting token cells of `state`, from the full table for the first
+// large_state_count states and from the compressed one after that.
+static uint32_t conflicting_cells(const TSLanguage *language, uint32_t state) {
+    uint32_t cells = 0;
+    if (state < language->large_state_count) {
+        for (uint16_t symbol = 0; symbol < language->symbol_count; symbol++) {
+            cells += forks(language, language->parse_table[state * language->symbol_count + symbol],
+                           symbol);
+        }
+        return cells;
+    }
+
+    uint32_t offset = language->small_parse_table_map[state - language->large_state_count];
+    const uint16_t *data = &language->small_parse_table[offset];
+    uint16_t group_count = *data++;
+    for (uint16_t group = 0; group < group_count; group++) {
+        uint16_t action_index = *data++;
+        uint16_t symbol_count = *data++;
+        for (uint16_t i = 0; i < symbol_count; i++) {
+            cells += forks(language, action_index, *data++);
+        }
+    }
+    return cells;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <max-conflicting-cells>\n", argv[0]);
+        return 2;
+    }
+    uint32_t allowed = (uint32_t)strtoul(argv[1], NULL, 10);
+
+    const TSLanguage *language = tree_sitter_markdoc();
+    uint32_t cells = 0, states = 0;
+    for (uint32_t state = 0; state < language->state_count; state++) {
+        uint32_t here = conflicting_cells(language, state);
+        cells += here;
+        states += here > 0;
+    }
+
+    if (cells > allowed) {
+        fprintf(stderr, "no-forks: %u conflicting cells in %u of %u states, at most %u allowed\n",
+                cells, states, language->state_count, allowed);
+        return 1;
+    }
+    printf("no-forks: ok (%u conflicting cells in %u of %u states)\n", cells, states,
+           language->state_count);
+    return 0;
+}
@@ -0,0 +1,160 @@
+// Asserts that markdoc_outline() finds every heading a full walk of the tree
+// finds, along with the top-level tags, and that slugs are made and
+// deduplicated the way github-slugger does it.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/outline.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+// Counts the headings in the whole tree, outside error nodes.
+static uint32_t count_headings(TSNode node) {
+    TSSymbol symbol = ts_node_symbol(node);
+    if (symbol == MARKDOC_SYM_HEADING) {
+        return 1;
+    }
+    if (symbol == MARKDOC_SYM_ERROR) {
+        return 0;
+    }
+    uint32_t headings = 0;
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        headings += count_headings(ts_node_named_child(node, i));
+    }
+    return headings;
+}
+
+static int check_snippet(TSParser *parser) {
+    static const char source[] = "# Getting Started\n\n"
+                                 "## Install & Run!\n\n"
+                                 "{% callout type=\"note\" %}\n"
+                                 "## Nested ##\n"
+                                 "{% /callout %}\n\n"
+                                 "```md\n# Not a heading\n```\n\n"
+                                 "## Install & Run\n\n"
+                                 "### A\n\n### A-1\n\n### A\n";
+    static const struct {
+        MarkdocOutlineKind kind;
+        uint8_t level;
+        const char *text;
+        const char *slug;
+    } expected[] = {
+        {MARKDOC_OUTLINE_HEADING, 1, "Getting Started", "getting-started"},
+        {MARKDOC_OUTLINE_HEADING, 2, "Install & Run!", "install--run"},
+        {MARKDOC_OUTLINE_TAG, 0, "callout", ""},
+        {MARKDOC_OUTLINE_HEADING, 2, "Nested", "nested"},
+        {MARKDOC_OUTLINE_HEADING, 2, "Install & Run", "install--run-1"},
+        {MARKDOC_OUTLINE_HEADING, 3, "A", "a"},
+        {MARKDOC_OUTLINE_HEADING, 3, "A-1", "a-1"},
+        {MARKDOC_OUTLINE_HEADING, 3, "A", "a-2"},
+    };
+    const uint32_t expected_count = sizeof(expected) / sizeof(expected[0]);
+
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source, sizeof(source) - 1);
+    MarkdocOutline outline;
+    int failures = 0;
+    if (!markdoc_outline(ts_tree_root_node(tree), source, &outline)) {
+        fprintf(stderr, "snippet: out of memory\n");
+        failures++;
+    } else if (outline.count != expected_count) {
+        fprintf(stderr, "snippet: %u entries, expected %u\n", outline.count, expected_count);
+        failures++;
+    } else {
+        for (uint32_t i = 0; i < expected_count; i++) {
+            const MarkdocOutlineEntry *entry = &outline.entries[i];
+            const char *slug = outline.slugs + entry->slug_offset;
+            uint32_t length = entry->end_byte - entry->start_byte;
+            if (entry->kind != expected[i].kind || entry->level != expected[i].level ||
+                length != strlen(expected[i].text) ||
+                memcmp(source + entry->start_byte, expected[i].text, length) != 0 ||
+                entry->slug_length != strlen(expected[i].slug) ||
+                memcmp(slug, expected[i].slug, entry->slug_length) != 0) {
+                fprintf(stderr, "snippet: entry %u is %d/%u \"%.*s\" #%.*s, expected \"%s\" #%s\n",
+                        i, (int)entry->kind, entry->level, (int)length,
+                        source + entry->start_byte, (int)entry->slug_length, slug,
+                        expected[i].text, expected[i].slug);
+                failures++;
+            }
+        }
+    }
+    if (failures == 0) {
+        printf("snippet: ok (%u entries)\n", outline.count);
+    }
+    markdoc_outline_delete(&outline);
+    ts_tree_delete(tree);
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+    int failures = check_snippet(parser);
+
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+        TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+        TSNode root = ts_tree_root_node(tree);
+
+        uint32_t top_level_tags = 0;
+        for (uint32_t j = 0; j < ts_node_named_child_count(root); j++) {
+            top_level_tags += ts_node_symbol(ts_node_named_child(root, j)) ==
+                              MARKDOC_SYM_MARKDOC_TAG;
+        }
+
+        MarkdocOutline outline;
+        if (!markdoc_outline(root, source, &outline)) {
+            fprintf(stderr, "%s: out of memory\n", argv[i]);
+            failures++;
+        } else {
+            uint32_t headings = 0, tags = 0;
+            bool unique = true;
+            for (uint32_t j = 0; j < outline.count; j++) {
+                const MarkdocOutlineEntry *entry = &outline.entries[j];
+                if (entry->kind == MARKDOC_OUTLINE_TAG) {
+                    tags++;
+                    continue;
+                }
+                headings++;
+                for (uint32_t k = 0; k < j; k++) {
+                    const MarkdocOutlineEntry *other = &outline.entries[k];
+                    if (other->kind == MARKDOC_OUTLINE_HEADING &&
+                        strcmp(outline.slugs + other->slug_offset,
+                               outline.slugs + entry->slug_offset) == 0) {
+                        unique = false;
+                    }
+                }
+            }
+            if (headings != count_headings(root) || tags != top_level_tags) {
+                fprintf(stderr, "%s: %u headings and %u tags, tree has %u and %u\n", argv[i],
+                        headings, tags, count_headings(root), top_level_tags);
+                failures++;
+            } else if (!unique) {
+                fprintf(stderr, "%s: two headings share a slug\n", argv[i]);
+                failures++;
+            } else {
+                printf("%s: ok (%u headings, %u tags)\n", argv[i], headings, tags);
+            }
+        }
+
+        markdoc_outline_delete(&outline);
+        ts_tree_delete(tree);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+// Asserts that markdoc_split_chunks() does not split a list item that
+// continues across a blank line or a tag body, and that parsing each file,
+// and a tag-heavy document cut at every blank line it allows, in small
+// chunks on several threads yields the same top-level blocks, with the same
+// absolute byte ranges, as parsing it in one piece.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/chunked.h"
+
+static bool same_block(TSNode a, TSNode b) {
+    return strcmp(ts_node_type(a), ts_node_type(b)) == 0 &&
+           ts_node_start_byte(a) == ts_node_start_byte(b) &&
+           ts_node_end_byte(a) == ts_node_end_byte(b) &&
+           ts_node_start_point(a).row == ts_node_start_point(b).row;
+}
+
+// Asserts that markdoc_split_chunks() with a 1-byte target cuts `text`
+// exactly before each of `starts`.
+static int check_split(const char *name, const char *text, const char *const *starts,
+                       uint32_t expected) {
+    uint32_t count = 0;
+    TSRange *ranges = markdoc_split_chunks(text, (uint32_t)strlen(text), 1, &count);
+    int failures = 0;
+    if (ranges == NULL || count != expected) {
+        fprintf(stderr, "%s: %u chunks, expected %u\n", name, count, expected);
+        failures++;
+    } else {
+        for (uint32_t i = 0; i < count; i++) {
+            if (ranges[i].start_byte != (uint32_t)(starts[i] - text)) {
+                fprintf(stderr, "%s: chunk %u starts at %u, expected %u\n", name, i,
+                        ranges[i].start_byte, (uint32_t)(starts[i] - text));
+                failures++;
+            }
+        }
+    }
+    if (failures == 0) {
+        printf("%s: ok (%u chunks)\n", name, count);
+    }
+    free(ranges);
+    return failures;
+}
+
+static int check_list_split(void) {
+    static const char text[] = "- item\n\n  continued\n\n- next\n\n> quote\n\nText\n";
+    const char *const starts[] = {text, strstr(text, "- next"), strstr(text, "> quote"),
+                                  strstr(text, "Text")};
+    return check_split("split", text, starts, sizeof(starts) / sizeof(starts[0]));
+}
+
+// Lines that are `{% %}` but open nothing, such as `{% $var %}` and
+// `{% /note /%}`, must not change the tag depth.
+static int check_tag_split(void) {
+    static const char text[] = "{% note %}\n\nA\n\n{% /note %}\n\n"
+                               "{% $var %}\n\n{% /note /%}\n\nB\n\n"
+                               "{% comment %}\n\nC\n\n{% /comment %}\n\nD\n";
+    const char *const starts[] = {text, strstr(text, "{% $var"), strstr(text, "{% /note /%}"),
+                                  strstr(text, "B\n"), strstr(text, "{% comment"),
+                                  strstr(text, "D\n")};
+    return check_split("tag split", text, starts, sizeof(starts) / sizeof(starts[0]));
+}
+
+// Parses `source` whole and in chunks and compares the top-level blocks.
+static int check_chunked(TSParser *parser, const char *name, const char *source,
+                         uint32_t length, const MarkdocChunkOptions *options) {
+    TSTree *whole = ts_parser_parse_string(parser, NULL, source, length);
+    TSNode root = ts_tree_root_node(whole);
+    MarkdocChunkedTree *chunked =
+        markdoc_parse_chunked(tree_sitter_markdoc(), source, length, options);
+
+    int failures = 0;
+    uint32_t block_count = ts_node_named_child_count(root);
+    if (chunked == NULL) {
+        fprintf(stderr, "%s: markdoc_parse_chunked failed\n", name);
+        failures++;
+    } else if (markdoc_chunked_tree_block_count(chunked) != block_count) {
+        fprintf(stderr, "%s: %u blocks, expected %u\n", name,
+                markdoc_chunked_tree_block_count(chunked), block_count);
+        failures++;
+    } else {
+        bool ok = ts_node_has_error(root) || !markdoc_chunked_tree_has_error(chunked);
+        for (uint32_t b = 0; ok && b < block_count; b++) {
+            if (!same_block(ts_node_named_child(root, b),
+                            markdoc_chunked_tree_block(chunked, b))) {
+                fprintf(stderr, "%s: block %u differs\n", name, b);
+                ok = false;
+            }
+        }
+        if (ok) {
+            printf("%s: ok (%u chunks)\n", name, markdoc_chunked_tree_chunk_count(chunked));
+        } else {
+            failures++;
+        }
+    }
+
+    markdoc_chunked_tree_delete(chunked);
+    ts_tree_delete(whole);
+    return failures;
+}
+
+// A document made of tag lines, nested tag bodies with blank lines in them,
+// comment blocks, and a fence longer than the scanner counts, parsed in
+// chunks cut at every blank line markdoc_split_chunks() allows.
+static int check_tag_heavy(TSParser *parser) {
+    // comment_block is one greedy token, so these two comments and the
+    // paragraph between them are a single block.
+    static const char comments[] = "{% comment %}\nHidden.\n{% /comment %}\n\n"
+                                   "Between.\n\n"
+                                   "{% comment %}\n\n{% note %}\n\n{% /comment %}\n\n";
+    static const char section[] =
+        "{% section title=\"A %} b\" %}\n\n"
+        "Intro with {% $var %} inline.\n\n"
+        "{% note type=\"tip\" %}\n\n"
+        "{% $var %}\n\n"
+        "Inside the note.\n\n"
+        "{% /note %}\n\n"
+        "{% toc /%}\n\n"
+        "{% /note /%}\n\n"
+        "```md\n{% note %}\n\n```\n\n"
+        "{% /section %}\n\n"
+        "After.\n\n";
+    // 300 tildes: the scanner counts 255 of them, so the closing line below
+    // has markers left over and the fence runs to the end of the document.
+    char fence[301];
+    memset(fence, '~', 300);
+    fence[300] = '\0';
+
+    uint32_t repeat = 20;
+    size_t capacity = sizeof(comments) + repeat * (sizeof(section) - 1) + 2 * sizeof(fence) + 64;
+    char *source = malloc(capacity);
+    memcpy(source, comments, sizeof(comments) - 1);
+    size_t length = sizeof(comments) - 1;
+    for (uint32_t i = 0; i < repeat; i++) {
+        memcpy(source + length, section, sizeof(section) - 1);
+        length += sizeof(section) - 1;
+    }
+    length += (size_t)snprintf(source + length, capacity - length,
+                               "%s\n\n{%% note %%}\n\n%s\n\nLast.\n", fence, fence);
+
+    MarkdocChunkOptions options = {.target_chunk_size = 1, .thread_count = 4};
+    int failures = check_chunked(parser, "tag-heavy", source, (uint32_t)length, &options);
+    free(source);
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+    MarkdocChunkOptions options = {.target_chunk_size = 16 * 1024, .thread_count = 4};
+
+    int failures = check_list_split();
+    failures += check_tag_split();
+    failures += check_tag_heavy(parser);
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+
+        failures += check_chunked(parser, argv[i], source, length, &options);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
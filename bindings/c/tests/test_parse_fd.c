@@ -0,0 +1,237 @@
+// Streams each file through a pipe from a child process, writing it in small
+// pieces, and asserts that markdoc_parse_fd() with a small chunk ring yields
+// the same tree as parsing the whole file from memory. Also asserts that
+// UTF-8 characters split across chunks reach the lexer whole, and the
+// documented limit: a document with a `{% comment %}` block fails with
+// ENOBUFS unless the whole document fits in the ring.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/stream.h"
+
+// Forks a producer that writes `source` to a pipe in 1000-byte pieces and
+// returns the read end.
+static int start_producer(const char *source, uint32_t length, pid_t *pid) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return -1;
+    }
+    *pid = fork();
+    if (*pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    if (*pid == 0) {
+        close(fds[0]);
+        uint32_t offset = 0;
+        while (offset < length) {
+            uint32_t piece = length - offset < 1000 ? length - offset : 1000;
+            ssize_t written = write(fds[1], source + offset, piece);
+            if (written <= 0) {
+                _exit(1);
+            }
+            offset += (uint32_t)written;
+        }
+        close(fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+    return fds[0];
+}
+
+// Streams `source` through a pipe with `options`; sets errno on failure.
+static TSTree *parse_piped(TSParser *parser, const char *source, uint32_t length,
+                           const MarkdocStreamOptions *options) {
+    pid_t pid;
+    int fd = start_producer(source, length, &pid);
+    if (fd < 0) {
+        return NULL;
+    }
+    TSTree *tree = markdoc_parse_fd(parser, fd, options);
+    int error = errno;
+    close(fd);
+    waitpid(pid, NULL, 0);
+    errno = error;
+    return tree;
+}
+
+static int check_comment_limit(TSParser *parser, const MarkdocStreamOptions *options) {
+    static const char comment[] = "{% comment %}\nHidden.\n{% /comment %}\n\n";
+    static const char paragraph[] = "A paragraph after the comment block.\n\n";
+    uint32_t ring = options->chunk_size * options->chunk_count;
+    uint32_t count = ring / (sizeof(paragraph) - 1) + 1;
+    uint32_t length = sizeof(comment) - 1 + count * (sizeof(paragraph) - 1);
+    char *source = malloc(length);
+    memcpy(source, comment, sizeof(comment) - 1);
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(source + sizeof(comment) - 1 + i * (sizeof(paragraph) - 1), paragraph,
+               sizeof(paragraph) - 1);
+    }
+
+    int failures = 0;
+    TSTree *tree = parse_piped(parser, source, length, options);
+    if (tree != NULL || errno != ENOBUFS) {
+        fprintf(stderr, "comment: a %u-byte document in a %u-byte ring did not fail with "
+                        "ENOBUFS\n", length, ring);
+        failures++;
+    }
+    ts_tree_delete(tree);
+
+    MarkdocStreamOptions larger = {.chunk_size = options->chunk_size,
+                                   .chunk_count = length / options->chunk_size + 1};
+    tree = parse_piped(parser, source, length, &larger);
+    TSTree *copied_tree = ts_parser_parse_string(parser, NULL, source, length);
+    if (tree == NULL) {
+        fprintf(stderr, "comment: failed with a ring that holds the document: %s\n",
+                strerror(errno));
+        failures++;
+    } else {
+        char *streamed = ts_node_string(ts_tree_root_node(tree));
+        char *copied = ts_node_string(ts_tree_root_node(copied_tree));
+        if (strcmp(streamed, copied) != 0) {
+            fprintf(stderr, "comment: trees differ\n");
+            failures++;
+        }
+        free(streamed);
+        free(copied);
+        ts_tree_delete(tree);
+    }
+    if (failures == 0) {
+        printf("comment: ok (ENOBUFS in a %u-byte ring)\n", ring);
+    }
+    ts_tree_delete(copied_tree);
+    free(source);
+    return failures;
+}
+
+// Counts the characters the lexer failed to decode, which it logs as -1.
+static void count_decode_errors(void *payload, TSLogType type, const char *message) {
+    if (type == TSLogTypeLex && strstr(message, "character:-1") != NULL) {
+        (*(int *)payload)++;
+    }
+}
+
+// Pads a paragraph with ASCII so that a 2-, 3- and 4-byte character each
+// straddle an 8-byte chunk boundary at every possible split, and streams it
+// through 8-byte chunks.
+static int check_split_characters(TSParser *parser) {
+    static const char *characters[] = {"\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x93\x9d"};
+    MarkdocStreamOptions options = {.chunk_size = 8, .chunk_count = 64};
+    char source[256];
+    uint32_t length = 0;
+    for (int i = 0; i < 3; i++) {
+        uint32_t width = (uint32_t)strlen(characters[i]);
+        for (uint32_t split = 1; split < width; split++) {
+            while ((length + split) % options.chunk_size != 0) {
+                source[length++] = 'a';
+            }
+            memcpy(source + length, characters[i], width);
+            length += width;
+        }
+    }
+    source[length++] = '\n';
+
+    int failures = 0;
+    int decode_errors = 0;
+    TSLogger logger = {.payload = &decode_errors, .log = count_decode_errors};
+    ts_parser_set_logger(parser, logger);
+    TSTree *tree = parse_piped(parser, source, length, &options);
+    ts_parser_set_logger(parser, (TSLogger){0});
+    TSTree *copied_tree = ts_parser_parse_string(parser, NULL, source, length);
+    if (tree == NULL) {
+        fprintf(stderr, "split characters: markdoc_parse_fd failed: %s\n", strerror(errno));
+        failures++;
+    } else {
+        char *streamed = ts_node_string(ts_tree_root_node(tree));
+        char *copied = ts_node_string(ts_tree_root_node(copied_tree));
+        if (strcmp(streamed, copied) != 0) {
+            fprintf(stderr, "split characters: trees differ\n");
+            failures++;
+        }
+        if (decode_errors > 0) {
+            fprintf(stderr, "split characters: %d characters did not decode\n", decode_errors);
+            failures++;
+        }
+        free(streamed);
+        free(copied);
+        ts_tree_delete(tree);
+    }
+    if (failures == 0) {
+        printf("split characters: ok (%u bytes in %u-byte chunks)\n", length,
+               options.chunk_size);
+    }
+    ts_tree_delete(copied_tree);
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+    MarkdocStreamOptions options = {.chunk_size = 4096, .chunk_count = 8};
+
+    int failures = check_comment_limit(parser, &options);
+    failures += check_split_characters(parser);
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+
+        pid_t pid;
+        int fd = start_producer(source, length, &pid);
+        if (fd < 0) {
+            perror("pipe");
+            free(source);
+            failures++;
+            continue;
+        }
+        TSTree *streamed_tree = markdoc_parse_fd(parser, fd, &options);
+        close(fd);
+        int status = 0;
+        waitpid(pid, &status, 0);
+
+        TSTree *copied_tree = ts_parser_parse_string(parser, NULL, source, length);
+        if (streamed_tree == NULL) {
+            fprintf(stderr, "%s: markdoc_parse_fd failed: %s\n", argv[i], strerror(errno));
+            failures++;
+        } else {
+            char *streamed = ts_node_string(ts_tree_root_node(streamed_tree));
+            char *copied = ts_node_string(ts_tree_root_node(copied_tree));
+            if (strcmp(streamed, copied) != 0) {
+                fprintf(stderr, "%s: trees differ\n", argv[i]);
+                failures++;
+            } else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                fprintf(stderr, "%s: producer failed\n", argv[i]);
+                failures++;
+            } else {
+                printf("%s: ok\n", argv[i]);
+            }
+            free(streamed);
+            free(copied);
+            ts_tree_delete(streamed_tree);
+        }
+
+        ts_tree_delete(copied_tree);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+// Asserts that markdoc_parse_file() produces the same tree as parsing a heap
+// copy of each file, and that the mapping it returns holds the file's bytes.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/file.h"
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+
+    int failures = 0;
+
+    MarkdocMappedFile missing;
+    errno = 0;
+    if (markdoc_parse_file(parser, NULL, "/nonexistent/file.mdoc", &missing) != NULL ||
+        errno != ENOENT || missing.length != 0) {
+        fprintf(stderr, "missing file: expected NULL with ENOENT\n");
+        failures++;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+
+        MarkdocMappedFile mapping;
+        TSTree *mapped_tree = markdoc_parse_file(parser, NULL, argv[i], &mapping);
+        TSTree *copied_tree = ts_parser_parse_string(parser, NULL, source, length);
+        if (mapped_tree == NULL) {
+            fprintf(stderr, "%s: markdoc_parse_file failed: %s\n", argv[i], strerror(errno));
+            failures++;
+        } else {
+            char *mapped = ts_node_string(ts_tree_root_node(mapped_tree));
+            char *copied = ts_node_string(ts_tree_root_node(copied_tree));
+            if (strcmp(mapped, copied) != 0) {
+                fprintf(stderr, "%s: trees differ\n", argv[i]);
+                failures++;
+            } else if (mapping.length != length || memcmp(mapping.data, source, length) != 0) {
+                fprintf(stderr, "%s: mapping does not match the file\n", argv[i]);
+                failures++;
+            } else {
+                printf("%s: ok\n", argv[i]);
+            }
+            free(mapped);
+            free(copied);
+            ts_tree_delete(mapped_tree);
+            markdoc_unmap_file(&mapping);
+        }
+
+        ts_tree_delete(copied_tree);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+// Asserts that every SIMD level indexes the same lines, that a snippet's
+// lines get the flags the scanner's rules give them, and that the lines the
+// parser opens or closes a code fence or block tag on carry the matching
+// prescan flag. Outside fences, comments, frontmatter, HTML and errors, a
+// line flagged as a tag must also be one in the parse.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/prescan.h"
+
+static bool same_index(const MarkdocLineIndex *a, const MarkdocLineIndex *b) {
+    return a->line_count == b->line_count &&
+           memcmp(a->line_starts, b->line_starts, a->line_count * sizeof(uint32_t)) == 0 &&
+           memcmp(a->line_flags, b->line_flags, a->line_count) == 0;
+}
+
+// The flag a node starting at column 0 must put on its line, or 0 when the
+// node says nothing about its line.
+static uint8_t expected_flag(TSNode node) {
+    const char *type = ts_node_type(node);
+    if (strcmp(type, "code_fence_open") == 0 || strcmp(type, "code_fence_close") == 0) {
+        return MARKDOC_LINE_FENCE;
+    }
+    TSNode parent = ts_node_parent(node);
+    if (ts_node_is_null(parent) || strcmp(ts_node_type(parent), "markdoc_tag") != 0) {
+        return 0;
+    }
+    if (strcmp(type, "tag_open") == 0) {
+        return MARKDOC_LINE_TAG_OPEN;
+    }
+    if (strcmp(type, "tag_close") == 0) {
+        return MARKDOC_LINE_TAG_CLOSE;
+    }
+    if (strcmp(type, "tag_self_close") == 0) {
+        return MARKDOC_LINE_TAG_SELF_CLOSE;
+    }
+    return 0;
+}
+
+// Whether the parser takes the rows of `node` verbatim, or could not parse
+// them, so that a `{%` line among them is no tag whatever its flags say.
+static bool is_opaque(TSNode node) {
+    static const char *const types[] = {"fenced_code_block", "comment_block", "frontmatter",
+                                        "html_block", "html_comment"};
+    if (ts_node_is_error(node) || ts_node_is_missing(node)) {
+        return true;
+    }
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        if (strcmp(ts_node_type(node), types[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t check_against_tree(const char *path, TSTree *tree,
+                                   const MarkdocLineIndex *index) {
+    const uint8_t tag_flags =
+        MARKDOC_LINE_TAG_OPEN | MARKDOC_LINE_TAG_CLOSE | MARKDOC_LINE_TAG_SELF_CLOSE;
+    uint8_t *parsed = calloc(index->line_count + 1, 1);
+    bool *opaque = calloc(index->line_count + 1, sizeof(bool));
+    uint32_t mismatches = 0;
+    TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+    for (;;) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        TSPoint start = ts_node_start_point(node);
+        uint8_t flag = start.column == 0 ? expected_flag(node) : 0;
+        if (flag != 0 &&
+            (start.row >= index->line_count || !(index->line_flags[start.row] & flag))) {
+            fprintf(stderr, "%s:%u: %s not flagged\n", path, start.row + 1, ts_node_type(node));
+            mismatches++;
+        }
+        if (start.row < index->line_count) {
+            parsed[start.row] |= flag;
+        }
+        if (is_opaque(node)) {
+            uint32_t end_row = ts_node_end_point(node).row;
+            for (uint32_t row = start.row; row <= end_row && row < index->line_count; row++) {
+                opaque[row] = true;
+            }
+            // Nothing inside says anything about its lines.
+        } else if (ts_tree_cursor_goto_first_child(&cursor)) {
+            continue;
+        }
+        bool done = false;
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                done = true;
+                break;
+            }
+        }
+        if (done) {
+            break;
+        }
+    }
+    ts_tree_cursor_delete(&cursor);
+
+    for (uint32_t row = 0; row < index->line_count; row++) {
+        uint8_t flagged = index->line_flags[row] & tag_flags;
+        if (!opaque[row] && flagged != 0 && flagged != parsed[row]) {
+            fprintf(stderr, "%s:%u: flagged %#x, parsed as %#x\n", path, row + 1, flagged,
+                    parsed[row]);
+            mismatches++;
+        }
+    }
+    free(parsed);
+    free(opaque);
+    return mismatches;
+}
+
+static int check_snippet(void) {
+    static const char text[] = "---\ntitle: x\n---\n\n"
+                               "```js\ncode\n```\n"
+                               "  ```\n"
+                               "{% note %}\r\n"
+                               "{% /note %}\n"
+                               "{% toc /%}\n"
+                               "{% $var %}\n"
+                               "{% /note /%}\n"
+                               "{% note %} text\n"
+                               "{% comment %}\n"
+                               "  <!-- c -->\n"
+                               " \t\n"
+                               "Text";
+    static const uint8_t expected[] = {
+        MARKDOC_LINE_DELIMITER, 0, MARKDOC_LINE_DELIMITER, MARKDOC_LINE_BLANK,
+        MARKDOC_LINE_FENCE, 0, MARKDOC_LINE_FENCE,
+        0,
+        MARKDOC_LINE_TAG_OPEN,
+        MARKDOC_LINE_TAG_CLOSE,
+        MARKDOC_LINE_TAG_SELF_CLOSE,
+        0, 0, 0,
+        MARKDOC_LINE_COMMENT_OPEN,
+        MARKDOC_LINE_HTML_COMMENT,
+        MARKDOC_LINE_BLANK,
+        0,
+    };
+    const uint32_t line_count = sizeof(expected) / sizeof(expected[0]);
+    MarkdocLineIndex index;
+    if (!markdoc_prescan(text, sizeof(text) - 1, &index)) {
+        fprintf(stderr, "snippet: markdoc_prescan failed\n");
+        return 1;
+    }
+    int failures = 0;
+    if (index.line_count != line_count) {
+        fprintf(stderr, "snippet: %u lines, expected %u\n", index.line_count, line_count);
+        failures++;
+    }
+    for (uint32_t i = 0; i < index.line_count && i < line_count; i++) {
+        if (index.line_flags[i] != expected[i]) {
+            fprintf(stderr, "snippet:%u: flags %#x, expected %#x\n", i + 1, index.line_flags[i],
+                    expected[i]);
+            failures++;
+        }
+    }
+    if (failures == 0) {
+        printf("snippet: ok (%u lines)\n", index.line_count);
+    }
+    markdoc_line_index_delete(&index);
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+
+    int failures = check_snippet();
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+
+        MarkdocLineIndex scalar;
+        if (!markdoc_prescan_with_level(source, length, &scalar, MARKDOC_SIMD_SCALAR)) {
+            fprintf(stderr, "%s: markdoc_prescan failed\n", argv[i]);
+            failures++;
+            free(source);
+            continue;
+        }
+
+        bool ok = true;
+        const MarkdocSimdLevel levels[] = {MARKDOC_SIMD_SSE2, MARKDOC_SIMD_AVX2};
+        for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+            MarkdocLineIndex vector;
+            if (!markdoc_prescan_with_level(source, length, &vector, levels[l])) {
+                continue;  // Not available on this machine.
+            }
+            if (!same_index(&scalar, &vector)) {
+                fprintf(stderr, "%s: SIMD level %d differs from scalar\n", argv[i], levels[l]);
+                ok = false;
+            }
+            markdoc_line_index_delete(&vector);
+        }
+
+        TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+        if (check_against_tree(argv[i], tree, &scalar) > 0) {
+            ok = false;
+        }
+
+        if (ok) {
+            printf("%s: ok (%u lines)\n", argv[i], scalar.line_count);
+        } else {
+            failures++;
+        }
+        ts_tree_delete(tree);
+        markdoc_line_index_delete(&scalar);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
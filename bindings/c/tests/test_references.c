@@ -0,0 +1,162 @@
+// Asserts that markdoc_references_collect() finds every variable_value and
+// call_expression in the tree, with interned names, paths and subscripts
+// as written, numbers that are no array index included, and knows
+// attribute values from inline expressions.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/references.h"
+#include "tree_sitter/markdoc/symbols.h"
+
+static uint32_t count_expressions(TSNode node) {
+    TSSymbol symbol = ts_node_symbol(node);
+    uint32_t expressions = symbol == MARKDOC_SYM_VARIABLE_VALUE ||
+                           symbol == MARKDOC_SYM_CALL_EXPRESSION;
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        expressions += count_expressions(ts_node_named_child(node, i));
+    }
+    return expressions;
+}
+
+// Writes a reference's path as `name.field[0]` into `out`. A string
+// subscript reads as a field, and a number that is no index as `[?]`.
+static void format_path(const MarkdocReferences *references, const MarkdocReference *reference,
+                        char *out, size_t size) {
+    size_t used = 0;
+    out[0] = '\0';
+    for (uint32_t i = 0; i < reference->path_length && used < size; i++) {
+        uint32_t element = references->path[reference->path_offset + i];
+        if (element == MARKDOC_REFERENCE_UNKNOWN_INDEX) {
+            used += (size_t)snprintf(out + used, size - used, "[?]");
+        } else if (element & MARKDOC_REFERENCE_INDEX) {
+            used += (size_t)snprintf(out + used, size - used, "[%u]",
+                                     element & ~MARKDOC_REFERENCE_INDEX);
+        } else {
+            used += (size_t)snprintf(out + used, size - used, i > 0 ? ".%s" : "%s",
+                                     references->names + references->name_offsets[element]);
+        }
+    }
+}
+
+static int check_snippet(TSParser *parser) {
+    static const char source[] = "Hello {% $user.name %} and {% upper(@page.title) %}\n\n"
+                                 "{% card title=$user.cards[2][\"name\"] size=1 /%}\n\n"
+                                 "{% $a[-1] %} {% $a[1.5] %} {% $a[4294967296] %} "
+                                 "{% $a[-0] %} {% $a[2.0] %} {% $a[2147483646] %}\n";
+    static const struct {
+        MarkdocReferenceKind kind;
+        bool in_attribute;
+        const char *text;
+        const char *path;
+    } expected[] = {
+        {MARKDOC_REFERENCE_VARIABLE, false, "$user.name", "user.name"},
+        {MARKDOC_REFERENCE_FUNCTION, false, "upper", "upper"},
+        {MARKDOC_REFERENCE_SPECIAL, false, "@page.title", "page.title"},
+        {MARKDOC_REFERENCE_VARIABLE, true, "$user.cards[2][\"name\"]", "user.cards[2].name"},
+        {MARKDOC_REFERENCE_VARIABLE, false, "$a[-1]", "a[?]"},
+        {MARKDOC_REFERENCE_VARIABLE, false, "$a[1.5]", "a[?]"},
+        {MARKDOC_REFERENCE_VARIABLE, false, "$a[4294967296]", "a[?]"},
+        {MARKDOC_REFERENCE_VARIABLE, false, "$a[-0]", "a[0]"},
+        {MARKDOC_REFERENCE_VARIABLE, false, "$a[2.0]", "a[2]"},
+        {MARKDOC_REFERENCE_VARIABLE, false, "$a[2147483646]", "a[2147483646]"},
+    };
+    const uint32_t expected_count = sizeof(expected) / sizeof(expected[0]);
+
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source, sizeof(source) - 1);
+    MarkdocReferences references;
+    int failures = 0;
+    if (!markdoc_references_collect(ts_tree_root_node(tree), source, &references)) {
+        fprintf(stderr, "snippet: out of memory\n");
+        failures++;
+    } else if (references.count != expected_count) {
+        fprintf(stderr, "snippet: %u references, expected %u\n", references.count,
+                expected_count);
+        failures++;
+    } else {
+        for (uint32_t i = 0; i < expected_count; i++) {
+            const MarkdocReference *reference = &references.references[i];
+            char path[256];
+            format_path(&references, reference, path, sizeof(path));
+            uint32_t length = reference->end_byte - reference->start_byte;
+            if (reference->kind != expected[i].kind ||
+                reference->in_attribute != expected[i].in_attribute ||
+                length != strlen(expected[i].text) ||
+                memcmp(source + reference->start_byte, expected[i].text, length) != 0 ||
+                strcmp(path, expected[i].path) != 0) {
+                fprintf(stderr, "snippet: reference %u is \"%.*s\" %s, expected \"%s\" %s\n", i,
+                        (int)length, source + reference->start_byte, path, expected[i].text,
+                        expected[i].path);
+                failures++;
+            }
+        }
+        uint32_t user = markdoc_references_find(&references, "user", 4);
+        if (user == MARKDOC_REFERENCE_NO_NAME ||
+            references.path[references.references[3].path_offset] != user ||
+            markdoc_references_find(&references, "missing", 7) != MARKDOC_REFERENCE_NO_NAME) {
+            fprintf(stderr, "snippet: names are not interned\n");
+            failures++;
+        }
+    }
+    if (failures == 0) {
+        printf("snippet: ok (%u references, %u names)\n", references.count,
+               references.name_count);
+    }
+    markdoc_references_delete(&references);
+    ts_tree_delete(tree);
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+    int failures = check_snippet(parser);
+
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+        TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+        TSNode root = ts_tree_root_node(tree);
+
+        MarkdocReferences references;
+        if (!markdoc_references_collect(root, source, &references)) {
+            fprintf(stderr, "%s: out of memory\n", argv[i]);
+            failures++;
+        } else {
+            uint32_t expressions = count_expressions(root);
+            bool ordered = true;
+            for (uint32_t j = 1; j < references.count; j++) {
+                ordered = ordered && references.references[j - 1].start_byte <=
+                                         references.references[j].start_byte;
+            }
+            if (references.count != expressions || !ordered) {
+                fprintf(stderr, "%s: %u references, the tree has %u expressions\n", argv[i],
+                        references.count, expressions);
+                failures++;
+            } else {
+                printf("%s: ok (%u references, %u names)\n", argv[i], references.count,
+                       references.name_count);
+            }
+        }
+
+        markdoc_references_delete(&references);
+        ts_tree_delete(tree);
+        free(source);
+    }
+
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
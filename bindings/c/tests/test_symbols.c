@@ -0,0 +1,87 @@
+// Asserts that the generated symbol and field IDs in symbols.h name the same
+// nodes and fields as the compiled language does.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "tree_sitter/markdoc/symbols.h"
+#include "tree_sitter/tree-sitter-tree-sitter-markdoc.h"
+
+static const struct {
+    TSSymbol symbol;
+    const char *name;
+    bool named;
+} SYMBOLS[] = {
+    {MARKDOC_SYM_SOURCE_FILE, "source_file", true},
+    {MARKDOC_SYM_FRONTMATTER, "frontmatter", true},
+    {MARKDOC_SYM_YAML, "yaml", true},
+    {MARKDOC_SYM_HEADING, "heading", true},
+    {MARKDOC_SYM_BLOCKQUOTE, "blockquote", true},
+    {MARKDOC_SYM_FENCED_CODE_BLOCK, "fenced_code_block", true},
+    {MARKDOC_SYM_CODE_FENCE_OPEN, "code_fence_open", true},
+    {MARKDOC_SYM_CODE_FENCE_CLOSE, "code_fence_close", true},
+    {MARKDOC_SYM_MARKDOC_TAG, "markdoc_tag", true},
+    {MARKDOC_SYM_TAG_OPEN, "tag_open", true},
+    {MARKDOC_SYM_TAG_CLOSE, "tag_close", true},
+    {MARKDOC_SYM_TAG_SELF_CLOSE, "tag_self_close", true},
+    {MARKDOC_SYM_TAG_NAME, "tag_name", true},
+    {MARKDOC_SYM_ATTRIBUTE, "attribute", true},
+    {MARKDOC_SYM_VARIABLE, "variable", true},
+    {MARKDOC_SYM_TEXT, "text", true},
+    {MARKDOC_ANON_BANG_LBRACK, "![", false},
+    {MARKDOC_ANON_BSLASH, "\\", false},
+};
+
+static const struct {
+    TSFieldId field;
+    const char *name;
+} FIELDS[] = {
+    {MARKDOC_FIELD_BLOCK, "block"},
+    {MARKDOC_FIELD_CLOSE, "close"},
+    {MARKDOC_FIELD_CODE, "code"},
+    {MARKDOC_FIELD_CONTENT, "content"},
+    {MARKDOC_FIELD_FUNCTION, "function"},
+    {MARKDOC_FIELD_HEADING_MARKER, "heading_marker"},
+    {MARKDOC_FIELD_HEADING_TEXT, "heading_text"},
+    {MARKDOC_FIELD_ITEMS, "items"},
+    {MARKDOC_FIELD_KEY, "key"},
+    {MARKDOC_FIELD_MARKER, "marker"},
+    {MARKDOC_FIELD_OPEN, "open"},
+    {MARKDOC_FIELD_VALUE, "value"},
+};
+
+int main(void) {
+    const TSLanguage *language = tree_sitter_markdoc();
+    int failures = 0;
+
+    if (!markdoc_symbols_match(language)) {
+        fprintf(stderr, "symbols.h was generated for a different parser.c\n");
+        failures++;
+    }
+
+    for (size_t i = 0; i < sizeof(SYMBOLS) / sizeof(SYMBOLS[0]); i++) {
+        TSSymbol symbol = ts_language_symbol_for_name(language, SYMBOLS[i].name,
+                                                      (uint32_t)strlen(SYMBOLS[i].name),
+                                                      SYMBOLS[i].named);
+        if (symbol != SYMBOLS[i].symbol) {
+            fprintf(stderr, "%s: header says %u, language says %u\n", SYMBOLS[i].name,
+                    SYMBOLS[i].symbol, symbol);
+            failures++;
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(FIELDS) / sizeof(FIELDS[0]); i++) {
+        TSFieldId field = ts_language_field_id_for_name(language, FIELDS[i].name,
+                                                        (uint32_t)strlen(FIELDS[i].name));
+        if (field != FIELDS[i].field) {
+            fprintf(stderr, "field %s: header says %u, language says %u\n", FIELDS[i].name,
+                    FIELDS[i].field, field);
+            failures++;
+        }
+    }
+
+    if (failures == 0) {
+        printf("symbols.h: ok\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
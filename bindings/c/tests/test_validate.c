@@ -0,0 +1,152 @@
+// Asserts that markdoc_validate() reports wrong attribute types, duplicate
+// and missing attributes, a tag written in the wrong form, a mismatched
+// closing tag, disallowed children and unknown tags, in document order, and
+// that it reports every syntax error and unknown tag of the samples.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helpers.h"
+#include "tree_sitter/markdoc/symbols.h"
+#include "tree_sitter/markdoc/validate.h"
+
+// Counts the error and missing nodes, and the tags outside them.
+static void count_problems(TSNode node, uint32_t *errors, uint32_t *tags) {
+    if (ts_node_is_missing(node) || ts_node_symbol(node) == MARKDOC_SYM_ERROR) {
+        (*errors)++;
+        return;
+    }
+    TSSymbol symbol = ts_node_symbol(node);
+    *tags += symbol == MARKDOC_SYM_MARKDOC_TAG || symbol == MARKDOC_SYM_INLINE_TAG;
+    uint32_t count = ts_node_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        count_problems(ts_node_child(node, i), errors, tags);
+    }
+}
+
+static int check_snippet(TSParser *parser) {
+    static const char source[] = "{% card title=1 title=\"x\" /%}\n\n"
+                                 "{% card %}\nHi\n{% /cart %}\n\n"
+                                 "{% note %}\n# Heading\n{% /note %}\n\n"
+                                 "{% widget /%}\n";
+    static const MarkdocAttributeSchema card_attributes[] = {
+        {.name = "title", .types = MARKDOC_TYPE_STRING, .required = true},
+    };
+    static const char *const note_children[] = {"paragraph", "list"};
+    static const MarkdocTagSchema tags[] = {
+        {.name = "card", .attributes = card_attributes, .attribute_count = 1,
+         .form = MARKDOC_TAG_SELF_CLOSING},
+        {.name = "note", .children = note_children, .child_count = 2},
+    };
+    static const struct {
+        MarkdocDiagnosticKind kind;
+        const char *text;
+    } expected[] = {
+        {MARKDOC_DIAGNOSTIC_ATTRIBUTE_TYPE, "1"},
+        {MARKDOC_DIAGNOSTIC_DUPLICATE_ATTRIBUTE, "title=\"x\""},
+        {MARKDOC_DIAGNOSTIC_CLOSE_MISMATCH, "cart"},
+        {MARKDOC_DIAGNOSTIC_WRONG_FORM, "{% card %}"},
+        {MARKDOC_DIAGNOSTIC_MISSING_ATTRIBUTE, "{% card %}"},
+        {MARKDOC_DIAGNOSTIC_CHILD_NOT_ALLOWED, "# Heading"},
+        {MARKDOC_DIAGNOSTIC_UNKNOWN_TAG, "widget"},
+    };
+    const uint32_t expected_count = sizeof(expected) / sizeof(expected[0]);
+
+    MarkdocSchema schema = {.tags = tags, .tag_count = 2};
+    MarkdocValidator *validator = markdoc_validator_new(&schema);
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source, sizeof(source) - 1);
+    MarkdocDiagnostics diagnostics;
+    int failures = 0;
+    if (!markdoc_validate(validator, ts_tree_root_node(tree), source, &diagnostics)) {
+        fprintf(stderr, "snippet: out of memory\n");
+        failures++;
+    } else if (diagnostics.count != expected_count) {
+        fprintf(stderr, "snippet: %u diagnostics, expected %u\n", diagnostics.count,
+                expected_count);
+        for (uint32_t i = 0; i < diagnostics.count; i++) {
+            fprintf(stderr, "  %s\n", markdoc_diagnostic_message(diagnostics.diagnostics[i].kind));
+        }
+        failures++;
+    } else {
+        for (uint32_t i = 0; i < expected_count; i++) {
+            const MarkdocDiagnostic *diagnostic = &diagnostics.diagnostics[i];
+            uint32_t length = diagnostic->end_byte - diagnostic->start_byte;
+            // Block nodes may or may not end after their newline, so only
+            // the start of each range is compared.
+            if (diagnostic->kind != expected[i].kind || length < strlen(expected[i].text) ||
+                memcmp(source + diagnostic->start_byte, expected[i].text,
+                       strlen(expected[i].text)) != 0) {
+                fprintf(stderr, "snippet: diagnostic %u is %s at \"%.*s\", expected %s at \"%s\"\n",
+                        i, markdoc_diagnostic_message(diagnostic->kind), (int)length,
+                        source + diagnostic->start_byte,
+                        markdoc_diagnostic_message(expected[i].kind), expected[i].text);
+                failures++;
+            }
+        }
+    }
+    if (failures == 0) {
+        printf("snippet: ok (%u diagnostics)\n", diagnostics.count);
+    }
+    markdoc_diagnostics_delete(&diagnostics);
+    ts_tree_delete(tree);
+    markdoc_validator_delete(validator);
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_markdoc());
+    int failures = check_snippet(parser);
+
+    // With no tags in the schema, every tag is unknown.
+    MarkdocSchema empty = {0};
+    MarkdocValidator *validator = markdoc_validator_new(&empty);
+
+    for (int i = 1; i < argc; i++) {
+        uint32_t length = 0;
+        char *source = read_file(argv[i], &length);
+        if (source == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+        TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+        TSNode root = ts_tree_root_node(tree);
+
+        MarkdocDiagnostics diagnostics;
+        if (!markdoc_validate(validator, root, source, &diagnostics)) {
+            fprintf(stderr, "%s: out of memory\n", argv[i]);
+            failures++;
+        } else {
+            uint32_t errors = 0, tags = 0, reported_errors = 0, reported_tags = 0;
+            count_problems(root, &errors, &tags);
+            for (uint32_t j = 0; j < diagnostics.count; j++) {
+                MarkdocDiagnosticKind kind = diagnostics.diagnostics[j].kind;
+                reported_errors += kind == MARKDOC_DIAGNOSTIC_SYNTAX;
+                reported_tags += kind == MARKDOC_DIAGNOSTIC_UNKNOWN_TAG;
+            }
+            if (reported_errors != errors || reported_tags != tags) {
+                fprintf(stderr,
+                        "%s: %u syntax errors and %u unknown tags, the tree has %u and %u\n",
+                        argv[i], reported_errors, reported_tags, errors, tags);
+                failures++;
+            } else {
+                printf("%s: ok (%u diagnostics)\n", argv[i], diagnostics.count);
+            }
+        }
+
+        markdoc_diagnostics_delete(&diagnostics);
+        ts_tree_delete(tree);
+        free(source);
+    }
+
+    markdoc_validator_delete(validator);
+    ts_parser_delete(parser);
+    return failures == 0 ? 0 : 1;
+}
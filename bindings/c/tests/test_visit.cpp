@@ -0,0 +1,138 @@
+// Asserts that markdoc::visit() reaches the same headings, tags and code
+// blocks as a ts_node_child() walk, that returning false from a handler
+// skips the subtree, that a handler can visit the tree again without
+// disturbing the walk it is called from, and that node text slices the right
+// bytes, cut to the source it is given when that is shorter than the tree.
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "tree_sitter/markdoc/markdoc.hpp"
+#include "tree_sitter/tree-sitter-tree-sitter-markdoc.h"
+
+namespace {
+
+struct Counts {
+    unsigned headings = 0;
+    unsigned tags = 0;
+    unsigned code_blocks = 0;
+};
+
+void count_by_name(TSNode node, Counts &counts) {
+    const char *type = ts_node_type(node);
+    if (std::strcmp(type, "heading") == 0) {
+        counts.headings++;
+    } else if (std::strcmp(type, "markdoc_tag") == 0) {
+        counts.tags++;
+    } else if (std::strcmp(type, "fenced_code_block") == 0) {
+        counts.code_blocks++;
+    }
+    for (uint32_t i = 0; i < ts_node_child_count(node); i++) {
+        count_by_name(ts_node_child(node, i), counts);
+    }
+}
+
+bool check_file(const char *path, markdoc::Parser &parser) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::fprintf(stderr, "%s: cannot read\n", path);
+        return false;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    std::string source = contents.str();
+    markdoc::Tree tree = parser.parse(source);
+
+    Counts expected;
+    count_by_name(tree.root(), expected);
+
+    Counts visited;
+    bool text_ok = true;
+    markdoc::visit<markdoc::Heading, markdoc::MarkdocTag, markdoc::FencedCodeBlock>(
+        tree, [&](auto kind, TSNode node) {
+            using K = decltype(kind);
+            std::string_view text = markdoc::text(node, source);
+            if constexpr (std::is_same_v<K, markdoc::Heading>) {
+                visited.headings++;
+                text_ok = text_ok && !text.empty() && text.front() == '#';
+            } else if constexpr (std::is_same_v<K, markdoc::MarkdocTag>) {
+                visited.tags++;
+                text_ok = text_ok && text.substr(0, 2) == "{%";
+            } else {
+                visited.code_blocks++;
+            }
+        });
+
+    // Tags nest; not descending into them must only count the outermost.
+    // Each handler call visits the whole tree again, which takes a cursor of
+    // its own rather than the one the outer walk is using.
+    unsigned outer_tags = 0;
+    bool nested_ok = true;
+    markdoc::visit<markdoc::MarkdocTag>(tree, [&](markdoc::MarkdocTag, TSNode) {
+        outer_tags++;
+        unsigned headings = 0;
+        markdoc::visit<markdoc::Heading>(tree, [&](markdoc::Heading, TSNode) { headings++; });
+        nested_ok = nested_ok && headings == expected.headings;
+        return false;
+    });
+    // A tree outliving a longer source, or sliced with a prefix of it.
+    std::string_view half(source.data(), source.size() / 2);
+    std::string_view root_text = markdoc::text(tree.root(), half);
+    uint32_t root_start = ts_node_start_byte(tree.root());
+    text_ok = text_ok && root_text.data() + root_text.size() == half.data() + half.size() &&
+              (root_start >= half.size() || root_text.data() == half.data() + root_start) &&
+              markdoc::text(tree.root(), std::string_view()).empty();
+
+    unsigned top_level_tags = 0;
+    for (uint32_t i = 0; i < ts_node_named_child_count(tree.root()); i++) {
+        TSNode block = ts_node_named_child(tree.root(), i);
+        top_level_tags += ts_node_symbol(block) == markdoc::symbol::markdoc_tag;
+    }
+
+    bool ok = true;
+    if (visited.headings != expected.headings || visited.tags != expected.tags ||
+        visited.code_blocks != expected.code_blocks) {
+        std::fprintf(stderr, "%s: visit found %u/%u/%u, expected %u/%u/%u\n", path,
+                     visited.headings, visited.tags, visited.code_blocks, expected.headings,
+                     expected.tags, expected.code_blocks);
+        ok = false;
+    }
+    if (!text_ok) {
+        std::fprintf(stderr, "%s: node text does not match its kind\n", path);
+        ok = false;
+    }
+    if (!nested_ok) {
+        std::fprintf(stderr, "%s: a visit nested in a handler missed headings\n", path);
+        ok = false;
+    }
+    if (outer_tags < top_level_tags || outer_tags > expected.tags) {
+        std::fprintf(stderr, "%s: %u outermost tags\n", path, outer_tags);
+        ok = false;
+    }
+    if (ok) {
+        std::printf("%s: ok (%u headings, %u tags, %u code blocks)\n", path, visited.headings,
+                    visited.tags, visited.code_blocks);
+    }
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    markdoc::Parser parser(tree_sitter_markdoc());
+    int failures = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!check_file(argv[i], parser)) {
+            failures++;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
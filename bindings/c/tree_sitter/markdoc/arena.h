@@ -0,0 +1,69 @@
+#ifndef TREE_SITTER_MARKDOC_ARENA_H_
+#define TREE_SITTER_MARKDOC_ARENA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A bump allocator for batch work where everything a parse allocates can be
+// dropped at once. While an arena is active on a thread, the tree-sitter
+// runtime allocates from it, and so does the external scanner when the
+// grammar is built with TREE_SITTER_REUSE_ALLOCATOR. Frees are no-ops, and
+// markdoc_arena_reset() releases everything together.
+//
+// Typical use, per document:
+//
+//     markdoc_arena_activate(arena);
+//     TSParser *parser = ts_parser_new();
+//     ... parse, walk the tree ...
+//     ts_parser_delete(parser);
+//     markdoc_arena_activate(NULL);
+//     markdoc_arena_reset(arena);
+//
+// Every parser, tree and cursor made while the arena was active is invalid
+// after the reset, even if it was never deleted.
+typedef struct MarkdocArena MarkdocArena;
+
+typedef struct {
+    // malloc, calloc and realloc calls served, and free calls received.
+    uint64_t allocations;
+    uint64_t frees;
+    // Bytes handed out since the last reset, and the capacity of the
+    // arena's blocks. Both are 0 for the heap.
+    size_t bytes_used;
+    size_t bytes_reserved;
+} MarkdocArenaStats;
+
+// Points tree-sitter's allocator at this module with ts_set_allocator().
+// Call it once, before creating any parser: memory tree-sitter allocated
+// earlier cannot be freed afterwards. Threads with no active arena keep
+// using malloc.
+void markdoc_arena_install(void);
+
+// `block_size` is the size of each block the arena reserves from malloc;
+// 0 means 1 MiB. Returns NULL when out of memory.
+MarkdocArena *markdoc_arena_new(size_t block_size);
+
+void markdoc_arena_delete(MarkdocArena *arena);
+
+// Makes `arena` serve the calling thread's allocations, or the heap when
+// NULL. Returns the previously active arena.
+MarkdocArena *markdoc_arena_activate(MarkdocArena *arena);
+
+// Forgets every allocation and keeps the blocks for reuse.
+void markdoc_arena_reset(MarkdocArena *arena);
+
+// Counters for `arena`, or for the calling thread's heap allocations when
+// `arena` is NULL.
+MarkdocArenaStats markdoc_arena_stats(const MarkdocArena *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_ARENA_H_
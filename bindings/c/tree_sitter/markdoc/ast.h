@@ -0,0 +1,55 @@
+#ifndef TREE_SITTER_MARKDOC_AST_H_
+#define TREE_SITTER_MARKDOC_AST_H_
+
+#include <stdbool.h>
+
+#include <tree_sitter/api.h>
+
+#include "tree_sitter/markdoc/writer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Writes the tree rooted at the source_file `node` as the JSON of the AST
+// that Markdoc.parse() returns, so a render pipeline can call
+// Markdoc.transform() on it without parsing the document again. The JSON is
+// streamed to `writer` during one walk of the tree, with no intermediate
+// nodes.
+//
+// Every node is written as Markdoc's Node serializes: `$$mdtype`, `errors`,
+// `lines`, `inline`, `attributes`, `children`, `type`, `tag` for tags,
+// `annotations` and `slots`. The mapping follows Markdoc's defaults:
+//
+// - frontmatter becomes the document's `frontmatter` attribute;
+// - headings, paragraphs, lists, items, blockquotes, `hr` and `fence` (with
+//   `content`, `language` and `key=value` pairs from the `{...}` info
+//   attributes) use Markdoc's node types and attributes;
+// - tags carry their name in `tag` and their attribute values as JSON, with
+//   variables as `{"$$mdtype":"Variable","path":[...]}` and function calls
+//   as `{"$$mdtype":"Function","name":...,"parameters":{"0":...}}`. `@`
+//   variables, which Markdoc lacks, add `"special":true`;
+// - `{% $var %}` in text becomes a text node whose content is the variable;
+// - the grammar lexes heading text, link text, emphasis, strong and
+//   blockquotes as single tokens. Their contents are split into text, `em`,
+//   `strong`, `code`, `link` and `image` nodes with the grammar's inline
+//   token rules, and a blockquote's lines into paragraphs with softbreaks;
+// - HTML blocks and comments become paragraphs of their lines, as Markdoc
+//   turns markdown-it's HTML parsing off, and `{% comment %}` blocks are
+//   dropped;
+// - ERROR nodes become `error` nodes with one syntax error.
+//
+// Where this differs from Markdoc.parse(): tags and `{% $var %}` inside
+// those single tokens stay text, and lists, headings or fences inside a
+// blockquote are read as paragraph lines. Inline nodes carry the `lines` of
+// the line they are on.
+//
+// `source` is the text the tree was parsed from. Returns false when a write
+// fails or when the tree's language is not the build symbols.h describes.
+bool markdoc_ast_write_json(TSNode node, const char *source, MarkdocWriter writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_AST_H_
@@ -0,0 +1,72 @@
+#ifndef TREE_SITTER_MARKDOC_BLOCKS_H_
+#define TREE_SITTER_MARKDOC_BLOCKS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Set in MarkdocBlock's `parent` for a top-level block.
+#define MARKDOC_BLOCK_NONE UINT32_MAX
+
+// A top-level block, or a markdoc_tag at any depth.
+typedef struct {
+    uint32_t start_byte;
+    uint32_t end_byte;
+    TSSymbol symbol;
+    // The block this one is nested in, or MARKDOC_BLOCK_NONE.
+    uint32_t parent;
+    // A 128-bit hash of the symbol and the block's bytes, in which each
+    // block nested directly in it counts by its own hash (Merkle style).
+    // It depends only on content, so a block that merely moved keeps it.
+    uint64_t hash[2];
+    // Whether the last build or update hashed this block, as opposed to
+    // keeping it from before.
+    bool changed;
+} MarkdocBlock;
+
+// The blocks of a document in pre-order, which is order of their start. The
+// fields after `count` belong to the index.
+typedef struct {
+    MarkdocBlock *blocks;
+    uint32_t count;
+    uint32_t capacity;
+    // [start, end) byte pairs edited since the last build or update.
+    uint32_t *edited;
+    uint32_t edited_count;
+    uint32_t edited_capacity;
+} MarkdocBlockHashes;
+
+// Hashes the named children of `node` and every markdoc_tag inside them,
+// with a walk that enters only block containers. `source` is the text the
+// tree was parsed from. Every block is marked changed. Returns false when
+// out of memory or when the tree's language is not the build symbols.h
+// describes.
+bool markdoc_block_hashes_build(TSNode node, const char *source, MarkdocBlockHashes *hashes);
+
+// Shifts the blocks' ranges for an edit, as ts_tree_edit() does for a tree.
+// Call it with each edit applied to the old tree.
+void markdoc_block_hashes_edit(MarkdocBlockHashes *hashes, const TSInputEdit *edit);
+
+// Brings the hashes up to date with `node`, the root of the tree reparsed
+// from the edited one, and its `source`, given the ranges that
+// ts_tree_get_changed_ranges() reported between them. Blocks outside those
+// ranges and outside every edit keep their hashes, nested blocks included;
+// the others are hashed again, reusing the hashes of unchanged blocks
+// nested in them, and marked changed. A render cache keyed by hash then
+// only misses for blocks whose content differs. Returns false when out of
+// memory or for another language build, leaving the hashes as they were.
+bool markdoc_block_hashes_update(MarkdocBlockHashes *hashes, TSNode node, const char *source,
+                                 const TSRange *changed, uint32_t changed_count);
+
+void markdoc_block_hashes_delete(MarkdocBlockHashes *hashes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_BLOCKS_H_
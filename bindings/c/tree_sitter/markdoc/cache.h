@@ -0,0 +1,69 @@
+#ifndef TREE_SITTER_MARKDOC_CACHE_H_
+#define TREE_SITTER_MARKDOC_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#include "tree_sitter/markdoc/flat.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bumped whenever the encoding changes, invalidating every cached tree.
+// Grammar and scanner changes need no bump: the key covers them.
+#define MARKDOC_CACHE_VERSION 1
+
+// A 128-bit hash of a document's bytes and of the grammar that parses it.
+typedef struct {
+    uint8_t bytes[16];
+} MarkdocCacheKey;
+
+// Hashes `source` together with a fingerprint of `language`: its ABI
+// version, state count, and symbol and field names and kinds, and
+// MARKDOC_SYMBOLS_GRAMMAR_HASH, the hash of the parser and scanner sources
+// this library was built from. A regenerated parser.c or a changed scanner
+// therefore misses every old entry.
+MarkdocCacheKey markdoc_cache_key(const TSLanguage *language, const char *source,
+                                  uint32_t length);
+
+// Encodes `flat` compactly: per node in pre-order, the symbol, field, child
+// count, zigzag delta of the start byte from the previous node's and the
+// byte length, all as LEB128 varints. Parent, child and sibling links are
+// rebuilt from the child counts. Returns a malloc'd buffer of `*size`
+// bytes, or NULL when out of memory.
+uint8_t *markdoc_flat_tree_encode(const MarkdocFlatTree *flat, const MarkdocCacheKey *key,
+                                  size_t *size);
+
+// Decodes a buffer written by markdoc_flat_tree_encode() for `key`. Returns
+// false when the data is truncated, corrupt, from another format version
+// or for another key, or when out of memory.
+bool markdoc_flat_tree_decode(const uint8_t *data, size_t size, const MarkdocCacheKey *key,
+                              MarkdocFlatTree *flat);
+
+// Loads the tree stored under `key` in the cache `directory`. Returns false
+// on a miss.
+bool markdoc_cache_load(const char *directory, const MarkdocCacheKey *key,
+                        MarkdocFlatTree *flat);
+
+// Stores `flat` under `key`, creating `directory` if needed. Entries are
+// written to a temporary file of their own and renamed into place, so
+// concurrent builds and threads sharing a directory never read a partial
+// entry.
+bool markdoc_cache_store(const char *directory, const MarkdocCacheKey *key,
+                         const MarkdocFlatTree *flat);
+
+// Loads `source`'s tree from the cache, or parses it with `parser`, stores
+// the result and returns it. `*hit` (if non-NULL) tells which happened.
+// Failing to store is not an error. Returns false when parsing fails or
+// when out of memory.
+bool markdoc_cache_parse(const char *directory, TSParser *parser, const char *source,
+                         uint32_t length, MarkdocFlatTree *flat, bool *hit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_CACHE_H_
@@ -0,0 +1,69 @@
+#ifndef TREE_SITTER_MARKDOC_CHUNKED_H_
+#define TREE_SITTER_MARKDOC_CHUNKED_H_
+
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Splits `source` into consecutive ranges of roughly `target_size` bytes that
+// can be parsed independently. Each range after the first starts on the line
+// after a blank line that lies outside frontmatter, code fences, HTML
+// comments, `{% tag %}` bodies and comment blocks, so no block spans two
+// ranges. A comment block runs to the last `{% /comment %}` in the document,
+// as the grammar's comment_block token does. Ranges never
+// start on a `---` line, which a fresh parser would take for frontmatter, or
+// on an indented line, which may continue a list item across the blank line.
+// Lists and blockquotes end at a blank line otherwise, so they are not split.
+//
+// Returns a malloc'd array of `*count` ranges covering [0, length) with
+// their start and end points, or NULL when out of memory.
+TSRange *markdoc_split_chunks(const char *source, uint32_t length, uint32_t target_size,
+                              uint32_t *count);
+
+typedef struct {
+    // Preferred chunk size in bytes; 0 means 4 MiB.
+    uint32_t target_chunk_size;
+    // Worker threads; 0 means one per online CPU.
+    unsigned thread_count;
+} MarkdocChunkOptions;
+
+// One logical tree made of a parse per chunk. Every chunk tree is parsed
+// over the whole `source` with its chunk as the only included range, so all
+// node byte offsets and points are document-absolute.
+//
+// The chunk trees are not stitched into one TSTree. Each has its own
+// source_file root, so a top-level block has no parent or sibling in another
+// chunk, and ts_tree_get_changed_ranges() and incremental reparsing work per
+// chunk. Read the document as the sequence of blocks below, or export each
+// chunk with markdoc_flat_tree_export() and concatenate the arrays.
+typedef struct MarkdocChunkedTree MarkdocChunkedTree;
+
+// Splits `source` with markdoc_split_chunks() and parses the chunks
+// concurrently, one TSParser per thread. `source` must outlive the result.
+// Returns NULL when out of memory.
+MarkdocChunkedTree *markdoc_parse_chunked(const TSLanguage *language, const char *source,
+                                          uint32_t length, const MarkdocChunkOptions *options);
+
+void markdoc_chunked_tree_delete(MarkdocChunkedTree *tree);
+
+uint32_t markdoc_chunked_tree_chunk_count(const MarkdocChunkedTree *tree);
+
+// The tree for chunk `index`, owned by `tree`.
+const TSTree *markdoc_chunked_tree_chunk(const MarkdocChunkedTree *tree, uint32_t index);
+
+// The top-level blocks of the whole document, in order: the named children
+// of every chunk's source_file.
+uint32_t markdoc_chunked_tree_block_count(const MarkdocChunkedTree *tree);
+TSNode markdoc_chunked_tree_block(const MarkdocChunkedTree *tree, uint32_t index);
+
+bool markdoc_chunked_tree_has_error(const MarkdocChunkedTree *tree);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_CHUNKED_H_
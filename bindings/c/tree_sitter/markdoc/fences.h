@@ -0,0 +1,72 @@
+#ifndef TREE_SITTER_MARKDOC_FENCES_H_
+#define TREE_SITTER_MARKDOC_FENCES_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A fenced code block, with the ranges queries/injections.scm captures. An
+// absent part has an empty range at the end of the fence's open line.
+typedef struct {
+    uint32_t start_byte;
+    uint32_t end_byte;
+    // The `language` of the info string, e.g. `js`.
+    uint32_t language_start;
+    uint32_t language_end;
+    // The `{...}` after the language, braces included.
+    uint32_t attributes_start;
+    uint32_t attributes_end;
+    // The code node: every line between the fences, nested fences included.
+    uint32_t code_start;
+    uint32_t code_end;
+    // How many fences this one sits in the code of; 0 for most.
+    uint32_t depth;
+    // Whether the last build or update read this fence from the tree, as
+    // opposed to keeping it from before.
+    bool changed;
+} MarkdocFence;
+
+// The fences of a document in order of their start. The fields after
+// `count` belong to the index.
+typedef struct {
+    MarkdocFence *fences;
+    uint32_t count;
+    uint32_t capacity;
+    // [start, end) byte pairs edited since the last build or update.
+    uint32_t *edited;
+    uint32_t edited_count;
+    uint32_t edited_capacity;
+} MarkdocFenceIndex;
+
+// Indexes the fences under `node` with a walk that enters only block
+// containers and fences' code, never paragraphs. Every fence is marked
+// changed. Returns false when out of memory or when the tree's language is
+// not the build symbols.h describes.
+bool markdoc_fence_index_build(TSNode node, MarkdocFenceIndex *index);
+
+// Shifts the index's ranges for an edit, as ts_tree_edit() does for a tree.
+// Call it with each edit applied to the old tree.
+void markdoc_fence_index_edit(MarkdocFenceIndex *index, const TSInputEdit *edit);
+
+// Brings the index up to date with `node`, the root of the tree reparsed
+// from the edited one, given the ranges that ts_tree_get_changed_ranges()
+// reported between them. Subtrees outside those ranges and outside every
+// edit keep their fences without being walked; the others are walked again
+// and their fences marked changed, so only those need highlighting again.
+// Returns false when out of memory or for another language build, leaving
+// the index as it was.
+bool markdoc_fence_index_update(MarkdocFenceIndex *index, TSNode node, const TSRange *changed,
+                                uint32_t changed_count);
+
+void markdoc_fence_index_delete(MarkdocFenceIndex *index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_FENCES_H_
@@ -0,0 +1,44 @@
+#ifndef TREE_SITTER_MARKDOC_FILE_H_
+#define TREE_SITTER_MARKDOC_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A read-only memory mapping of a source file. `data` stays valid until
+// markdoc_unmap_file() is called, so node byte ranges can be sliced from it
+// directly.
+typedef struct {
+    const char *data;
+    uint32_t length;
+    void *handle;
+} MarkdocMappedFile;
+
+// Maps the file at `path`. Returns false and sets errno on failure; files
+// larger than 4 GiB are rejected with EFBIG since tree-sitter offsets are
+// 32-bit. Empty files map to a zero-length, non-NULL `data`.
+bool markdoc_map_file(const char *path, MarkdocMappedFile *file);
+
+void markdoc_unmap_file(MarkdocMappedFile *file);
+
+// Parses the file at `path` without copying it: the parser reads straight
+// from a memory mapping through a TSInput callback.
+//
+// When `mapping` is non-NULL it receives the mapping, which the caller must
+// release with markdoc_unmap_file() after it is done with the tree's text
+// (it is left empty on failure); otherwise the file is unmapped before
+// returning. Returns NULL if the file
+// cannot be mapped (errno is set) or the parser has no language.
+TSTree *markdoc_parse_file(TSParser *parser, const TSTree *old_tree,
+                           const char *path, MarkdocMappedFile *mapping);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_FILE_H_
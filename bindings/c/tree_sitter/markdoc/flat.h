@@ -0,0 +1,46 @@
+#ifndef TREE_SITTER_MARKDOC_FLAT_H_
+#define TREE_SITTER_MARKDOC_FLAT_H_
+
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Marks a missing parent, child or sibling in a MarkdocFlatTree.
+#define MARKDOC_FLAT_NONE UINT32_MAX
+
+// A tree as parallel arrays with one entry per node, named and anonymous, in
+// pre-order: node 0 is the root and every subtree occupies a contiguous run
+// of indices. Scanning it needs no TSNode calls and no cursor, and the
+// arrays can be handed to other languages as they are.
+//
+// All arrays live in one allocation, released by markdoc_flat_tree_delete().
+typedef struct {
+    uint32_t node_count;
+    uint32_t *start_bytes;
+    uint32_t *end_bytes;
+    uint32_t *parents;
+    uint32_t *first_children;
+    uint32_t *next_siblings;
+    // ts_node_symbol(), so aliased nodes carry their alias; pass it to
+    // ts_language_symbol_name() or ts_language_symbol_type() for the name or
+    // whether the node is named.
+    TSSymbol *symbols;
+    // The field under which the node is its parent's child, or 0.
+    TSFieldId *field_ids;
+} MarkdocFlatTree;
+
+// Flattens the subtree rooted at `node` with a single cursor walk. Returns
+// false when out of memory.
+bool markdoc_flat_tree_export(TSNode node, MarkdocFlatTree *flat);
+
+void markdoc_flat_tree_delete(MarkdocFlatTree *flat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_FLAT_H_
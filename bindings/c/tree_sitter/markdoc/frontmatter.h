@@ -0,0 +1,59 @@
+#ifndef TREE_SITTER_MARKDOC_FRONTMATTER_H_
+#define TREE_SITTER_MARKDOC_FRONTMATTER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Where a document's frontmatter is, as the tree's `frontmatter` and `yaml`
+// nodes would have it.
+typedef struct {
+    // From the opening `---` to the end of the closing `---` line, without
+    // its line break.
+    uint32_t start_byte;
+    uint32_t end_byte;
+    // The lines between the delimiters, with their line breaks.
+    uint32_t yaml_start_byte;
+    uint32_t yaml_end_byte;
+} MarkdocFrontmatter;
+
+// Finds the frontmatter of `source` without a parser, with the external
+// scanner's rules: a `---` line at byte 0, then lines up to the first `---`
+// line (trailing spaces and tabs allowed on both). The grammar's `yaml`
+// needs at least one line, so a document whose first `---` is closed by the
+// next line has none, as has one whose opening `---` is never closed.
+// Returns false when there is none.
+bool markdoc_frontmatter_find(const char *source, uint32_t length,
+                              MarkdocFrontmatter *frontmatter);
+
+// The start of a file read by markdoc_frontmatter_read_fd().
+typedef struct {
+    // What was read, NUL-terminated: the frontmatter and the rest of the
+    // last read, or the start of a file without frontmatter.
+    char *data;
+    uint32_t length;
+    bool found;
+    // Valid when `found`; offsets are the same in `data` and in the file.
+    MarkdocFrontmatter frontmatter;
+} MarkdocFrontmatterFile;
+
+// Reads `fd` from its current position only until the closing `---` line,
+// or until the first line shows there is no frontmatter, so that metadata
+// can be taken from many files without reading or parsing their bodies.
+// Returns false and sets errno on read errors, out of memory, or
+// frontmatter longer than 4 GiB (EFBIG); `file` is left empty then.
+bool markdoc_frontmatter_read_fd(int fd, MarkdocFrontmatterFile *file);
+
+// Opens `path` and reads it as markdoc_frontmatter_read_fd() does.
+bool markdoc_frontmatter_read_file(const char *path, MarkdocFrontmatterFile *file);
+
+void markdoc_frontmatter_file_delete(MarkdocFrontmatterFile *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_FRONTMATTER_H_
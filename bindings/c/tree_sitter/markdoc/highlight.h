@@ -0,0 +1,76 @@
+#ifndef TREE_SITTER_MARKDOC_HIGHLIGHT_H_
+#define TREE_SITTER_MARKDOC_HIGHLIGHT_H_
+
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Syntax highlighting from queries/highlights.scm without running most of
+// it through the query engine. Patterns that only name a node type and
+// capture it, such as `(tag_name) @tag` or `("/" @punctuation.delimiter)`,
+// are compiled into a table indexed by symbol and applied during a single
+// cursor walk. The remaining structural patterns still run through a
+// TSQueryCursor, and each node takes the capture of the first pattern in
+// the file that matches it, as `tree-sitter highlight` does. Their `#eq?`,
+// `#not-eq?`, `#any-of?` and `#not-any-of?` predicates are evaluated against
+// the source text; queries using any other predicate, `#match?` included,
+// are refused.
+//
+// A highlighter owns a query cursor, so use one per thread.
+typedef struct MarkdocHighlighter MarkdocHighlighter;
+
+typedef struct {
+    uint32_t start_byte;
+    uint32_t end_byte;
+    // Index into the query's capture names; see
+    // markdoc_highlighter_capture_name().
+    uint32_t capture;
+} MarkdocHighlight;
+
+// Highlighted nodes in pre-order, so a span is followed by the spans nested
+// inside it.
+typedef struct {
+    MarkdocHighlight *spans;
+    uint32_t count;
+} MarkdocHighlights;
+
+// Compiles `source`, the text of a highlights query. Returns NULL when the
+// query does not compile, with the query's error in `error_offset` and
+// `error_type`; when a pattern uses a predicate the highlighter cannot
+// evaluate, with TSQueryErrorSyntax at the pattern's start; or when out of
+// memory, with TSQueryErrorNone.
+MarkdocHighlighter *markdoc_highlighter_new(const TSLanguage *language, const char *source,
+                                            uint32_t length, uint32_t *error_offset,
+                                            TSQueryError *error_type);
+
+void markdoc_highlighter_delete(MarkdocHighlighter *highlighter);
+
+uint32_t markdoc_highlighter_capture_count(const MarkdocHighlighter *highlighter);
+
+// The capture's name without the `@`, e.g. "markup.heading.marker". Not
+// NUL-terminated; its length is stored in `length`.
+const char *markdoc_highlighter_capture_name(const MarkdocHighlighter *highlighter,
+                                             uint32_t capture, uint32_t *length);
+
+// How many of the query's patterns are served by the symbol table; the rest
+// run through the query engine.
+uint32_t markdoc_highlighter_native_pattern_count(const MarkdocHighlighter *highlighter);
+
+// Highlights the nodes under `node` that intersect [start_byte, end_byte),
+// e.g. the visible part of an editor buffer; pass 0 and UINT32_MAX for all
+// of them. `source` is the text the tree was parsed from, which predicates
+// are evaluated against. Returns false when out of memory.
+bool markdoc_highlight(MarkdocHighlighter *highlighter, TSNode node, const char *source,
+                       uint32_t start_byte, uint32_t end_byte, MarkdocHighlights *highlights);
+
+void markdoc_highlights_delete(MarkdocHighlights *highlights);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_HIGHLIGHT_H_
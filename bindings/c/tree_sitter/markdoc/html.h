@@ -0,0 +1,76 @@
+#ifndef TREE_SITTER_MARKDOC_HTML_H_
+#define TREE_SITTER_MARKDOC_HTML_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#include "tree_sitter/markdoc/writer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Renders a tree to HTML in one walk, streaming into a MarkdocWriter.
+// Markdown renders the way markdown-it does by default: headings,
+// paragraphs, tight and loose lists, blockquotes, `<hr>`, `<pre><code
+// class="language-js">` for fences, links, images, emphasis and code spans.
+// The grammar reads a blockquote as one token, so its lines render as
+// paragraphs of plain text, without their own markdown.
+// Raw HTML blocks, inline HTML and comments pass through unchanged.
+// `{% comment %}` blocks and frontmatter are dropped.
+//
+// Markdoc tags render through handlers looked up by tag name. A tag without
+// a handler renders its children only.
+typedef struct MarkdocHtmlRenderer MarkdocHtmlRenderer;
+
+typedef struct {
+    // The markdoc_tag, or the tag_self_close of an inline tag.
+    TSNode node;
+    const char *source;
+    const char *name;
+    uint32_t name_length;
+    bool is_inline;
+} MarkdocHtmlTag;
+
+typedef struct {
+    // The tag name this handler renders, NUL-terminated.
+    const char *name;
+    // Called with `entering` true before the tag's children and false after
+    // them. Returning false when entering skips the children and the second
+    // call.
+    bool (*render)(void *payload, MarkdocHtmlRenderer *html, const MarkdocHtmlTag *tag,
+                   bool entering);
+    void *payload;
+} MarkdocHtmlTagHandler;
+
+typedef struct {
+    const MarkdocHtmlTagHandler *tags;
+    uint32_t tag_count;
+    // Renders `{% $var %}` and `{% fn() %}` in text, given the
+    // inline_expression node. They render nothing when NULL.
+    void (*expression)(void *payload, MarkdocHtmlRenderer *html, TSNode node);
+    void *expression_payload;
+} MarkdocHtmlOptions;
+
+// Renders the source_file `node`. `options` may be NULL. Returns false when
+// a write fails.
+bool markdoc_render_html(TSNode node, const char *source, const MarkdocHtmlOptions *options,
+                         MarkdocWriter writer);
+
+// For handlers: write markup as it is, or text with `&<>"` escaped.
+void markdoc_html_write(MarkdocHtmlRenderer *html, const char *data, size_t length);
+void markdoc_html_write_escaped(MarkdocHtmlRenderer *html, const char *data, size_t length);
+
+// Finds the attribute `name` of `tag` and stores its value's source text in
+// `value`, without the quotes of a string. Escapes are left as written.
+bool markdoc_html_tag_attribute(const MarkdocHtmlTag *tag, const char *name, const char **value,
+                                uint32_t *length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_HTML_H_
@@ -0,0 +1,106 @@
+#ifndef TREE_SITTER_MARKDOC_LINKS_H_
+#define TREE_SITTER_MARKDOC_LINKS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    // `[text](destination)`, also inside headings, emphasis and blockquotes.
+    MARKDOC_LINK,
+    // `![alt](destination)`
+    MARKDOC_LINK_IMAGE,
+    // A tag attribute whose name is, or ends in, `href`, `src` or `url`
+    // (ignoring case, so `imageSrc` and `data-href` count), with a string
+    // value.
+    MARKDOC_LINK_ATTRIBUTE,
+} MarkdocLinkKind;
+
+// Returned by markdoc_link_index_find() for a destination no link has.
+#define MARKDOC_LINK_NO_DESTINATION UINT32_MAX
+
+typedef struct {
+    MarkdocLinkKind kind;
+    // The link, image or attribute.
+    uint32_t start_byte;
+    uint32_t end_byte;
+    // The link_text, the image_alt, or the attribute_name.
+    uint32_t text_start;
+    uint32_t text_end;
+    // The destination as written: the link_destination or image_destination
+    // up to any title, or the string inside its quotes.
+    uint32_t destination_start;
+    uint32_t destination_end;
+    // The destination's id in the index's `destinations`.
+    uint32_t destination;
+    // Whether the last build or update read this link from the tree, as
+    // opposed to keeping it from before.
+    bool changed;
+} MarkdocLink;
+
+// The links of a document in order of their start, and the distinct
+// destinations they point to. The fields after `renumbered` belong to the
+// index.
+typedef struct {
+    MarkdocLink *links;
+    uint32_t count;
+    // Destination `id` is the NUL-terminated string at
+    // `destinations + destination_offsets[id]`. A destination no longer
+    // linked to keeps its id, and ids stay the same across updates until
+    // more than half of the destinations are unused. The update then drops
+    // those and renumbers the rest.
+    char *destinations;
+    uint32_t *destination_offsets;
+    uint32_t destination_count;
+    // Whether the last update renumbered the destinations. The links carry
+    // the new ids, but ids a caller kept from before no longer apply.
+    bool renumbered;
+    uint32_t capacity;
+    uint32_t destinations_length;
+    uint32_t destinations_capacity;
+    uint32_t destination_capacity;
+    uint32_t *slots;
+    uint32_t slot_capacity;
+    // [start, end) byte pairs edited since the last build or update.
+    uint32_t *edited;
+    uint32_t edited_count;
+    uint32_t edited_capacity;
+} MarkdocLinkIndex;
+
+// Indexes the links, images and link attributes under `node` in one walk
+// that steps over code, raw HTML and frontmatter. `source` is the
+// text the tree was parsed from. Every link is marked changed. Returns
+// false when out of memory or when the tree's language is not the build
+// symbols.h describes.
+bool markdoc_link_index_build(TSNode node, const char *source, MarkdocLinkIndex *index);
+
+// Shifts the index's ranges for an edit, as ts_tree_edit() does for a tree.
+// Call it with each edit applied to the old tree.
+void markdoc_link_index_edit(MarkdocLinkIndex *index, const TSInputEdit *edit);
+
+// Brings the index up to date with `node`, the root of the tree reparsed
+// from the edited one, and its `source`, given the ranges that
+// ts_tree_get_changed_ranges() reported between them. Subtrees outside
+// those ranges and outside every edit keep their links without being
+// walked; the others are walked again and their links marked changed, so a
+// link checker only needs to look at those. Returns false when out of
+// memory or for another language build, leaving the links as they were.
+bool markdoc_link_index_update(MarkdocLinkIndex *index, TSNode node, const char *source,
+                               const TSRange *changed, uint32_t changed_count);
+
+// The id of a destination, or MARKDOC_LINK_NO_DESTINATION.
+uint32_t markdoc_link_index_find(const MarkdocLinkIndex *index, const char *destination,
+                                 uint32_t length);
+
+void markdoc_link_index_delete(MarkdocLinkIndex *index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_LINKS_H_
@@ -0,0 +1,228 @@
+#ifndef TREE_SITTER_MARKDOC_MARKDOC_HPP_
+#define TREE_SITTER_MARKDOC_MARKDOC_HPP_
+
+// Header-only C++17 wrappers over the tree-sitter C API: owning Parser, Tree
+// and Cursor types, node text as std::string_view over the caller's source,
+// and visit<Kinds...>(), which walks a tree with one cursor and dispatches on
+// symbol IDs resolved at compile time.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <tree_sitter/api.h>
+
+#include "tree_sitter/markdoc/symbols.h"
+
+namespace markdoc {
+
+class Tree {
+  public:
+    Tree() noexcept = default;
+    // `tree` must come from a parser whose language matches symbols.h, as
+    // Parser ensures; visit() dispatches on those IDs without checking.
+    explicit Tree(TSTree *tree) noexcept : tree_(tree) {}
+    Tree(Tree &&other) noexcept : tree_(std::exchange(other.tree_, nullptr)) {}
+    Tree &operator=(Tree &&other) noexcept {
+        if (this != &other) {
+            ts_tree_delete(tree_);
+            tree_ = std::exchange(other.tree_, nullptr);
+        }
+        return *this;
+    }
+    Tree(const Tree &) = delete;
+    Tree &operator=(const Tree &) = delete;
+    ~Tree() { ts_tree_delete(tree_); }
+
+    TSTree *get() const noexcept { return tree_; }
+    explicit operator bool() const noexcept { return tree_ != nullptr; }
+    TSNode root() const noexcept { return ts_tree_root_node(tree_); }
+
+  private:
+    TSTree *tree_ = nullptr;
+};
+
+class Parser {
+  public:
+    // Throws std::invalid_argument unless markdoc_symbols_match(language) and
+    // the runtime accepts the language's ABI version.
+    explicit Parser(const TSLanguage *language) {
+        if (!markdoc_symbols_match(language)) {
+            throw std::invalid_argument("markdoc::Parser: language does not match symbols.h");
+        }
+        parser_ = ts_parser_new();
+        if (!ts_parser_set_language(parser_, language)) {
+            ts_parser_delete(parser_);
+            throw std::invalid_argument("markdoc::Parser: language ABI version not supported");
+        }
+    }
+    Parser(Parser &&other) noexcept : parser_(std::exchange(other.parser_, nullptr)) {}
+    Parser &operator=(Parser &&other) noexcept {
+        if (this != &other) {
+            ts_parser_delete(parser_);
+            parser_ = std::exchange(other.parser_, nullptr);
+        }
+        return *this;
+    }
+    Parser(const Parser &) = delete;
+    Parser &operator=(const Parser &) = delete;
+    ~Parser() { ts_parser_delete(parser_); }
+
+    TSParser *get() const noexcept { return parser_; }
+
+    // The tree refers to `source` only through byte offsets; keep the buffer
+    // alive to slice node text from it.
+    Tree parse(std::string_view source, const Tree *old_tree = nullptr) {
+        return Tree(ts_parser_parse_string(parser_, old_tree ? old_tree->get() : nullptr,
+                                           source.data(), static_cast<uint32_t>(source.size())));
+    }
+
+  private:
+    TSParser *parser_ = nullptr;
+};
+
+// A TSTreeCursor. The runtime allocates the cursor's stack on first use;
+// reset() keeps it, so one Cursor reused across walks allocates only once.
+class Cursor {
+  public:
+    explicit Cursor(TSNode node) noexcept : cursor_(ts_tree_cursor_new(node)) {}
+    Cursor(const Cursor &) = delete;
+    Cursor &operator=(const Cursor &) = delete;
+    ~Cursor() { ts_tree_cursor_delete(&cursor_); }
+
+    TSTreeCursor *get() noexcept { return &cursor_; }
+    void reset(TSNode node) noexcept { ts_tree_cursor_reset(&cursor_, node); }
+
+  private:
+    TSTreeCursor cursor_;
+};
+
+// The node's bytes of `source`, cut to what `source` holds, so a node from a
+// tree parsed over a different or longer text yields an empty or short view.
+inline std::string_view text(TSNode node, std::string_view source) noexcept {
+    size_t start = std::min<size_t>(ts_node_start_byte(node), source.size());
+    size_t end = std::min<size_t>(ts_node_end_byte(node), source.size());
+    return std::string_view(source.data() + start, end > start ? end - start : 0);
+}
+
+// A node kind as a type, for visit() and for overloading handlers on.
+template <TSSymbol S>
+struct Kind {
+    static constexpr TSSymbol symbol = S;
+};
+
+using Frontmatter = Kind<symbol::frontmatter>;
+using Heading = Kind<symbol::heading>;
+using Paragraph = Kind<symbol::paragraph>;
+using Blockquote = Kind<symbol::blockquote>;
+using FencedCodeBlock = Kind<symbol::fenced_code_block>;
+using MarkdocTag = Kind<symbol::markdoc_tag>;
+using TagName = Kind<symbol::tag_name>;
+using Attribute = Kind<symbol::attribute>;
+using Variable = Kind<symbol::variable>;
+using Link = Kind<symbol::link>;
+using Image = Kind<symbol::image>;
+using InlineCode = Kind<symbol::inline_code>;
+using Error = Kind<symbol::error>;
+
+namespace detail {
+
+template <TSSymbol... Symbols>
+constexpr bool distinct() {
+    constexpr TSSymbol symbols[] = {Symbols...};
+    for (std::size_t i = 0; i < sizeof...(Symbols); i++) {
+        for (std::size_t j = i + 1; j < sizeof...(Symbols); j++) {
+            if (symbols[i] == symbols[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Calls the handler; a handler returning bool decides whether to descend.
+template <class K, class Handler>
+bool call(Handler &handler, TSNode node) {
+    if constexpr (std::is_same_v<std::invoke_result_t<Handler &, K, TSNode>, bool>) {
+        return handler(K{}, node);
+    } else {
+        handler(K{}, node);
+        return true;
+    }
+}
+
+// The cursor visit(const Tree &) walks with, one per thread and shared by
+// its calls there. `busy` is set during a walk, so that a handler visiting a
+// tree from inside one gets a cursor of its own.
+struct ThreadCursor {
+    Cursor cursor{TSNode{}};
+    bool busy = false;
+};
+
+inline ThreadCursor &thread_cursor() {
+    thread_local ThreadCursor shared;
+    return shared;
+}
+
+template <class... Kinds, class Handler>
+bool dispatch(Handler &handler, TSNode node) {
+    TSSymbol symbol = ts_node_symbol(node);
+    bool descend = true;
+    (void)((symbol == Kinds::symbol ? (descend = call<Kinds>(handler, node), true) : false) ||
+           ...);
+    return descend;
+}
+
+}  // namespace detail
+
+// Walks the subtree under `node` in pre-order with `cursor` and calls
+// `handler(K{}, node)` for every node whose symbol is one of `Kinds`; nodes
+// of other kinds cost one integer comparison per kind. A handler that
+// returns bool skips the node's children by returning false. Allocates
+// nothing once `cursor` has been used.
+template <class... Kinds, class Handler>
+void visit(Cursor &cursor, TSNode node, Handler &&handler) {
+    static_assert(sizeof...(Kinds) > 0, "visit() needs at least one node kind");
+    static_assert(detail::distinct<Kinds::symbol...>(), "visit() kinds must be distinct");
+
+    cursor.reset(node);
+    TSTreeCursor *walk = cursor.get();
+    for (;;) {
+        TSNode current = ts_tree_cursor_current_node(walk);
+        if (detail::dispatch<Kinds...>(handler, current) &&
+            ts_tree_cursor_goto_first_child(walk)) {
+            continue;
+        }
+        while (!ts_tree_cursor_goto_next_sibling(walk)) {
+            if (!ts_tree_cursor_goto_parent(walk)) {
+                return;
+            }
+        }
+    }
+}
+
+// Walks the whole tree with a cursor kept per thread, so repeated calls
+// allocate nothing once the thread's first walk has.
+template <class... Kinds, class Handler>
+void visit(const Tree &tree, Handler &&handler) {
+    detail::ThreadCursor &shared = detail::thread_cursor();
+    if (shared.busy) {
+        Cursor cursor(tree.root());
+        visit<Kinds...>(cursor, tree.root(), std::forward<Handler>(handler));
+        return;
+    }
+    shared.busy = true;
+    struct Release {
+        bool &busy;
+        ~Release() { busy = false; }
+    } release{shared.busy};
+    visit<Kinds...>(shared.cursor, tree.root(), std::forward<Handler>(handler));
+}
+
+}  // namespace markdoc
+
+#endif // TREE_SITTER_MARKDOC_MARKDOC_HPP_
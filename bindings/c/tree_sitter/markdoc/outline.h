@@ -0,0 +1,60 @@
+#ifndef TREE_SITTER_MARKDOC_OUTLINE_H_
+#define TREE_SITTER_MARKDOC_OUTLINE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    MARKDOC_OUTLINE_HEADING,
+    // A Markdoc tag that is a direct child of the document.
+    MARKDOC_OUTLINE_TAG,
+} MarkdocOutlineKind;
+
+typedef struct {
+    MarkdocOutlineKind kind;
+    // 1 to 6 for headings, 0 for tags.
+    uint8_t level;
+    // The heading's text without trailing whitespace, or the tag's name.
+    uint32_t start_byte;
+    uint32_t end_byte;
+    uint32_t row;
+    // The heading's anchor, at `slugs + slug_offset`; empty for tags.
+    uint32_t slug_offset;
+    uint32_t slug_length;
+} MarkdocOutlineEntry;
+
+typedef struct {
+    MarkdocOutlineEntry *entries;
+    uint32_t count;
+    // Every slug, each followed by a NUL.
+    char *slugs;
+    uint32_t slugs_length;
+} MarkdocOutline;
+
+// Collects the headings and top-level tags under the source_file `node`, in
+// document order, for a table of contents or a sidebar. Only block
+// containers are entered: the document, tag bodies, blockquotes and lists.
+// Paragraphs, fences and other leaf blocks are stepped over without visiting
+// their subtrees.
+//
+// Slugs follow github-slugger, which Markdoc sites commonly use: the text is
+// lowercased, characters other than letters, digits, `-`, `_` and spaces are
+// removed, spaces become `-`, and a repeated slug gets `-1`, `-2`, ...
+// appended. Bytes from 0x80 up are kept as they are. Returns false when out
+// of memory or when the tree's language is not the build symbols.h
+// describes.
+bool markdoc_outline(TSNode node, const char *source, MarkdocOutline *outline);
+
+void markdoc_outline_delete(MarkdocOutline *outline);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_OUTLINE_H_
@@ -0,0 +1,67 @@
+#ifndef TREE_SITTER_MARKDOC_PRESCAN_H_
+#define TREE_SITTER_MARKDOC_PRESCAN_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// What a line is, judged from the line alone with the external scanner's
+// rules. Lines inside code fences or frontmatter are classified like any
+// other; callers track that state themselves.
+enum {
+    MARKDOC_LINE_BLANK = 1 << 0,
+    // Three or more backticks or tildes at column 0. The external scanner
+    // opens and closes fences only at column 0 too, so an indented fence
+    // is paragraph text to the parser and is not flagged.
+    MARKDOC_LINE_FENCE = 1 << 1,
+    // A complete `{% name ... %}` line, as markdoc_scan_tag_line() in
+    // src/scanner.h classifies it for the scanner.
+    MARKDOC_LINE_TAG_OPEN = 1 << 2,
+    MARKDOC_LINE_TAG_CLOSE = 1 << 3,
+    MARKDOC_LINE_TAG_SELF_CLOSE = 1 << 4,
+    // `{% comment %}`, lexed as a single comment_block token.
+    MARKDOC_LINE_COMMENT_OPEN = 1 << 5,
+    // A `---` line: frontmatter delimiter or thematic break.
+    MARKDOC_LINE_DELIMITER = 1 << 6,
+    // Starts with `<!--` after optional indentation.
+    MARKDOC_LINE_HTML_COMMENT = 1 << 7,
+};
+
+// Line `i` spans [line_starts[i], line_starts[i + 1]), including its line
+// break; the last line ends at the end of the input. A trailing line break
+// does not start an empty line.
+typedef struct {
+    uint32_t *line_starts;
+    uint8_t *line_flags;
+    uint32_t line_count;
+} MarkdocLineIndex;
+
+typedef enum {
+    MARKDOC_SIMD_AUTO,
+    MARKDOC_SIMD_SCALAR,
+    MARKDOC_SIMD_SSE2,
+    MARKDOC_SIMD_AVX2,
+} MarkdocSimdLevel;
+
+// Indexes every line of `source` in one sweep, finding line breaks 16 or 32
+// bytes at a time with SSE2 or AVX2 when the CPU has them, and classifying
+// each line as its line break is found. Returns false when
+// out of memory, or when `level` names an instruction set that this build or
+// CPU lacks.
+bool markdoc_prescan(const char *source, uint32_t length, MarkdocLineIndex *index);
+bool markdoc_prescan_with_level(const char *source, uint32_t length, MarkdocLineIndex *index,
+                                MarkdocSimdLevel level);
+
+// The instruction set markdoc_prescan() uses on this machine.
+MarkdocSimdLevel markdoc_prescan_level(void);
+
+void markdoc_line_index_delete(MarkdocLineIndex *index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_PRESCAN_H_
@@ -0,0 +1,94 @@
+#ifndef TREE_SITTER_MARKDOC_REFERENCES_H_
+#define TREE_SITTER_MARKDOC_REFERENCES_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    // `$name`, with any `.field` and `[subscript]` after it.
+    MARKDOC_REFERENCE_VARIABLE,
+    // `@name`, likewise.
+    MARKDOC_REFERENCE_SPECIAL,
+    // The function name of a call_expression.
+    MARKDOC_REFERENCE_FUNCTION,
+} MarkdocReferenceKind;
+
+// A path element with this bit set is an array index, `[0]`, in its low
+// bits. Without it the element is a name id: an identifier, or the contents
+// of a string subscript such as `["key"]`.
+#define MARKDOC_REFERENCE_INDEX 0x80000000u
+
+// The largest index a path element holds.
+#define MARKDOC_REFERENCE_MAX_INDEX 0x7ffffffeu
+
+// The path element of a number subscript that is no array index: negative,
+// with a fraction, or past MARKDOC_REFERENCE_MAX_INDEX, e.g. `[-1]` or
+// `[1.5]`.
+#define MARKDOC_REFERENCE_UNKNOWN_INDEX 0xffffffffu
+
+// Returned by markdoc_references_find() for a name the document never uses.
+#define MARKDOC_REFERENCE_NO_NAME UINT32_MAX
+
+typedef struct {
+    MarkdocReferenceKind kind;
+    // The reference as written, e.g. `$user.name[0]`, or the function name
+    // alone.
+    uint32_t start_byte;
+    uint32_t end_byte;
+    TSPoint start_point;
+    // The elements at `path + path_offset`: the variable's name and each
+    // field and subscript after it, or the function's name alone.
+    uint32_t path_offset;
+    uint32_t path_length;
+    // Whether it is in a tag attribute value rather than a `{% ... %}`
+    // expression in text.
+    bool in_attribute;
+} MarkdocReference;
+
+// Every reference in a document, in order of their start. The fields after
+// `name_count` belong to the index.
+typedef struct {
+    MarkdocReference *references;
+    uint32_t count;
+    uint32_t *path;
+    uint32_t path_length;
+    // Each distinct name once, NUL-terminated, at `names + name_offsets[id]`.
+    char *names;
+    uint32_t *name_offsets;
+    uint32_t name_count;
+    uint32_t capacity;
+    uint32_t path_capacity;
+    uint32_t names_length;
+    uint32_t names_capacity;
+    uint32_t name_capacity;
+    // An open-addressing table of name ids plus one.
+    uint32_t *slots;
+    uint32_t slot_capacity;
+} MarkdocReferences;
+
+// Collects the variable, special variable and function references in the
+// inline expressions and tag attribute values under `node`, in one walk
+// that steps over fences, headings, raw HTML and other nodes that cannot
+// hold expressions. `source` is the text the tree was parsed from. Returns
+// false when out of memory or when the tree's language is not the build
+// symbols.h describes.
+bool markdoc_references_collect(TSNode node, const char *source, MarkdocReferences *references);
+
+// The id of `name`, or MARKDOC_REFERENCE_NO_NAME, so that a schema's names
+// can be compared as ids.
+uint32_t markdoc_references_find(const MarkdocReferences *references, const char *name,
+                                 uint32_t length);
+
+void markdoc_references_delete(MarkdocReferences *references);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_REFERENCES_H_
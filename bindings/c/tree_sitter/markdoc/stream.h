@@ -0,0 +1,38 @@
+#ifndef TREE_SITTER_MARKDOC_STREAM_H_
+#define TREE_SITTER_MARKDOC_STREAM_H_
+
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sizing of the input ring used by markdoc_parse_fd(). Zero fields take the
+// defaults (64 KiB chunks, 16 chunks).
+typedef struct {
+    uint32_t chunk_size;
+    uint32_t chunk_count;
+} MarkdocStreamOptions;
+
+// Parses a document read sequentially from `fd` (a file, pipe or socket)
+// until end of input, buffering at most chunk_size * chunk_count bytes of it.
+//
+// The parser mostly reads forward but re-reads from the start of the current
+// token after a lookahead; a request for bytes already evicted from the ring
+// aborts the parse with ENOBUFS, so the ring must hold the longest token
+// (e.g. a fenced code line or an HTML block). The lexer reads a
+// `{% comment %}` block through to the end of input before it settles on
+// the block's last `{% /comment %}`, so a document with a comment block
+// must fit in the ring as a whole. A UTF-8 character split between two
+// chunks is copied out and handed to the lexer whole. Returns NULL and sets errno on
+// read errors, ENOBUFS, or input longer than 4 GiB (EFBIG). The source is not
+// retained: callers needing node text must keep their own copy.
+TSTree *markdoc_parse_fd(TSParser *parser, int fd, const MarkdocStreamOptions *options);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_STREAM_H_
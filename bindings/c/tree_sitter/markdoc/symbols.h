@@ -0,0 +1,275 @@
+// Generated by bindings/c/generate_symbols.py from src/parser.c. Do not edit.
+//
+// Symbol and field IDs for switching on ts_node_symbol() and
+// ts_tree_cursor_current_field_id() instead of comparing type names.
+//
+// The IDs are stable for a given src/parser.c. tree-sitter numbers
+// symbols itself, so `tree-sitter generate` may renumber them, and this
+// header is regenerated in the same commit, as it is with any change to
+// the external scanner. The symbols-header-current test fails until it
+// is. Every entry point of the native API checks markdoc_symbols_match()
+// and refuses a language whose names and IDs differ from the ones below.
+
+#ifndef TREE_SITTER_MARKDOC_SYMBOLS_H_
+#define TREE_SITTER_MARKDOC_SYMBOLS_H_
+
+#include <tree_sitter/api.h>
+
+#define MARKDOC_SYMBOLS_LANGUAGE_VERSION 15
+#define MARKDOC_SYMBOLS_SYMBOL_COUNT 154
+#define MARKDOC_SYMBOLS_FIELD_COUNT 12
+#define MARKDOC_SYMBOLS_FINGERPRINT 0x980D6060700A509Eull
+
+// FNV-1a of src/parser.c, src/scanner.c and src/scanner.h. It changes with
+// the parse and lex tables and with the external scanner, so anything
+// keyed by it, like the parse cache, misses once either changes.
+#define MARKDOC_SYMBOLS_GRAMMAR_HASH 0x03C7D2342CC9AE78ull
+
+enum {
+    MARKDOC_SYM_HEADING_MARKER = 2,  // heading_marker
+    MARKDOC_SYM_HEADING_TEXT = 3,  // heading_text
+    MARKDOC_SYM_BLOCKQUOTE = 4,  // blockquote
+    MARKDOC_SYM_LANGUAGE = 5,  // language
+    MARKDOC_SYM_ATTRIBUTES = 7,  // attributes
+    MARKDOC_SYM_COMMENT_BLOCK = 8,  // comment_block
+    MARKDOC_ANON_SLASH = 9,  // "/"
+    MARKDOC_SYM_TAG_OPEN_DELIMITER = 10,  // tag_open_delimiter
+    MARKDOC_SYM_TAG_BLOCK_CLOSE = 11,  // tag_block_close
+    MARKDOC_SYM_INLINE_EXPRESSION_CLOSE = 12,  // inline_expression_close
+    MARKDOC_SYM_TAG_SELF_CLOSE_DELIMITER = 13,  // tag_self_close_delimiter
+    MARKDOC_SYM_ATTRIBUTE_NAME = 14,  // attribute_name
+    MARKDOC_ANON_EQ = 15,  // "="
+    MARKDOC_ANON_DOLLAR = 16,  // "$"
+    MARKDOC_ANON_AT = 17,  // "@"
+    MARKDOC_ANON_DOT = 18,  // "."
+    MARKDOC_ANON_LBRACK = 19,  // "["
+    MARKDOC_ANON_RBRACK = 20,  // "]"
+    MARKDOC_ANON_LPAREN = 21,  // "("
+    MARKDOC_ANON_COMMA = 22,  // ","
+    MARKDOC_ANON_RPAREN = 23,  // ")"
+    MARKDOC_ANON_TRUE = 24,  // "true"
+    MARKDOC_ANON_FALSE = 25,  // "false"
+    MARKDOC_SYM_NULL = 26,  // null
+    MARKDOC_ANON_LBRACE = 27,  // "{"
+    MARKDOC_ANON_RBRACE = 28,  // "}"
+    MARKDOC_ANON_COLON = 29,  // ":"
+    MARKDOC_SYM_IDENTIFIER = 30,  // identifier
+    MARKDOC_ANON_DQUOTE = 31,  // "\""
+    MARKDOC_ANON_BSLASH = 33,  // "\\"
+    MARKDOC_ANON_SQUOTE = 35,  // "'"
+    MARKDOC_SYM_NUMBER = 37,  // number
+    MARKDOC_ANON_BQUOTE = 48,  // "`"
+    MARKDOC_SYM_LINK_TEXT = 50,  // link_text
+    MARKDOC_SYM_LINK_DESTINATION = 51,  // link_destination
+    MARKDOC_ANON_BANG_LBRACK = 52,  // "!["
+    MARKDOC_SYM_TEXT = 53,  // text
+    MARKDOC_SYM_UNORDERED_LIST_MARKER = 62,  // unordered_list_marker
+    MARKDOC_SYM_ORDERED_LIST_MARKER = 63,  // ordered_list_marker
+    MARKDOC_SYM_SOURCE_FILE = 70,  // source_file
+    MARKDOC_SYM_FRONTMATTER = 72,  // frontmatter
+    MARKDOC_SYM_YAML = 73,  // yaml
+    MARKDOC_SYM_HEADING = 74,  // heading
+    MARKDOC_SYM_THEMATIC_BREAK = 75,  // thematic_break
+    MARKDOC_SYM_FENCED_CODE_BLOCK = 76,  // fenced_code_block
+    MARKDOC_SYM_CODE_FENCE_OPEN = 77,  // code_fence_open
+    MARKDOC_SYM_INFO_STRING = 78,  // info_string
+    MARKDOC_SYM_CODE = 79,  // code
+    MARKDOC_SYM_CODE_FENCE_CLOSE = 81,  // code_fence_close
+    MARKDOC_SYM_MARKDOC_TAG = 82,  // markdoc_tag
+    MARKDOC_SYM_TAG_OPEN = 83,  // tag_open
+    MARKDOC_SYM_TAG_CLOSE = 84,  // tag_close
+    MARKDOC_SYM_INLINE_TAG = 85,  // inline_tag
+    MARKDOC_SYM_TAG_SELF_CLOSE = 86,  // tag_self_close
+    MARKDOC_SYM_ATTRIBUTE = 87,  // attribute
+    MARKDOC_SYM_ATTRIBUTE_VALUE = 88,  // attribute_value
+    MARKDOC_SYM_VALUE_EXPRESSION = 89,  // value_expression
+    MARKDOC_SYM_JSON_VALUE = 90,  // json_value
+    MARKDOC_SYM_VARIABLE = 91,  // variable
+    MARKDOC_SYM_SPECIAL_VARIABLE = 92,  // special_variable
+    MARKDOC_SYM_VARIABLE_REFERENCE = 93,  // variable_reference
+    MARKDOC_SYM_SPECIAL_VARIABLE_REFERENCE = 94,  // special_variable_reference
+    MARKDOC_SYM_ARRAY_SUBSCRIPT = 95,  // array_subscript
+    MARKDOC_SYM_SUBSCRIPT_REFERENCE = 96,  // subscript_reference
+    MARKDOC_SYM_VARIABLE_VALUE = 97,  // variable_value
+    MARKDOC_SYM_CALL_EXPRESSION = 98,  // call_expression
+    MARKDOC_SYM_BOOLEAN = 99,  // boolean
+    MARKDOC_SYM_ARRAY_LITERAL = 100,  // array_literal
+    MARKDOC_SYM_OBJECT_LITERAL = 101,  // object_literal
+    MARKDOC_SYM_PAIR = 102,  // pair
+    MARKDOC_SYM_STRING = 103,  // string
+    MARKDOC_SYM_INLINE_EXPRESSION = 104,  // inline_expression
+    MARKDOC_SYM_UNORDERED_LIST = 105,  // unordered_list
+    MARKDOC_SYM_UNORDERED_LIST_ITEM = 106,  // unordered_list_item
+    MARKDOC_SYM_ORDERED_LIST = 107,  // ordered_list
+    MARKDOC_SYM_ORDERED_LIST_ITEM = 108,  // ordered_list_item
+    MARKDOC_SYM_LIST_ITEM_CONTINUATION = 113,  // list_item_continuation
+    MARKDOC_SYM_HTML_COMMENT = 114,  // html_comment
+    MARKDOC_SYM_HTML_BLOCK = 115,  // html_block
+    MARKDOC_SYM_HTML_INLINE = 116,  // html_inline
+    MARKDOC_SYM_PARAGRAPH = 117,  // paragraph
+    MARKDOC_SYM_LIST_PARAGRAPH = 118,  // list_paragraph
+    MARKDOC_SYM_EMPHASIS = 119,  // emphasis
+    MARKDOC_SYM_STRONG = 120,  // strong
+    MARKDOC_SYM_INLINE_CODE = 121,  // inline_code
+    MARKDOC_SYM_LINK = 122,  // link
+    MARKDOC_SYM_IMAGE = 123,  // image
+    MARKDOC_SYM_IMAGE_ALT = 151,  // image_alt
+    MARKDOC_SYM_IMAGE_DESTINATION = 152,  // image_destination
+    MARKDOC_SYM_TAG_NAME = 153,  // tag_name
+    MARKDOC_SYM_ERROR = 65535,
+};
+
+enum {
+    MARKDOC_FIELD_BLOCK = 1,
+    MARKDOC_FIELD_CLOSE = 2,
+    MARKDOC_FIELD_CODE = 3,
+    MARKDOC_FIELD_CONTENT = 4,
+    MARKDOC_FIELD_FUNCTION = 5,
+    MARKDOC_FIELD_HEADING_MARKER = 6,
+    MARKDOC_FIELD_HEADING_TEXT = 7,
+    MARKDOC_FIELD_ITEMS = 8,
+    MARKDOC_FIELD_KEY = 9,
+    MARKDOC_FIELD_MARKER = 10,
+    MARKDOC_FIELD_OPEN = 11,
+    MARKDOC_FIELD_VALUE = 12,
+};
+
+// Whether `language` has exactly the symbol and field names, at exactly
+// the IDs, of the parser.c this header was generated from. It hashes
+// every name, which costs about as much as a few hundred strcmp() calls.
+static inline bool markdoc_symbols_match(const TSLanguage *language) {
+    if (language == NULL ||
+        ts_language_symbol_count(language) != MARKDOC_SYMBOLS_SYMBOL_COUNT ||
+        ts_language_field_count(language) != MARKDOC_SYMBOLS_FIELD_COUNT) {
+        return false;
+    }
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (uint32_t i = 0; i < MARKDOC_SYMBOLS_SYMBOL_COUNT + MARKDOC_SYMBOLS_FIELD_COUNT; i++) {
+        const char *name = i < MARKDOC_SYMBOLS_SYMBOL_COUNT
+                               ? ts_language_symbol_name(language, (TSSymbol)i)
+                               : ts_language_field_name_for_id(
+                                     language, (TSFieldId)(i - MARKDOC_SYMBOLS_SYMBOL_COUNT + 1));
+        if (name == NULL) {
+            return false;
+        }
+        do {
+            hash = (hash ^ (unsigned char)*name) * 0x100000001B3ull;
+        } while (*name++ != '\0');
+    }
+    return hash == MARKDOC_SYMBOLS_FINGERPRINT;
+}
+
+#ifdef __cplusplus
+namespace markdoc {
+namespace symbol {
+constexpr TSSymbol heading_marker = MARKDOC_SYM_HEADING_MARKER;
+constexpr TSSymbol heading_text = MARKDOC_SYM_HEADING_TEXT;
+constexpr TSSymbol blockquote = MARKDOC_SYM_BLOCKQUOTE;
+constexpr TSSymbol language = MARKDOC_SYM_LANGUAGE;
+constexpr TSSymbol attributes = MARKDOC_SYM_ATTRIBUTES;
+constexpr TSSymbol comment_block = MARKDOC_SYM_COMMENT_BLOCK;
+constexpr TSSymbol anon_slash = MARKDOC_ANON_SLASH;
+constexpr TSSymbol tag_open_delimiter = MARKDOC_SYM_TAG_OPEN_DELIMITER;
+constexpr TSSymbol tag_block_close = MARKDOC_SYM_TAG_BLOCK_CLOSE;
+constexpr TSSymbol inline_expression_close = MARKDOC_SYM_INLINE_EXPRESSION_CLOSE;
+constexpr TSSymbol tag_self_close_delimiter = MARKDOC_SYM_TAG_SELF_CLOSE_DELIMITER;
+constexpr TSSymbol attribute_name = MARKDOC_SYM_ATTRIBUTE_NAME;
+constexpr TSSymbol anon_eq = MARKDOC_ANON_EQ;
+constexpr TSSymbol anon_dollar = MARKDOC_ANON_DOLLAR;
+constexpr TSSymbol anon_at = MARKDOC_ANON_AT;
+constexpr TSSymbol anon_dot = MARKDOC_ANON_DOT;
+constexpr TSSymbol anon_lbrack = MARKDOC_ANON_LBRACK;
+constexpr TSSymbol anon_rbrack = MARKDOC_ANON_RBRACK;
+constexpr TSSymbol anon_lparen = MARKDOC_ANON_LPAREN;
+constexpr TSSymbol anon_comma = MARKDOC_ANON_COMMA;
+constexpr TSSymbol anon_rparen = MARKDOC_ANON_RPAREN;
+constexpr TSSymbol anon_true = MARKDOC_ANON_TRUE;
+constexpr TSSymbol anon_false = MARKDOC_ANON_FALSE;
+constexpr TSSymbol null_ = MARKDOC_SYM_NULL;
+constexpr TSSymbol anon_lbrace = MARKDOC_ANON_LBRACE;
+constexpr TSSymbol anon_rbrace = MARKDOC_ANON_RBRACE;
+constexpr TSSymbol anon_colon = MARKDOC_ANON_COLON;
+constexpr TSSymbol identifier = MARKDOC_SYM_IDENTIFIER;
+constexpr TSSymbol anon_dquote = MARKDOC_ANON_DQUOTE;
+constexpr TSSymbol anon_bslash = MARKDOC_ANON_BSLASH;
+constexpr TSSymbol anon_squote = MARKDOC_ANON_SQUOTE;
+constexpr TSSymbol number = MARKDOC_SYM_NUMBER;
+constexpr TSSymbol anon_bquote = MARKDOC_ANON_BQUOTE;
+constexpr TSSymbol link_text = MARKDOC_SYM_LINK_TEXT;
+constexpr TSSymbol link_destination = MARKDOC_SYM_LINK_DESTINATION;
+constexpr TSSymbol anon_bang_lbrack = MARKDOC_ANON_BANG_LBRACK;
+constexpr TSSymbol text = MARKDOC_SYM_TEXT;
+constexpr TSSymbol unordered_list_marker = MARKDOC_SYM_UNORDERED_LIST_MARKER;
+constexpr TSSymbol ordered_list_marker = MARKDOC_SYM_ORDERED_LIST_MARKER;
+constexpr TSSymbol source_file = MARKDOC_SYM_SOURCE_FILE;
+constexpr TSSymbol frontmatter = MARKDOC_SYM_FRONTMATTER;
+constexpr TSSymbol yaml = MARKDOC_SYM_YAML;
+constexpr TSSymbol heading = MARKDOC_SYM_HEADING;
+constexpr TSSymbol thematic_break = MARKDOC_SYM_THEMATIC_BREAK;
+constexpr TSSymbol fenced_code_block = MARKDOC_SYM_FENCED_CODE_BLOCK;
+constexpr TSSymbol code_fence_open = MARKDOC_SYM_CODE_FENCE_OPEN;
+constexpr TSSymbol info_string = MARKDOC_SYM_INFO_STRING;
+constexpr TSSymbol code = MARKDOC_SYM_CODE;
+constexpr TSSymbol code_fence_close = MARKDOC_SYM_CODE_FENCE_CLOSE;
+constexpr TSSymbol markdoc_tag = MARKDOC_SYM_MARKDOC_TAG;
+constexpr TSSymbol tag_open = MARKDOC_SYM_TAG_OPEN;
+constexpr TSSymbol tag_close = MARKDOC_SYM_TAG_CLOSE;
+constexpr TSSymbol inline_tag = MARKDOC_SYM_INLINE_TAG;
+constexpr TSSymbol tag_self_close = MARKDOC_SYM_TAG_SELF_CLOSE;
+constexpr TSSymbol attribute = MARKDOC_SYM_ATTRIBUTE;
+constexpr TSSymbol attribute_value = MARKDOC_SYM_ATTRIBUTE_VALUE;
+constexpr TSSymbol value_expression = MARKDOC_SYM_VALUE_EXPRESSION;
+constexpr TSSymbol json_value = MARKDOC_SYM_JSON_VALUE;
+constexpr TSSymbol variable = MARKDOC_SYM_VARIABLE;
+constexpr TSSymbol special_variable = MARKDOC_SYM_SPECIAL_VARIABLE;
+constexpr TSSymbol variable_reference = MARKDOC_SYM_VARIABLE_REFERENCE;
+constexpr TSSymbol special_variable_reference = MARKDOC_SYM_SPECIAL_VARIABLE_REFERENCE;
+constexpr TSSymbol array_subscript = MARKDOC_SYM_ARRAY_SUBSCRIPT;
+constexpr TSSymbol subscript_reference = MARKDOC_SYM_SUBSCRIPT_REFERENCE;
+constexpr TSSymbol variable_value = MARKDOC_SYM_VARIABLE_VALUE;
+constexpr TSSymbol call_expression = MARKDOC_SYM_CALL_EXPRESSION;
+constexpr TSSymbol boolean = MARKDOC_SYM_BOOLEAN;
+constexpr TSSymbol array_literal = MARKDOC_SYM_ARRAY_LITERAL;
+constexpr TSSymbol object_literal = MARKDOC_SYM_OBJECT_LITERAL;
+constexpr TSSymbol pair = MARKDOC_SYM_PAIR;
+constexpr TSSymbol string = MARKDOC_SYM_STRING;
+constexpr TSSymbol inline_expression = MARKDOC_SYM_INLINE_EXPRESSION;
+constexpr TSSymbol unordered_list = MARKDOC_SYM_UNORDERED_LIST;
+constexpr TSSymbol unordered_list_item = MARKDOC_SYM_UNORDERED_LIST_ITEM;
+constexpr TSSymbol ordered_list = MARKDOC_SYM_ORDERED_LIST;
+constexpr TSSymbol ordered_list_item = MARKDOC_SYM_ORDERED_LIST_ITEM;
+constexpr TSSymbol list_item_continuation = MARKDOC_SYM_LIST_ITEM_CONTINUATION;
+constexpr TSSymbol html_comment = MARKDOC_SYM_HTML_COMMENT;
+constexpr TSSymbol html_block = MARKDOC_SYM_HTML_BLOCK;
+constexpr TSSymbol html_inline = MARKDOC_SYM_HTML_INLINE;
+constexpr TSSymbol paragraph = MARKDOC_SYM_PARAGRAPH;
+constexpr TSSymbol list_paragraph = MARKDOC_SYM_LIST_PARAGRAPH;
+constexpr TSSymbol emphasis = MARKDOC_SYM_EMPHASIS;
+constexpr TSSymbol strong = MARKDOC_SYM_STRONG;
+constexpr TSSymbol inline_code = MARKDOC_SYM_INLINE_CODE;
+constexpr TSSymbol link = MARKDOC_SYM_LINK;
+constexpr TSSymbol image = MARKDOC_SYM_IMAGE;
+constexpr TSSymbol image_alt = MARKDOC_SYM_IMAGE_ALT;
+constexpr TSSymbol image_destination = MARKDOC_SYM_IMAGE_DESTINATION;
+constexpr TSSymbol tag_name = MARKDOC_SYM_TAG_NAME;
+constexpr TSSymbol error = MARKDOC_SYM_ERROR;
+}  // namespace symbol
+
+namespace field {
+constexpr TSFieldId block = MARKDOC_FIELD_BLOCK;
+constexpr TSFieldId close = MARKDOC_FIELD_CLOSE;
+constexpr TSFieldId code = MARKDOC_FIELD_CODE;
+constexpr TSFieldId content = MARKDOC_FIELD_CONTENT;
+constexpr TSFieldId function = MARKDOC_FIELD_FUNCTION;
+constexpr TSFieldId heading_marker = MARKDOC_FIELD_HEADING_MARKER;
+constexpr TSFieldId heading_text = MARKDOC_FIELD_HEADING_TEXT;
+constexpr TSFieldId items = MARKDOC_FIELD_ITEMS;
+constexpr TSFieldId key = MARKDOC_FIELD_KEY;
+constexpr TSFieldId marker = MARKDOC_FIELD_MARKER;
+constexpr TSFieldId open = MARKDOC_FIELD_OPEN;
+constexpr TSFieldId value = MARKDOC_FIELD_VALUE;
+}  // namespace field
+}  // namespace markdoc
+#endif
+
+#endif // TREE_SITTER_MARKDOC_SYMBOLS_H_
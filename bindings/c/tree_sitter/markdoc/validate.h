@@ -0,0 +1,121 @@
+#ifndef TREE_SITTER_MARKDOC_VALIDATE_H_
+#define TREE_SITTER_MARKDOC_VALIDATE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Attribute value types, combined as a mask; 0 accepts any value.
+// Variables and function calls are accepted for every type, as their value
+// is only known when rendering.
+enum {
+    MARKDOC_TYPE_STRING = 1 << 0,
+    MARKDOC_TYPE_NUMBER = 1 << 1,
+    MARKDOC_TYPE_BOOLEAN = 1 << 2,
+    MARKDOC_TYPE_NULL = 1 << 3,
+    MARKDOC_TYPE_ARRAY = 1 << 4,
+    MARKDOC_TYPE_OBJECT = 1 << 5,
+};
+
+typedef struct {
+    const char *name;
+    uint32_t types;
+    bool required;
+} MarkdocAttributeSchema;
+
+typedef enum {
+    MARKDOC_TAG_ANY_FORM,
+    // Only `{% name /%}`.
+    MARKDOC_TAG_SELF_CLOSING,
+    // Only `{% name %}` ... `{% /name %}`.
+    MARKDOC_TAG_WITH_BODY,
+} MarkdocTagForm;
+
+typedef struct {
+    const char *name;
+    const MarkdocAttributeSchema *attributes;
+    uint32_t attribute_count;
+    // Accept attributes that are not listed.
+    bool any_attributes;
+    MarkdocTagForm form;
+    // What the body may hold directly: tag names, and Markdoc node types
+    // (`paragraph`, `heading`, `fence`, `list`, `blockquote`, `hr`). NULL
+    // allows anything. Raw HTML and comments are always allowed.
+    const char *const *children;
+    uint32_t child_count;
+} MarkdocTagSchema;
+
+typedef struct {
+    const MarkdocTagSchema *tags;
+    uint32_t tag_count;
+    // Accept tags the schema does not list, without checking them.
+    bool any_tags;
+} MarkdocSchema;
+
+typedef enum {
+    // An ERROR or MISSING node.
+    MARKDOC_DIAGNOSTIC_SYNTAX,
+    MARKDOC_DIAGNOSTIC_UNKNOWN_TAG,
+    // A tag_close whose name is not its tag_open's.
+    MARKDOC_DIAGNOSTIC_CLOSE_MISMATCH,
+    MARKDOC_DIAGNOSTIC_WRONG_FORM,
+    MARKDOC_DIAGNOSTIC_UNKNOWN_ATTRIBUTE,
+    MARKDOC_DIAGNOSTIC_DUPLICATE_ATTRIBUTE,
+    MARKDOC_DIAGNOSTIC_MISSING_ATTRIBUTE,
+    MARKDOC_DIAGNOSTIC_ATTRIBUTE_TYPE,
+    MARKDOC_DIAGNOSTIC_CHILD_NOT_ALLOWED,
+} MarkdocDiagnosticKind;
+
+// Set in MarkdocDiagnostic's `tag` or `attribute` when there is none.
+#define MARKDOC_SCHEMA_NONE UINT32_MAX
+
+typedef struct {
+    MarkdocDiagnosticKind kind;
+    uint32_t start_byte;
+    uint32_t end_byte;
+    TSPoint start_point;
+    // The schema's tag and, for attribute diagnostics, the index into its
+    // attributes, or MARKDOC_SCHEMA_NONE. A missing attribute has both.
+    uint32_t tag;
+    uint32_t attribute;
+} MarkdocDiagnostic;
+
+// In order of the walk, which is document order.
+typedef struct {
+    MarkdocDiagnostic *diagnostics;
+    uint32_t count;
+} MarkdocDiagnostics;
+
+// A schema prepared for checking many documents: tag names are hashed and
+// children lists resolved once. The schema's arrays and strings must
+// outlive the validator.
+typedef struct MarkdocValidator MarkdocValidator;
+
+// Returns NULL when out of memory.
+MarkdocValidator *markdoc_validator_new(const MarkdocSchema *schema);
+void markdoc_validator_delete(MarkdocValidator *validator);
+
+// Checks every tag under `node` in one walk that steps over text, fences,
+// headings and raw HTML: its name, its form, its closing name, its
+// attributes' names and value types, required attributes, and the blocks
+// directly in its body. Syntax errors are reported too. `source` is the
+// text the tree was parsed from. Returns false when out of memory or when
+// the tree's language is not the build symbols.h describes.
+bool markdoc_validate(const MarkdocValidator *validator, TSNode node, const char *source,
+                      MarkdocDiagnostics *diagnostics);
+
+void markdoc_diagnostics_delete(MarkdocDiagnostics *diagnostics);
+
+// A short English description of `kind`, e.g. "unknown tag".
+const char *markdoc_diagnostic_message(MarkdocDiagnosticKind kind);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_VALIDATE_H_
@@ -0,0 +1,41 @@
+#ifndef TREE_SITTER_MARKDOC_WRITER_H_
+#define TREE_SITTER_MARKDOC_WRITER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Where the emitters send their output. `write` receives consecutive pieces
+// of it, already batched into runs of a few KiB, and returns false to stop
+// the emitter.
+typedef struct {
+    bool (*write)(void *payload, const char *data, size_t length);
+    void *payload;
+} MarkdocWriter;
+
+// A growable in-memory output. `data` is NUL-terminated once anything has
+// been written.
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+} MarkdocBuffer;
+
+// A writer appending to `buffer`, which must start zeroed or be reused
+// after setting `length` to 0.
+MarkdocWriter markdoc_buffer_writer(MarkdocBuffer *buffer);
+
+void markdoc_buffer_delete(MarkdocBuffer *buffer);
+
+// A writer passing output to fwrite().
+MarkdocWriter markdoc_file_writer(FILE *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_MARKDOC_WRITER_H_
@@ -7,7 +7,7 @@ typedef struct TSLanguage TSLanguage;
 extern "C" {
 #endif
 
-const TSLanguage *tree_sitter_tree_sitter_markdoc(void);
+const TSLanguage *tree_sitter_markdoc(void);
 
 #ifdef __cplusplus
 }
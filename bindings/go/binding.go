@@ -11,5 +11,5 @@ import "unsafe"
 
 // Get the tree-sitter Language for this grammar.
 func Language() unsafe.Pointer {
-	return unsafe.Pointer(C.tree_sitter_tree_sitter_markdoc())
+	return unsafe.Pointer(C.tree_sitter_markdoc())
 }
@@ -0,0 +1,29 @@
+/**
+ * @file Block-level Markdoc grammar: paragraphs are opaque inline ranges
+ * @author Shelton Louis <louisshelton0@gmail.com>
+ * @license MIT
+ */
+
+/// <reference types="tree-sitter-cli/dsl" />
+// @ts-check
+
+// Same block structure as the full grammar, but the contents of paragraphs and
+// list paragraphs are left as `inline` nodes. Consumers that need inline
+// structure parse those ranges on demand with the `markdoc_inline` grammar.
+module.exports = grammar(require("../grammar"), {
+  name: "markdoc_block",
+
+  rules: {
+    paragraph: ($) => $.inline,
+
+    list_paragraph: ($) => alias($._list_inline, $.inline),
+
+    inline: ($) =>
+      prec.left(-1, seq($._inline_line, repeat(seq($._SOFT_LINE_BREAK, $._inline_line)))),
+
+    _list_inline: ($) =>
+      prec.right(1, seq($._inline_line, repeat(seq($._LIST_CONTINUATION, $._inline_line)))),
+
+    _inline_line: ($) => token(prec(1, /[^\r\n]+/)),
+  },
+});
@@ -0,0 +1,16 @@
+; Language injection queries for the Markdoc block grammar
+
+; Fenced code blocks use the language from their info string
+((fenced_code_block
+  (code_fence_open
+    (info_string
+      (language) @injection.language))
+  (code) @injection.content))
+
+; Paragraph and list item contents are parsed lazily with the inline grammar
+((inline) @injection.content
+  (#set! injection.language "markdoc_inline"))
+
+; Frontmatter bodies are YAML
+((yaml) @injection.content
+  (#set! injection.language "yaml"))
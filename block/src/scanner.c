@@ -0,0 +1,9 @@
+// The block grammar inherits its externals from the full grammar, so it shares
+// the full grammar's scanner under its own entry points.
+#define tree_sitter_markdoc_external_scanner_create tree_sitter_markdoc_block_external_scanner_create
+#define tree_sitter_markdoc_external_scanner_destroy tree_sitter_markdoc_block_external_scanner_destroy
+#define tree_sitter_markdoc_external_scanner_serialize tree_sitter_markdoc_block_external_scanner_serialize
+#define tree_sitter_markdoc_external_scanner_deserialize tree_sitter_markdoc_block_external_scanner_deserialize
+#define tree_sitter_markdoc_external_scanner_scan tree_sitter_markdoc_block_external_scanner_scan
+
+#include "../../src/scanner.c"
@@ -0,0 +1,19 @@
+/**
+ * @file Inline Markdoc grammar, parsed over the `inline` ranges of a block tree
+ * @author Shelton Louis <louisshelton0@gmail.com>
+ * @license MIT
+ */
+
+/// <reference types="tree-sitter-cli/dsl" />
+// @ts-check
+
+// Reuses the inline rules of the full grammar. The root accepts any run of
+// inline content and line breaks, so several `inline` ranges (each extended by
+// its trailing newline) can be parsed together as included ranges.
+module.exports = grammar(require("../grammar"), {
+  name: "markdoc_inline",
+
+  rules: {
+    source_file: ($) => repeat(choice($._inline_content, $._NEWLINE)),
+  },
+});
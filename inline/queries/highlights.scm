@@ -0,0 +1,174 @@
+; ============================================================================
+; Tree-sitter Syntax Highlighting Queries for the Markdoc inline grammar
+; ============================================================================
+; Applied to the `inline` ranges of a markdoc_block tree.
+; ============================================================================
+
+; ============================================================================
+; INLINE FORMATTING
+; ============================================================================
+
+; Emphasis (italic) - *text* or _text_
+(emphasis) @markup.italic
+
+; Strong (bold) - **text** or __text__
+(strong) @markup.bold
+
+; Inline code - `code`
+(inline_code) @markup.raw.inline
+
+; ============================================================================
+; LINKS AND IMAGES
+; ============================================================================
+
+; Link structure: [text](url)
+(link
+  "[" @punctuation.bracket
+  "]" @punctuation.bracket
+  "(" @punctuation.bracket
+  ")" @punctuation.bracket)
+
+(link_text) @markup.link.label
+(link_destination) @markup.link.url
+
+; Image structure: ![alt](url)
+(image
+  "![" @punctuation.bracket
+  "]" @punctuation.bracket
+  "(" @punctuation.bracket
+  ")" @punctuation.bracket)
+
+(image_alt) @markup.link.label
+(image_destination) @markup.link.url
+
+; ============================================================================
+; HTML
+; ============================================================================
+
+; HTML inline (inline tags)
+(html_inline) @markup.raw.inline
+
+; ============================================================================
+; MARKDOC TAGS
+; ============================================================================
+
+; Tag delimiters: {% and %} and /%}
+(tag_open_delimiter) @punctuation.bracket
+(inline_expression_close) @punctuation.bracket
+(tag_self_close_delimiter) @punctuation.bracket
+
+; Tag names (e.g., callout, table, partial)
+(tag_name) @tag
+
+; ============================================================================
+; TAG ATTRIBUTES
+; ============================================================================
+
+; Attribute name (e.g., type, id, class)
+(attribute_name) @attribute
+
+; Assignment operator
+(attribute ("=" @operator))
+
+; ============================================================================
+; INLINE EXPRESSIONS {% ... %}
+; ============================================================================
+
+; Expression blocks
+(inline_expression) @markup.raw.inline
+
+; ============================================================================
+; EXPRESSIONS AND OPERATORS
+; ============================================================================
+
+; Variables with $ prefix
+(variable "$" @punctuation.special)
+(variable (identifier) @variable)
+
+; Variables with @ prefix
+(special_variable "@" @punctuation.special)
+(special_variable (identifier) @variable)
+
+; Variable references: $var and $var.path
+(variable_reference
+  (variable (identifier) @variable)
+  (identifier) @variable.member)
+
+; Special variable references: @var and @var.path
+(special_variable_reference
+  (special_variable (identifier) @variable)
+  (identifier) @variable.member)
+
+; Subscript references: $items[0]
+(subscript_reference
+  (variable_reference (variable (identifier) @variable))
+  (array_subscript (number) @number))
+
+(subscript_reference
+  (variable_reference (variable (identifier) @variable))
+  (array_subscript (string) @string))
+
+(subscript_reference
+  (special_variable_reference (special_variable (identifier) @variable))
+  (array_subscript (number) @number))
+
+(subscript_reference
+  (special_variable_reference (special_variable (identifier) @variable))
+  (array_subscript (string) @string))
+
+; Identifiers (function names, object keys, etc.)
+(identifier) @variable
+
+; Function calls: func(...)
+(call_expression
+  function: (identifier) @function)
+
+; Subscript references
+(array_subscript
+  "[" @punctuation.bracket
+  "]" @punctuation.bracket)
+
+; ============================================================================
+; LITERALS
+; ============================================================================
+
+; Strings: "string" or 'string'
+(string) @string
+
+; Numbers: 42, 3.14, -10
+(number) @number
+
+; Booleans: true, false
+(boolean) @boolean
+
+; Null
+(null) @constant.builtin
+
+; ============================================================================
+; DATA STRUCTURES
+; ============================================================================
+
+; Array literals: [1, 2, 3]
+(array_literal
+  "[" @punctuation.bracket
+  "]" @punctuation.bracket)
+
+; Object literals: { key: value }
+(object_literal
+  "{" @punctuation.bracket
+  "}" @punctuation.bracket)
+
+; ============================================================================
+; TEXT CONTENT
+; ============================================================================
+
+; Plain text in paragraphs and lists
+(text) @none
+; ============================================================================
+; PARENTHESES AND BRACKETS (GENERIC)
+; ============================================================================
+
+; Function call parentheses
+(call_expression
+  "(" @punctuation.bracket
+  ")" @punctuation.bracket)
@@ -6,3 +6,7 @@
     (info_string
       (language) @injection.language))
   (code) @injection.content))
+
+; Frontmatter bodies are YAML
+((yaml) @injection.content
+  (#set! injection.language "yaml"))
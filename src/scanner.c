@@ -1,3 +1,5 @@
+#include "scanner.h"
+#include "tree_sitter/alloc.h"
 #include "tree_sitter/parser.h"
 #include <stdlib.h>
 #include <stdbool.h>
@@ -19,8 +21,6 @@ enum TokenType {
   HTML_BLOCK
 };
 
-#define MAX_FENCE_DEPTH 8
-
 typedef struct {
   bool at_start;
   bool in_frontmatter;
@@ -30,7 +30,7 @@ typedef struct {
 } Scanner;
 
 void *tree_sitter_markdoc_external_scanner_create() {
-  Scanner *scanner = (Scanner *)malloc(sizeof(Scanner));
+  Scanner *scanner = (Scanner *)ts_malloc(sizeof(Scanner));
   scanner->at_start = true;
   scanner->in_frontmatter = false;
   scanner->fence_depth = 0;
@@ -40,7 +40,7 @@ void *tree_sitter_markdoc_external_scanner_create() {
 }
 
 void tree_sitter_markdoc_external_scanner_destroy(void *payload) {
-  free(payload);
+  ts_free(payload);
 }
 
 unsigned tree_sitter_markdoc_external_scanner_serialize(void *payload, char *buffer) {
@@ -369,7 +369,7 @@ static bool scan_fence_marker(TSLexer *lexer, char *fence_char, uint8_t *fence_l
 
   char marker = (char)lexer->lookahead;
   uint8_t count = 0;
-  while (lexer->lookahead == marker && count < 255) {
+  while (lexer->lookahead == marker && count < MAX_FENCE_LENGTH) {
     lexer->advance(lexer, false);
     count++;
   }
@@ -528,46 +528,23 @@ static bool is_list_marker_line(TSLexer *lexer) {
   return false;
 }
 
+static int32_t lexer_lookahead(void *payload) {
+  return ((TSLexer *)payload)->lookahead;
+}
+
+static void lexer_advance(void *payload) {
+  TSLexer *lexer = (TSLexer *)payload;
+  lexer->advance(lexer, false);
+}
+
 static bool is_markdoc_block_tag_line(TSLexer *lexer) {
   if (lexer->get_column(lexer) != 0) {
     return false;
   }
 
   TSLexer saved_state = *lexer;
-  if (lexer->lookahead != '{') {
-    return false;
-  }
-
-  lexer->advance(lexer, false);
-  if (lexer->lookahead != '%') {
-    *lexer = saved_state;
-    return false;
-  }
-  lexer->advance(lexer, false);
-
-  while (lexer->lookahead == ' ' || lexer->lookahead == '\t') {
-    lexer->advance(lexer, false);
-  }
-
-  bool found_close = false;
-  while (lexer->lookahead != 0 && !is_newline(lexer->lookahead)) {
-    if (lexer->lookahead == '%') {
-      TSLexer percent_state = *lexer;
-      lexer->advance(lexer, false);
-      if (lexer->lookahead == '}') {
-        lexer->advance(lexer, false);
-        while (lexer->lookahead == ' ' || lexer->lookahead == '\t') {
-          lexer->advance(lexer, false);
-        }
-        found_close = true;
-        break;
-      }
-      *lexer = percent_state;
-    }
-    lexer->advance(lexer, false);
-  }
-
-  bool ok = found_close && (lexer->lookahead == 0 || is_newline(lexer->lookahead));
+  MarkdocCharReader reader = {lexer_lookahead, lexer_advance, lexer};
+  bool ok = markdoc_scan_tag_line(&reader) != MARKDOC_TAG_LINE_NONE;
   *lexer = saved_state;
   return ok;
 }
@@ -889,7 +866,7 @@ bool tree_sitter_markdoc_external_scanner_scan(void *payload, TSLexer *lexer,
       TSLexer fence_state = *lexer;
       char marker = (char)lexer->lookahead;
       uint8_t count = 0;
-      while (lexer->lookahead == marker && count < 255) {
+      while (lexer->lookahead == marker && count < MAX_FENCE_LENGTH) {
         lexer->advance(lexer, false);
         count++;
       }
@@ -0,0 +1,149 @@
+#ifndef TREE_SITTER_MARKDOC_SCANNER_H_
+#define TREE_SITTER_MARKDOC_SCANNER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// How many code fences the external scanner tracks nested in one another.
+// The C bindings include this header too, so code that follows the
+// scanner's fence state without running it agrees with it.
+#define MAX_FENCE_DEPTH 8
+
+// The longest run of fence markers the scanner counts. Longer runs are cut
+// here, so their remaining markers are not part of the fence.
+#define MAX_FENCE_LENGTH 255
+
+// What a line starting with `{%` at column 0 is. The scanner only asks
+// whether it is a tag line at all, which ends a paragraph. The C bindings
+// also use the kind to follow tag nesting without running the parser.
+typedef enum {
+  MARKDOC_TAG_LINE_NONE,
+  // A complete `{% ... %}` line that neither opens nor closes a tag, such
+  // as `{% $var %}` or `{% @index %}`.
+  MARKDOC_TAG_LINE_OTHER,
+  MARKDOC_TAG_LINE_OPEN,
+  MARKDOC_TAG_LINE_CLOSE,
+  MARKDOC_TAG_LINE_SELF_CLOSE,
+  // `{% comment %}`, which the grammar lexes as one comment_block token.
+  MARKDOC_TAG_LINE_COMMENT_OPEN,
+} MarkdocTagLine;
+
+// Reads characters for markdoc_scan_tag_line(): the scanner passes its
+// TSLexer, the C bindings a position in a buffer. `lookahead` returns 0 at
+// the end of the input.
+typedef struct {
+  int32_t (*lookahead)(void *payload);
+  void (*advance)(void *payload);
+  void *payload;
+} MarkdocCharReader;
+
+static inline bool markdoc_tag_line_is_space(int32_t c) {
+  return c == ' ' || c == '\t';
+}
+
+static inline bool markdoc_tag_line_is_end(int32_t c) {
+  return c == 0 || c == '\n' || c == '\r';
+}
+
+static inline bool markdoc_tag_line_is_name_char(int32_t c, bool first) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+         (!first && c >= '0' && c <= '9');
+}
+
+// Classifies the line at `reader`, which must start at column 0, and leaves
+// the reader somewhere on that line. A tag line starts with `{%` and ends
+// with the first `%}` on it, followed only by spaces and tabs.
+static inline MarkdocTagLine markdoc_scan_tag_line(const MarkdocCharReader *reader) {
+  void *r = reader->payload;
+  if (reader->lookahead(r) != '{') {
+    return MARKDOC_TAG_LINE_NONE;
+  }
+  reader->advance(r);
+  if (reader->lookahead(r) != '%') {
+    return MARKDOC_TAG_LINE_NONE;
+  }
+  reader->advance(r);
+  while (markdoc_tag_line_is_space(reader->lookahead(r))) {
+    reader->advance(r);
+  }
+
+  bool is_close = false;
+  if (reader->lookahead(r) == '/') {
+    is_close = true;
+    reader->advance(r);
+    while (markdoc_tag_line_is_space(reader->lookahead(r))) {
+      reader->advance(r);
+    }
+  }
+
+  // The tag name, of which only enough is kept to recognize `comment`.
+  static const char comment[] = "comment";
+  unsigned name_length = 0;
+  bool is_comment = true;
+  while (markdoc_tag_line_is_name_char(reader->lookahead(r), name_length == 0)) {
+    int32_t c = reader->lookahead(r);
+    is_comment = is_comment && name_length < sizeof(comment) - 1 && c == comment[name_length];
+    name_length++;
+    reader->advance(r);
+  }
+  int32_t after_name = reader->lookahead(r);
+  bool named = name_length > 0 && (markdoc_tag_line_is_space(after_name) ||
+                                   after_name == '%' || after_name == '/');
+  is_comment = is_comment && name_length == sizeof(comment) - 1;
+
+  // Whatever sits between the name and `%}`: only spaces for `{% comment
+  // %}`, a trailing `/` for a self-closing tag. A `%}` inside a string
+  // attribute does not end the tag.
+  bool only_spaces = true;
+  int32_t previous = 0;
+  bool found_close = false;
+  while (!markdoc_tag_line_is_end(reader->lookahead(r))) {
+    int32_t c = reader->lookahead(r);
+    reader->advance(r);
+    if (c == '%' && reader->lookahead(r) == '}') {
+      reader->advance(r);
+      found_close = true;
+      break;
+    }
+    if (c == '"') {
+      while (!markdoc_tag_line_is_end(reader->lookahead(r)) && reader->lookahead(r) != '"') {
+        if (reader->lookahead(r) == '\\') {
+          reader->advance(r);
+          if (markdoc_tag_line_is_end(reader->lookahead(r))) {
+            break;
+          }
+        }
+        reader->advance(r);
+      }
+      if (reader->lookahead(r) != '"') {
+        return MARKDOC_TAG_LINE_NONE;
+      }
+      reader->advance(r);
+    }
+    only_spaces = only_spaces && markdoc_tag_line_is_space(c);
+    previous = c;
+  }
+  if (!found_close) {
+    return MARKDOC_TAG_LINE_NONE;
+  }
+  while (markdoc_tag_line_is_space(reader->lookahead(r))) {
+    reader->advance(r);
+  }
+  if (!markdoc_tag_line_is_end(reader->lookahead(r))) {
+    return MARKDOC_TAG_LINE_NONE;
+  }
+
+  bool self_close = previous == '/';
+  if (!named || (is_close && self_close)) {
+    return MARKDOC_TAG_LINE_OTHER;
+  }
+  if (is_close) {
+    return MARKDOC_TAG_LINE_CLOSE;
+  }
+  if (self_close) {
+    return MARKDOC_TAG_LINE_SELF_CLOSE;
+  }
+  return is_comment && only_spaces ? MARKDOC_TAG_LINE_COMMENT_OPEN : MARKDOC_TAG_LINE_OPEN;
+}
+
+#endif // TREE_SITTER_MARKDOC_SCANNER_H_